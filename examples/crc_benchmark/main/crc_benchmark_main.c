@@ -0,0 +1,129 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_crc.h"
+#include "beam_frame.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define ITERATIONS 2000u /**< CRC calls per measurement */
+#define RUNS 5u          /**< Measurements per cell; the fastest one is reported */
+
+#if CONFIG_BEAM_CRC_IN_IRAM
+#define TABLE_PLACEMENT "DRAM"
+#else
+#define TABLE_PLACEMENT "flash"
+#endif
+
+static const char *TAG = "crc_benchmark";
+
+typedef uint16_t (*crc_fn_t)(uint16_t crc, const uint8_t *data, size_t len);
+
+typedef struct crc_backend {
+    const char *name;
+    crc_fn_t fn;
+} crc_backend_t;
+
+static const crc_backend_t backends[] = {
+    {"rom", beam_crc16_rom},
+    {"table", beam_crc16_table},
+    {"slice4", beam_crc16_slice4},
+};
+
+#define BACKEND_COUNT (sizeof(backends) / sizeof(backends[0]))
+
+/* Checksummed bytes per frame: header + payload (0, battery, telemetry, 64, MAX_PAYLOAD_SIZE) */
+static const size_t frame_lengths[] = {
+    FRAME_HEADER_SIZE + 0,
+    FRAME_HEADER_SIZE + 5,
+    FRAME_HEADER_SIZE + 12,
+    FRAME_HEADER_SIZE + 64,
+    FRAME_HEADER_SIZE + MAX_PAYLOAD_SIZE,
+};
+
+#define FRAME_LENGTH_COUNT (sizeof(frame_lengths) / sizeof(frame_lengths[0]))
+
+static uint8_t frame[FRAME_HEADER_SIZE + MAX_PAYLOAD_SIZE];
+
+/**
+ * @brief Fastest average cycles per call of fn over len bytes.
+ */
+static uint32_t measure(crc_fn_t fn, size_t len)
+{
+    uint32_t best = UINT32_MAX;
+    volatile uint16_t sink = 0;
+
+    for (uint32_t run = 0; run < RUNS; run++) {
+        uint32_t start = esp_cpu_get_cycle_count();
+        for (uint32_t i = 0; i < ITERATIONS; i++) {
+            sink = fn(BEAM_CRC_INIT, frame, len);
+        }
+        uint32_t cycles = (esp_cpu_get_cycle_count() - start) / ITERATIONS;
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    (void)sink;
+
+    return best;
+}
+
+void app_main(void)
+{
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        frame[i] = (uint8_t)(i * 31u + 7u);
+    }
+
+    for (size_t l = 0; l < FRAME_LENGTH_COUNT; l++) {
+        uint16_t reference = beam_crc16_rom(BEAM_CRC_INIT, frame, frame_lengths[l]);
+        for (size_t b = 1; b < BACKEND_COUNT; b++) {
+            if (backends[b].fn(BEAM_CRC_INIT, frame, frame_lengths[l]) != reference) {
+                ESP_LOGE(TAG, "%s disagrees with rom for %u bytes", backends[b].name, (unsigned)frame_lengths[l]);
+                return;
+            }
+        }
+    }
+
+    uint32_t cycles[FRAME_LENGTH_COUNT][BACKEND_COUNT];
+
+    // Keep the scheduler from preempting the measurement loops
+    vTaskSuspendAll();
+    for (size_t l = 0; l < FRAME_LENGTH_COUNT; l++) {
+        for (size_t b = 0; b < BACKEND_COUNT; b++) {
+            cycles[l][b] = measure(backends[b].fn, frame_lengths[l]);
+        }
+    }
+    xTaskResumeAll();
+
+    ESP_LOGI(TAG, "target %s, tables in %s, cycles per frame:", CONFIG_IDF_TARGET, TABLE_PLACEMENT);
+    printf("%-8s", "bytes");
+    for (size_t b = 0; b < BACKEND_COUNT; b++) {
+        printf("%10s", backends[b].name);
+    }
+    printf("\n");
+    for (size_t l = 0; l < FRAME_LENGTH_COUNT; l++) {
+        printf("%-8u", (unsigned)frame_lengths[l]);
+        for (size_t b = 0; b < BACKEND_COUNT; b++) {
+            printf("%10lu", (unsigned long)cycles[l][b]);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,237 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_crc.h"
+#include "beam_dispatcher.h"
+#include "beam_frame.h"
+#include "beam_frame_builder.h"
+#include "beam_parser.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define WARM_ITERATIONS 1000u    /**< Back-to-back calls per warm measurement */
+#define WARM_RUNS 5u             /**< Warm measurements per cell; the fastest one is reported */
+#define COLD_RUNS 31u            /**< Single cold calls per cell; the median is reported */
+#define EVICT_DATA_SIZE 0x10000u /**< Flash-resident bytes streamed to evict the data cache */
+#define BENCH_CATEGORY 0x42u     /**< Category of the benchmark frames */
+
+static const char *TAG = "perf_benchmark";
+
+/*
+ * Cold-cache runs evict the flash cache before every call: EVICT_DATA_SIZE bytes of
+ * rodata are read and a large straight-line function in flash is executed, each larger
+ * than the cache of any supported target. Whatever the measured stage then fetches from
+ * flash (code, CRC tables, the payload size table) misses, as it would in an
+ * esp_now_recv_cb that runs after other work.
+ */
+static const uint8_t s_evict_data[EVICT_DATA_SIZE] = {1};
+static volatile uint32_t s_evict_sink;
+
+#define EVICT_OP s_evict_sink = s_evict_sink * 33u + 1u;
+#define EVICT_X2(x) x x
+#define EVICT_X16(x) EVICT_X2(EVICT_X2(EVICT_X2(EVICT_X2(x))))
+#define EVICT_X4096(x) EVICT_X16(EVICT_X16(EVICT_X16(x)))
+
+static void __attribute__((noinline)) evict_code(void)
+{
+    EVICT_X4096(EVICT_OP)
+}
+
+static void evict_caches(void)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < EVICT_DATA_SIZE; i += 16) {
+        sum += ((const volatile uint8_t *)s_evict_data)[i];
+    }
+    s_evict_sink += sum;
+    evict_code();
+}
+
+/* Payload lengths: empty, battery, telemetry, 64 bytes, MAX_PAYLOAD_SIZE */
+static const uint8_t payload_lengths[] = {0, 5, 12, 64, MAX_PAYLOAD_SIZE};
+
+#define PAYLOAD_LENGTH_COUNT (sizeof(payload_lengths) / sizeof(payload_lengths[0]))
+
+static uint8_t s_frame[FRAME_MAX_SIZE];
+static size_t s_frame_len;
+static uint8_t s_out[FRAME_MAX_SIZE];
+static beam_frame_t s_parsed;
+static beam_frame_view_t s_view;
+static beam_frame_header_t s_header;
+static beam_dispatcher_t s_dispatcher;
+static volatile uint32_t s_sink;
+
+static void on_frame(const beam_frame_view_t *view, void *ctx)
+{
+    s_sink += beam_frame_view_seq(view);
+}
+
+static void stage_crc(void)
+{
+    s_sink += beam_crc16(BEAM_CRC_INIT, s_frame, s_frame_len - FRAME_CRC_SIZE);
+}
+
+static void stage_parse(void)
+{
+    s_sink += (uint32_t)beam_parse_into_frame(s_frame, s_frame_len, &s_parsed);
+}
+
+static void stage_view(void)
+{
+    s_sink += (uint32_t)beam_parse_view(s_frame, s_frame_len, &s_view);
+}
+
+static void stage_validate(void)
+{
+    s_sink += (uint32_t)beam_validate_frame(s_frame, s_frame_len, &s_header);
+}
+
+static void stage_serialize(void)
+{
+    s_sink += (uint32_t)beam_serialize_frame(&s_parsed, s_out, sizeof(s_out), NULL);
+}
+
+static void stage_dispatch(void)
+{
+    s_sink += (uint32_t)beam_dispatch(&s_dispatcher, &s_view);
+}
+
+typedef struct stage {
+    const char *name;  ///< Row label
+    void (*run)(void); ///< One call of the measured function
+    const void *code;  ///< Function whose placement is reported
+} stage_t;
+
+static const stage_t stages[] = {
+    {"crc", stage_crc, (const void *)beam_crc16},
+    {"parse", stage_parse, (const void *)beam_parse_into_frame},
+    {"view", stage_view, (const void *)beam_parse_view},
+    {"validate", stage_validate, (const void *)beam_validate_frame},
+    {"serialize", stage_serialize, (const void *)beam_serialize_frame},
+    {"dispatch", stage_dispatch, (const void *)beam_dispatch},
+};
+
+#define STAGE_COUNT (sizeof(stages) / sizeof(stages[0]))
+
+/**
+ * @brief Fastest average cycles per call over WARM_RUNS loops of WARM_ITERATIONS calls.
+ */
+static uint32_t measure_warm(const stage_t *stage)
+{
+    uint32_t best = UINT32_MAX;
+
+    stage->run();
+    for (uint32_t run = 0; run < WARM_RUNS; run++) {
+        uint32_t start = esp_cpu_get_cycle_count();
+        for (uint32_t i = 0; i < WARM_ITERATIONS; i++) {
+            stage->run();
+        }
+        uint32_t cycles = (esp_cpu_get_cycle_count() - start) / WARM_ITERATIONS;
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Median cycles of COLD_RUNS single calls, each after evicting the caches.
+ */
+static uint32_t measure_cold(const stage_t *stage)
+{
+    uint32_t samples[COLD_RUNS];
+
+    for (uint32_t run = 0; run < COLD_RUNS; run++) {
+        evict_caches();
+        uint32_t start = esp_cpu_get_cycle_count();
+        stage->run();
+        samples[run] = esp_cpu_get_cycle_count() - start;
+    }
+
+    // Insertion sort: COLD_RUNS is small
+    for (uint32_t i = 1; i < COLD_RUNS; i++) {
+        uint32_t value = samples[i];
+        uint32_t j = i;
+        while (j > 0 && samples[j - 1] > value) {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = value;
+    }
+
+    return samples[COLD_RUNS / 2];
+}
+
+static void prepare_frame(uint8_t payload_len)
+{
+    beam_frame_builder_t builder;
+
+    beam_frame_begin(&builder, s_frame, sizeof(s_frame), BENCH_CATEGORY, 0, payload_len);
+    for (uint8_t i = 0; i < payload_len; i++) {
+        beam_frame_put_u8(&builder, (uint8_t)(i * 31u + 7u));
+    }
+    beam_frame_finish(&builder, &s_frame_len);
+
+    beam_parse_into_frame(s_frame, s_frame_len, &s_parsed);
+    beam_parse_view(s_frame, s_frame_len, &s_view);
+}
+
+void app_main(void)
+{
+    beam_dispatcher_init(&s_dispatcher);
+    beam_subscribe(&s_dispatcher, BENCH_CATEGORY, on_frame, NULL);
+
+    uint32_t warm[PAYLOAD_LENGTH_COUNT][STAGE_COUNT];
+    uint32_t cold[PAYLOAD_LENGTH_COUNT][STAGE_COUNT];
+
+    // Keep the scheduler from preempting the measurement loops
+    vTaskSuspendAll();
+    for (size_t l = 0; l < PAYLOAD_LENGTH_COUNT; l++) {
+        prepare_frame(payload_lengths[l]);
+        for (size_t s = 0; s < STAGE_COUNT; s++) {
+            warm[l][s] = measure_warm(&stages[s]);
+            cold[l][s] = measure_cold(&stages[s]);
+        }
+    }
+    xTaskResumeAll();
+
+    uint32_t mhz = esp_rom_get_cpu_ticks_per_us();
+    ESP_LOGI(TAG, "target %s at %lu MHz", CONFIG_IDF_TARGET, (unsigned long)mhz);
+
+    for (size_t l = 0; l < PAYLOAD_LENGTH_COUNT; l++) {
+        printf("\npayload %u bytes\n", payload_lengths[l]);
+        printf("%-10s %-6s %10s %10s %10s %10s\n", "stage", "code", "warm cyc", "cold cyc", "warm ns", "cold ns");
+        for (size_t s = 0; s < STAGE_COUNT; s++) {
+            printf("%-10s %-6s %10lu %10lu %10lu %10lu\n",
+                   stages[s].name,
+                   esp_ptr_in_iram(stages[s].code) ? "IRAM" : "flash",
+                   (unsigned long)warm[l][s],
+                   (unsigned long)cold[l][s],
+                   (unsigned long)(warm[l][s] * 1000u / mhz),
+                   (unsigned long)(cold[l][s] * 1000u / mhz));
+        }
+    }
+
+    printf("\ncold - warm is the flash-cache miss cost of each stage\n");
+}
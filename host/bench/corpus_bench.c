@@ -0,0 +1,468 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * Throughput regression benchmark: replays a fixed corpus of received frames through each
+ * receive path and reports frames/s. The default corpus is generated from a seed and mixes
+ * valid frames of every size with compressed, corrupted, truncated and random inputs, so
+ * two runs with the same seed measure exactly the same work; the accepted count per path
+ * is printed alongside and must not change between runs.
+ *
+ * Usage: beam_corpus_bench [--csv] [--ms N] [--seed N] [--frames N] [--corpus DIR] [--write DIR]
+ *   --csv         print one CSV row per path (op,frames,accepted,ns_per_frame,frames_per_sec)
+ *   --ms N        target run time per path in milliseconds (default 500)
+ *   --seed N      seed of the generated corpus (default 1)
+ *   --frames N    frames in the generated corpus (default 4096)
+ *   --corpus DIR  replay the files in DIR (e.g. a fuzzer corpus) instead, in name order
+ *   --write DIR   write the generated corpus to DIR (created if missing), one file per frame, and exit
+ */
+
+#include "beam_frame.h"
+#include "beam_parser.h"
+#include "beam_ring.h"
+#include "sdkconfig.h"
+#include <dirent.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define BATCH_SIZE 16 /**< Frames per beam_parse_batch() call */
+#define RING_SLOTS 4  /**< Ring depth for the push/peek/release path */
+
+#if CONFIG_BEAM_CRC_BACKEND_TABLE
+#define CRC_BACKEND_NAME "table"
+#elif CONFIG_BEAM_CRC_BACKEND_SLICE4
+#define CRC_BACKEND_NAME "slice4"
+#else
+#define CRC_BACKEND_NAME "rom (bitwise on host)"
+#endif
+
+/* One corpus entry; data holds FRAME_MAX_SIZE bytes, len of them received */
+typedef struct corpus_frame {
+    uint8_t data[FRAME_MAX_SIZE];
+    size_t len;
+} corpus_frame_t;
+
+static corpus_frame_t *s_corpus;
+static size_t s_count;
+static beam_rx_slice_t *s_slices;
+static beam_frame_buf_t s_ring_slots[RING_SLOTS];
+static beam_ring_t s_ring;
+
+/* Results feed this sink so the compiler cannot drop the measured calls */
+static volatile uint32_t s_sink;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief xorshift32: the corpus must not depend on the C library's rand().
+ */
+static uint32_t next_random(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+/**
+ * @brief Fill one corpus entry. Roughly: 50% valid (a fifth of them timestamped),
+ *        10% compressed, 10% bad CRC, 10% truncated, 5% oversized len, 15% random bytes.
+ */
+static void generate_frame(uint32_t *rng, corpus_frame_t *entry)
+{
+    static const uint8_t categories[] = {MSG_CAT_TELEMETRY, MSG_CAT_BATTERY, 0x42, MSG_CAT_AGGREGATE};
+    uint32_t kind = next_random(rng) % 20;
+
+    if (kind >= 17) {
+        entry->len = next_random(rng) % (FRAME_MAX_SIZE + 1);
+        for (size_t i = 0; i < entry->len; i++) {
+            entry->data[i] = (uint8_t)next_random(rng);
+        }
+        return;
+    }
+
+    beam_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    uint32_t timestamp_us = 0;
+    frame.header.msg_category = categories[next_random(rng) % sizeof(categories)];
+    frame.header.seq = (uint8_t)next_random(rng);
+    frame.header.len = (uint8_t)(next_random(rng) % (MAX_PAYLOAD_SIZE + 1));
+
+    if (kind < 2) {
+        frame.header.flags = MSG_FLAG_EXT_TS;
+        frame.header.len = (uint8_t)(frame.header.len % (MAX_PAYLOAD_SIZE - FRAME_EXT_TS_SIZE + 1));
+        timestamp_us = next_random(rng);
+    }
+    else if (kind >= 10 && kind < 12) {
+        // Short repeating runs, so the payload actually compresses
+        frame.header.flags = MSG_FLAG_COMPRESSED;
+        uint8_t period = (uint8_t)(1 + next_random(rng) % 8);
+        for (size_t i = 0; i < frame.header.len; i++) {
+            frame.payload.raw[i] = (uint8_t)(i % period);
+        }
+    }
+    else {
+        for (size_t i = 0; i < frame.header.len; i++) {
+            frame.payload.raw[i] = (uint8_t)next_random(rng);
+        }
+    }
+    if (frame.header.flags & MSG_FLAG_EXT_TS) {
+        beam_serialize_frame_ts(&frame, timestamp_us, entry->data, sizeof(entry->data), &entry->len);
+    }
+    else {
+        beam_serialize_frame(&frame, entry->data, sizeof(entry->data), &entry->len);
+    }
+
+    if (kind >= 12 && kind < 14) {
+        entry->data[next_random(rng) % entry->len] ^= (uint8_t)(1u << (next_random(rng) % 8));
+    }
+    else if (kind >= 14 && kind < 16) {
+        entry->len = next_random(rng) % entry->len;
+    }
+    else if (kind == 16) {
+        entry->data[FRAME_OFFSET_LEN] = (uint8_t)(MAX_PAYLOAD_SIZE + 1 + next_random(rng) % (255 - MAX_PAYLOAD_SIZE));
+    }
+}
+
+static bool generate_corpus(uint32_t seed, size_t count)
+{
+    s_corpus = calloc(count, sizeof(*s_corpus));
+    if (s_corpus == NULL) {
+        return false;
+    }
+
+    uint32_t rng = seed != 0 ? seed : 1; // xorshift never leaves 0
+    for (size_t i = 0; i < count; i++) {
+        generate_frame(&rng, &s_corpus[i]);
+    }
+    s_count = count;
+
+    return true;
+}
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/**
+ * @brief Load every file of dir up to FRAME_MAX_SIZE bytes; larger files cannot be frames
+ *        and are skipped.
+ */
+static bool load_corpus(const char *dir)
+{
+    DIR *d = opendir(dir);
+    if (d == NULL) {
+        perror(dir);
+        return false;
+    }
+
+    char **names = NULL;
+    size_t name_count = 0;
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+        if (ent->d_name[0] == '.') {
+            continue;
+        }
+        char **grown = realloc(names, (name_count + 1) * sizeof(*names));
+        if (grown == NULL) {
+            break;
+        }
+        names = grown;
+        names[name_count++] = strdup(ent->d_name);
+    }
+    closedir(d);
+    qsort(names, name_count, sizeof(*names), compare_names);
+
+    s_corpus = calloc(name_count > 0 ? name_count : 1, sizeof(*s_corpus));
+    size_t skipped = 0;
+    for (size_t i = 0; i < name_count; i++) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        free(names[i]);
+
+        FILE *file = fopen(path, "rb");
+        if (file == NULL || s_corpus == NULL) {
+            skipped++;
+            if (file != NULL) {
+                fclose(file);
+            }
+            continue;
+        }
+        corpus_frame_t *entry = &s_corpus[s_count];
+        entry->len = fread(entry->data, 1, sizeof(entry->data), file);
+        if (fgetc(file) != EOF) {
+            skipped++;
+        }
+        else {
+            s_count++;
+        }
+        fclose(file);
+    }
+    free(names);
+
+    if (skipped > 0) {
+        fprintf(stderr,
+                "%s: skipped %zu files (unreadable or longer than %u bytes)\n",
+                dir,
+                skipped,
+                (unsigned)FRAME_MAX_SIZE);
+    }
+
+    return s_corpus != NULL && s_count > 0;
+}
+
+/* Writes the corpus into dir, creating dir if it does not exist yet */
+static bool write_corpus(const char *dir)
+{
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+        perror(dir);
+        return false;
+    }
+
+    for (size_t i = 0; i < s_count; i++) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/frame-%05zu.bin", dir, i);
+
+        FILE *file = fopen(path, "wb");
+        if (file == NULL) {
+            perror(path);
+            return false;
+        }
+        fwrite(s_corpus[i].data, 1, s_corpus[i].len, file);
+        fclose(file);
+    }
+
+    return true;
+}
+
+/* One replay path: processes the whole corpus per call and returns the frames it accepted */
+typedef struct bench_op {
+    const char *name;
+    size_t (*run)(void);
+} bench_op_t;
+
+static size_t run_parse(void)
+{
+    beam_frame_t frame;
+    size_t accepted = 0;
+
+    for (size_t i = 0; i < s_count; i++) {
+        if (beam_parse_into_frame(s_corpus[i].data, s_corpus[i].len, &frame) == ESP_OK) {
+            accepted++;
+            s_sink += frame.crc;
+        }
+    }
+
+    return accepted;
+}
+
+static size_t run_view(void)
+{
+    beam_frame_view_t view;
+    size_t accepted = 0;
+
+    for (size_t i = 0; i < s_count; i++) {
+        if (beam_parse_view(s_corpus[i].data, s_corpus[i].len, &view) == ESP_OK) {
+            accepted++;
+            s_sink += (uint32_t)view.size;
+        }
+    }
+
+    return accepted;
+}
+
+static size_t run_validate(void)
+{
+    beam_frame_header_t header;
+    size_t accepted = 0;
+
+    for (size_t i = 0; i < s_count; i++) {
+        if (beam_validate_frame(s_corpus[i].data, s_corpus[i].len, &header) == ESP_OK) {
+            accepted++;
+            s_sink += header.len;
+        }
+    }
+
+    return accepted;
+}
+
+static size_t run_batch(void)
+{
+    beam_frame_view_t out[BATCH_SIZE];
+    esp_err_t status[BATCH_SIZE];
+    size_t accepted = 0;
+
+    for (size_t i = 0; i < s_count; i += BATCH_SIZE) {
+        size_t n = s_count - i < BATCH_SIZE ? s_count - i : BATCH_SIZE;
+        beam_parse_batch(&s_slices[i], n, out, status);
+        for (size_t j = 0; j < n; j++) {
+            accepted += status[j] == ESP_OK;
+        }
+    }
+
+    return accepted;
+}
+
+static size_t run_ring(void)
+{
+    beam_frame_view_t view;
+    size_t accepted = 0;
+
+    for (size_t i = 0; i < s_count; i++) {
+        if (beam_ring_push_frame(&s_ring, s_corpus[i].data, s_corpus[i].len) == ESP_OK) {
+            beam_ring_peek(&s_ring, &view);
+            s_sink += (uint32_t)view.size;
+            beam_ring_release(&s_ring);
+            accepted++;
+        }
+    }
+
+    return accepted;
+}
+
+static const bench_op_t s_ops[] = {
+    {"parse", run_parse},
+    {"view", run_view},
+    {"validate", run_validate},
+    {"batch", run_batch},
+    {"ring", run_ring},
+};
+
+/**
+ * @brief Replay the corpus through op for about target_ns.
+ *
+ * @return Nanoseconds per frame; *out_accepted receives the frames accepted in one pass.
+ */
+static double measure(const bench_op_t *op, uint64_t target_ns, size_t *out_accepted)
+{
+    // One untimed pass warms caches and branch predictors and gives the accepted count
+    *out_accepted = op->run();
+
+    uint64_t passes = 0;
+    uint64_t start = now_ns();
+    uint64_t elapsed;
+    do {
+        op->run();
+        passes++;
+        elapsed = now_ns() - start;
+    } while (elapsed < target_ns);
+
+    return (double)elapsed / (double)(passes * s_count);
+}
+
+int main(int argc, char **argv)
+{
+    bool csv = false;
+    unsigned long target_ms = 500;
+    uint32_t seed = 1;
+    size_t frames = 4096;
+    const char *corpus_dir = NULL;
+    const char *write_dir = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        }
+        else if (strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            target_ms = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            corpus_dir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--write") == 0 && i + 1 < argc) {
+            write_dir = argv[++i];
+        }
+        else {
+            fprintf(stderr,
+                    "usage: %s [--csv] [--ms N] [--seed N] [--frames N] [--corpus DIR] [--write DIR]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    bool loaded = corpus_dir != NULL ? load_corpus(corpus_dir) : frames > 0 && generate_corpus(seed, frames);
+    if (!loaded) {
+        fprintf(stderr, "no corpus to replay\n");
+        return 1;
+    }
+    if (write_dir != NULL) {
+        return write_corpus(write_dir) ? 0 : 1;
+    }
+
+    s_slices = calloc(s_count, sizeof(*s_slices));
+    if (s_slices == NULL) {
+        return 1;
+    }
+    for (size_t i = 0; i < s_count; i++) {
+        s_slices[i].data = s_corpus[i].data;
+        s_slices[i].len = s_corpus[i].len;
+    }
+    beam_ring_init(&s_ring, s_ring_slots, RING_SLOTS);
+
+    if (csv) {
+        printf("op,frames,accepted,ns_per_frame,frames_per_sec\n");
+    }
+    else {
+        printf("BEAM corpus replay, CRC backend: %s, corpus: ", CRC_BACKEND_NAME);
+        if (corpus_dir != NULL) {
+            printf("%s\n\n", corpus_dir);
+        }
+        else {
+            printf("seed %lu\n\n", (unsigned long)seed);
+        }
+        printf("%-10s %8s %9s %12s %14s\n", "op", "frames", "accepted", "ns/frame", "frames/s");
+    }
+
+    for (size_t o = 0; o < sizeof(s_ops) / sizeof(s_ops[0]); o++) {
+        size_t accepted = 0;
+        double ns = measure(&s_ops[o], (uint64_t)target_ms * 1000000u, &accepted);
+        double fps = 1e9 / ns;
+
+        if (csv) {
+            printf("%s,%zu,%zu,%.2f,%.0f\n", s_ops[o].name, s_count, accepted, ns, fps);
+        }
+        else {
+            printf("%-10s %8zu %9zu %12.2f %14.0f\n", s_ops[o].name, s_count, accepted, ns, fps);
+        }
+    }
+
+    free(s_slices);
+    free(s_corpus);
+
+    return 0;
+}
@@ -0,0 +1,297 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * Host microbenchmark for the parse, view, batch and serialize paths.
+ *
+ * Usage: beam_parser_bench [--csv] [--ms N] [--baseline FILE] [--max-regress PCT]
+ *   --csv              print one CSV row per case (op,payload_len,ns_per_frame,frames_per_sec)
+ *   --ms N             target run time per case in milliseconds (default 200)
+ *   --baseline FILE    compare each case with the same case in FILE, the output of an earlier --csv run
+ *   --max-regress PCT  with --baseline, exit 1 if a case got slower than its baseline by more than
+ *                      PCT percent (default 10); cases missing from FILE are not compared
+ */
+
+#include "beam_frame.h"
+#include "beam_frame_builder.h"
+#include "beam_parser.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BATCH_SIZE 16   /**< Frames per beam_parse_batch() call */
+#define MAX_BASELINE 64 /**< Cases read from a --baseline file */
+#define OP_NAME_SIZE 16 /**< Longest op name in a --baseline file, plus NUL */
+
+#if CONFIG_BEAM_CRC_BACKEND_TABLE
+#define CRC_BACKEND_NAME "table"
+#elif CONFIG_BEAM_CRC_BACKEND_SLICE4
+#define CRC_BACKEND_NAME "slice4"
+#else
+#define CRC_BACKEND_NAME "rom (bitwise on host)"
+#endif
+
+static const uint8_t s_payload_lens[] = {0, 1, 8, 12, 32, 64, 128, MAX_PAYLOAD_SIZE};
+
+static uint8_t s_frame[FRAME_MAX_SIZE];
+static size_t s_frame_len;
+static uint8_t s_batch_frames[BATCH_SIZE][FRAME_MAX_SIZE];
+static beam_rx_slice_t s_batch_in[BATCH_SIZE];
+static beam_frame_view_t s_batch_out[BATCH_SIZE];
+static esp_err_t s_batch_status[BATCH_SIZE];
+static beam_frame_t s_parsed;
+static uint8_t s_out[FRAME_MAX_SIZE];
+
+/* Results feed this sink so the compiler cannot drop the measured calls */
+static volatile uint32_t s_sink;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void build_frame(uint8_t *buf, uint8_t payload_len, uint8_t seq, size_t *out_len)
+{
+    beam_frame_builder_t builder;
+
+    beam_frame_begin(&builder, buf, FRAME_MAX_SIZE, 0x42, 0, seq);
+    for (uint8_t i = 0; i < payload_len; i++) {
+        beam_frame_put_u8(&builder, (uint8_t)(i * 31u + seq));
+    }
+    beam_frame_finish(&builder, out_len);
+}
+
+/* One benchmark operation: processes frames_per_call frames per call */
+typedef struct bench_op {
+    const char *name;
+    size_t frames_per_call;
+    void (*run)(void);
+} bench_op_t;
+
+static void run_parse(void)
+{
+    s_sink += (uint32_t)beam_parse_into_frame(s_frame, s_frame_len, &s_parsed);
+    s_sink += s_parsed.crc;
+}
+
+static void run_view(void)
+{
+    beam_frame_view_t view;
+
+    s_sink += (uint32_t)beam_parse_view(s_frame, s_frame_len, &view);
+    s_sink += (uint32_t)view.size;
+}
+
+static void run_batch(void)
+{
+    s_sink += (uint32_t)beam_parse_batch(s_batch_in, BATCH_SIZE, s_batch_out, s_batch_status);
+    s_sink += (uint32_t)s_batch_out[BATCH_SIZE - 1].size;
+}
+
+static void run_serialize(void)
+{
+    size_t size = 0;
+
+    s_sink += (uint32_t)beam_serialize_frame(&s_parsed, s_out, sizeof(s_out), &size);
+    s_sink += s_out[size - 1];
+}
+
+static const bench_op_t s_ops[] = {
+    {"parse", 1, run_parse},
+    {"view", 1, run_view},
+    {"batch", BATCH_SIZE, run_batch},
+    {"serialize", 1, run_serialize},
+};
+
+/**
+ * @brief Run op repeatedly for about target_ns and return nanoseconds per frame.
+ */
+static double measure(const bench_op_t *op, uint64_t target_ns)
+{
+    // Warm up caches and branch predictors, then grow the batch until it is long enough to time
+    for (int i = 0; i < 1000; i++) {
+        op->run();
+    }
+
+    uint64_t iterations = 1000;
+    for (;;) {
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            op->run();
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        if (elapsed >= target_ns || iterations >= (UINT64_C(1) << 40)) {
+            return (double)elapsed / (double)(iterations * op->frames_per_call);
+        }
+        iterations = elapsed < target_ns / 64 ? iterations * 64 : iterations * target_ns / elapsed + 1;
+    }
+}
+
+/* One row of a --baseline file */
+typedef struct baseline_row {
+    char op[OP_NAME_SIZE];
+    unsigned payload_len;
+    double ns_per_frame;
+} baseline_row_t;
+
+static baseline_row_t s_baseline[MAX_BASELINE];
+static size_t s_baseline_count;
+
+/**
+ * @brief Read the rows of a --csv output into s_baseline; the header line is skipped.
+ */
+static bool load_baseline(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+
+    char line[128];
+    while (fgets(line, sizeof(line), file) != NULL && s_baseline_count < MAX_BASELINE) {
+        baseline_row_t *row = &s_baseline[s_baseline_count];
+        // %15 keeps the op name within OP_NAME_SIZE
+        if (sscanf(line, "%15[^,],%u,%lf", row->op, &row->payload_len, &row->ns_per_frame) == 3) {
+            s_baseline_count++;
+        }
+    }
+    fclose(file);
+
+    if (s_baseline_count == 0) {
+        fprintf(stderr, "%s: no benchmark rows\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Baseline ns/frame of a case, or a negative value if the baseline does not have it.
+ */
+static double baseline_ns(const char *op, unsigned payload_len)
+{
+    for (size_t i = 0; i < s_baseline_count; i++) {
+        if (s_baseline[i].payload_len == payload_len && strcmp(s_baseline[i].op, op) == 0) {
+            return s_baseline[i].ns_per_frame;
+        }
+    }
+
+    return -1.0;
+}
+
+static void prepare(uint8_t payload_len)
+{
+    build_frame(s_frame, payload_len, 0, &s_frame_len);
+    beam_parse_into_frame(s_frame, s_frame_len, &s_parsed);
+
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        size_t len = 0;
+        build_frame(s_batch_frames[i], payload_len, (uint8_t)i, &len);
+        s_batch_in[i].data = s_batch_frames[i];
+        s_batch_in[i].len = len;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool csv = false;
+    unsigned long target_ms = 200;
+    const char *baseline = NULL;
+    double max_regress = 10.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        }
+        else if (strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            target_ms = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        }
+        else if (strcmp(argv[i], "--max-regress") == 0 && i + 1 < argc) {
+            max_regress = strtod(argv[++i], NULL);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--csv] [--ms N] [--baseline FILE] [--max-regress PCT]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (baseline != NULL && !load_baseline(baseline)) {
+        return 2;
+    }
+
+    if (csv) {
+        printf("op,payload_len,ns_per_frame,frames_per_sec\n");
+    }
+    else {
+        printf("BEAM parser benchmark, CRC backend: %s\n\n", CRC_BACKEND_NAME);
+        printf("%-10s %8s %12s %14s\n", "op", "payload", "ns/frame", "frames/s");
+    }
+
+    size_t compared = 0;
+    size_t regressions = 0;
+    for (size_t s = 0; s < sizeof(s_payload_lens) / sizeof(s_payload_lens[0]); s++) {
+        prepare(s_payload_lens[s]);
+
+        for (size_t o = 0; o < sizeof(s_ops) / sizeof(s_ops[0]); o++) {
+            double ns = measure(&s_ops[o], (uint64_t)target_ms * 1000000u);
+            double fps = 1e9 / ns;
+
+            if (csv) {
+                printf("%s,%u,%.2f,%.0f\n", s_ops[o].name, s_payload_lens[s], ns, fps);
+            }
+            else {
+                printf("%-10s %8u %12.2f %14.0f\n", s_ops[o].name, s_payload_lens[s], ns, fps);
+            }
+
+            double base = baseline_ns(s_ops[o].name, s_payload_lens[s]);
+            if (base < 0.0) {
+                continue;
+            }
+            compared++;
+            if (ns > base * (1.0 + max_regress / 100.0)) {
+                fprintf(stderr,
+                        "regression: %s payload %u: %.2f ns/frame, baseline %.2f (+%.1f%%, limit %.1f%%)\n",
+                        s_ops[o].name,
+                        s_payload_lens[s],
+                        ns,
+                        base,
+                        (ns / base - 1.0) * 100.0,
+                        max_regress);
+                regressions++;
+            }
+        }
+    }
+
+    if (baseline != NULL) {
+        fprintf(stderr, "%zu of %zu cases slower than %s allows\n", regressions, compared, baseline);
+        if (compared == 0) {
+            return 2;
+        }
+    }
+
+    return regressions == 0 ? 0 : 1;
+}
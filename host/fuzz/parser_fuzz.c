@@ -0,0 +1,413 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * Differential fuzz target for the receive paths. Every input is checked by a small
+ * reference parser written straight from the wire format (bitwise CRC, no tables, no
+ * shortcuts), and each fast path must agree with it: beam_validate_frame(),
+ * beam_parse_view(), beam_parse_batch(), beam_parse_into_frame(), beam_ring_push_frame()
+ * and the three CRC backends. beam_parse_into_frame_telemetry() must agree with
+ * beam_parse_into_frame() except on compact telemetry, which it may refuse to expand. The stream decoders only have to survive the input and
+ * emit frames that validate. Any disagreement aborts, so the fuzzer keeps the input.
+ *
+ * libFuzzer (clang):   cmake -S host -B build-fuzz -DBEAM_FUZZ=ON -DCMAKE_C_COMPILER=clang
+ *                      ./build-fuzz/beam_parser_fuzz corpus/
+ * AFL++ / replay:      built with BEAM_FUZZ_STANDALONE, the target reads each file named on
+ *                      the command line (or stdin), e.g. afl-fuzz -i seeds -o out -- ./beam_parser_fuzz @@
+ */
+
+#include "beam_compress.h"
+#include "beam_crc.h"
+#include "beam_frame.h"
+#include "beam_frame_view.h"
+#include "beam_parser.h"
+#include "beam_ring.h"
+#include "beam_stream.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RING_SLOTS 2u /**< One push per input; two slots keep the ring a power of two */
+
+/** Abort with the failed condition; the fuzzer saves the input as a crash */
+#define FUZZ_CHECK(condition)                                                                                          \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);                             \
+            abort();                                                                                                   \
+        }                                                                                                              \
+    } while (0)
+
+/**
+ * @brief Reference result for one input.
+ */
+typedef struct ref_frame {
+    esp_err_t err;       ///< What every validating path must return
+    uint8_t category;    ///< Header fields, set when err is ESP_OK
+    uint8_t flags;       ///< Header flags
+    uint8_t seq;         ///< Header seq
+    uint8_t wire_len;    ///< Header len: payload plus the MSG_FLAG_EXT_TS timestamp
+    uint8_t len;         ///< Payload length
+    uint16_t crc;        ///< Received CRC
+    uint32_t timestamp;  ///< Sender timestamp, 0 without MSG_FLAG_EXT_TS
+    const uint8_t *data; ///< Payload bytes
+} ref_frame_t;
+
+/**
+ * @brief CRC-16-CCITT bit by bit, with the inverted-in/inverted-out convention of beam_crc16().
+ */
+static uint16_t ref_crc16(uint16_t crc, const uint8_t *data, size_t len)
+{
+    crc = (uint16_t)~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return (uint16_t)~crc;
+}
+
+/**
+ * @brief Checks data against the wire format, in the order the parser documents its errors.
+ */
+static ref_frame_t ref_parse(const uint8_t *data, size_t size)
+{
+    ref_frame_t ref = {.err = ESP_ERR_INVALID_SIZE};
+
+    if (size < 4) {
+        return ref;
+    }
+    uint8_t len = data[3];
+    if (len > MAX_PAYLOAD_SIZE || size < 4u + len + 2u) {
+        return ref;
+    }
+    size_t ext = (data[1] & MSG_FLAG_EXT_TS) ? 4u : 0u;
+    if (len < ext) {
+        return ref;
+    }
+
+    uint16_t received = (uint16_t)(data[4 + len] | (data[4 + len + 1] << 8));
+    if (ref_crc16(BEAM_CRC_INIT, data, 4u + len) != received) {
+        ref.err = ESP_ERR_INVALID_CRC;
+        return ref;
+    }
+
+    ref.err = ESP_OK;
+    ref.category = data[0];
+    ref.flags = data[1];
+    ref.seq = data[2];
+    ref.wire_len = len;
+    ref.len = (uint8_t)(len - ext);
+    ref.crc = received;
+    ref.data = data + 4 + ext;
+    if (ext != 0) {
+        ref.timestamp = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) |
+                        ((uint32_t)data[7] << 24);
+    }
+
+    return ref;
+}
+
+static void check_crc_backends(const uint8_t *data, size_t size)
+{
+    uint16_t expected = ref_crc16(BEAM_CRC_INIT, data, size);
+
+    FUZZ_CHECK(beam_crc16_table(BEAM_CRC_INIT, data, size) == expected);
+    FUZZ_CHECK(beam_crc16_slice4(BEAM_CRC_INIT, data, size) == expected);
+    FUZZ_CHECK(beam_crc16_rom(BEAM_CRC_INIT, data, size) == expected);
+    FUZZ_CHECK(beam_crc16(BEAM_CRC_INIT, data, size) == expected);
+
+    // Continuing a checksum must match one pass over the whole input
+    size_t split = size > 0 ? data[0] % (size + 1) : 0;
+    beam_crc_ctx_t ctx;
+    beam_crc_init(&ctx);
+    beam_crc_update(&ctx, data, split);
+    beam_crc_update(&ctx, data + split, size - split);
+    FUZZ_CHECK(beam_crc_final(&ctx) == expected);
+}
+
+static void check_validate(const uint8_t *data, size_t size, const ref_frame_t *ref)
+{
+    beam_frame_header_t header;
+    FUZZ_CHECK(beam_validate_frame(data, size, &header) == ref->err);
+    if (ref->err == ESP_OK) {
+        FUZZ_CHECK(header.msg_category == ref->category);
+        FUZZ_CHECK(header.flags == ref->flags);
+        FUZZ_CHECK(header.seq == ref->seq);
+        FUZZ_CHECK(header.len == ref->len);
+    }
+}
+
+static void check_view(const uint8_t *data, size_t size, const ref_frame_t *ref)
+{
+    beam_frame_view_t view;
+    FUZZ_CHECK(beam_parse_view(data, size, &view) == ref->err);
+    if (ref->err != ESP_OK) {
+        return;
+    }
+
+    FUZZ_CHECK(view.data == data);
+    FUZZ_CHECK(view.size == FRAME_SIZE(ref->wire_len));
+    FUZZ_CHECK(beam_frame_view_category(&view) == ref->category);
+    FUZZ_CHECK(beam_frame_view_flags(&view) == ref->flags);
+    FUZZ_CHECK(beam_frame_view_seq(&view) == ref->seq);
+    FUZZ_CHECK(beam_frame_view_payload_len(&view) == ref->len);
+    FUZZ_CHECK(beam_frame_view_payload(&view) == ref->data);
+    FUZZ_CHECK(beam_frame_view_crc(&view) == ref->crc);
+    FUZZ_CHECK(beam_frame_view_timestamp(&view) == ref->timestamp);
+}
+
+/**
+ * @brief Splits the input in two slices at a point taken from its last byte; each slice
+ *        must get the status the reference gives it.
+ */
+static void check_batch(const uint8_t *data, size_t size)
+{
+    size_t split = size > 0 ? data[size - 1] % (size + 1) : 0;
+    beam_rx_slice_t in[3] = {
+        {.data = data, .len = split},
+        {.data = data + split, .len = size - split},
+        {.data = NULL, .len = 0},
+    };
+    beam_frame_view_t out[3];
+    esp_err_t status[3];
+
+    esp_err_t result = beam_parse_batch(in, 3, out, status);
+    FUZZ_CHECK(result == ESP_FAIL);
+    FUZZ_CHECK(status[2] == ESP_ERR_INVALID_ARG);
+
+    for (size_t i = 0; i < 2; i++) {
+        ref_frame_t ref = ref_parse(in[i].data, in[i].len);
+        FUZZ_CHECK(status[i] == ref.err);
+        if (ref.err == ESP_OK) {
+            FUZZ_CHECK(out[i].data == in[i].data);
+            FUZZ_CHECK(out[i].size == FRAME_SIZE(ref.wire_len));
+        }
+    }
+}
+
+static void check_parse(const uint8_t *data, size_t size, const ref_frame_t *ref)
+{
+    beam_frame_t frame;
+    uint32_t timestamp_us = 0;
+    esp_err_t err = beam_parse_into_frame_ts(data, size, &frame, &timestamp_us);
+
+    if (ref->err != ESP_OK) {
+        FUZZ_CHECK(err == ref->err);
+        return;
+    }
+
+    // Decompression is the one extra check; its verdict comes from the codec itself
+    uint8_t inflated[MAX_PAYLOAD_SIZE];
+    size_t inflated_len = ref->len;
+    const uint8_t *payload = ref->data;
+    if (ref->flags & MSG_FLAG_COMPRESSED) {
+        esp_err_t inflate_err = beam_decompress(ref->data, ref->len, inflated, sizeof(inflated), &inflated_len);
+        FUZZ_CHECK(err == (inflate_err == ESP_OK ? ESP_OK : ESP_ERR_INVALID_SIZE));
+        if (err != ESP_OK) {
+            return;
+        }
+        FUZZ_CHECK(inflated_len <= MAX_PAYLOAD_SIZE);
+        payload = inflated;
+    }
+    FUZZ_CHECK(err == ESP_OK);
+    FUZZ_CHECK(frame.header.msg_category == ref->category);
+    FUZZ_CHECK(frame.header.seq == ref->seq);
+    FUZZ_CHECK(frame.crc == ref->crc);
+    FUZZ_CHECK(timestamp_us == ref->timestamp);
+
+    // A compact keyframe is rewritten into the float payload; compare the rest byte for byte
+    if (ref->flags & MSG_FLAG_COMPACT) {
+        return;
+    }
+    FUZZ_CHECK(frame.header.flags == (ref->flags & (uint8_t)~MSG_FLAG_COMPRESSED));
+    FUZZ_CHECK(frame.header.len == inflated_len);
+
+    uint8_t typed_size = beam_payload_size(ref->category);
+    size_t copied = (typed_size != 0 && inflated_len >= typed_size && payload == ref->data) ? typed_size : inflated_len;
+    FUZZ_CHECK(memcmp(frame.payload.raw, payload, copied) == 0);
+
+    // Every payload byte came through: serializing must give back the received frame
+    if (copied == ref->len && payload == ref->data) {
+        uint8_t out[FRAME_MAX_SIZE];
+        size_t out_size = 0;
+        esp_err_t serialize_err = (frame.header.flags & MSG_FLAG_EXT_TS)
+                                      ? beam_serialize_frame_ts(&frame, timestamp_us, out, sizeof(out), &out_size)
+                                      : beam_serialize_frame(&frame, out, sizeof(out), &out_size);
+        FUZZ_CHECK(serialize_err == ESP_OK);
+        FUZZ_CHECK(out_size == FRAME_SIZE(ref->wire_len));
+        FUZZ_CHECK(memcmp(out, data, out_size) == 0);
+    }
+}
+
+static void check_parse_telemetry(const uint8_t *data, size_t size)
+{
+    // One decoder across inputs, so deltas sometimes meet a matching keyframe
+    static beam_telemetry_decoder_t s_decoder;
+    beam_frame_t plain;
+    beam_frame_t frame;
+    esp_err_t plain_err = beam_parse_into_frame(data, size, &plain);
+    esp_err_t err = beam_parse_into_frame_telemetry(data, size, &frame, &s_decoder);
+
+    if (plain_err != ESP_OK || plain.header.msg_category != MSG_CAT_TELEMETRY ||
+        !(plain.header.flags & MSG_FLAG_COMPACT)) {
+        FUZZ_CHECK(err == plain_err);
+        if (err == ESP_OK) {
+            FUZZ_CHECK(frame.header.flags == plain.header.flags);
+            FUZZ_CHECK(frame.header.len == plain.header.len);
+        }
+        return;
+    }
+
+    FUZZ_CHECK(err == ESP_OK || err == ESP_ERR_INVALID_SIZE || err == ESP_ERR_NOT_FOUND);
+    if (err == ESP_OK) {
+        FUZZ_CHECK(!(frame.header.flags & (MSG_FLAG_COMPACT | MSG_FLAG_DELTA)));
+        FUZZ_CHECK(frame.header.len == sizeof(beam_payload_telemetry_t));
+    }
+}
+
+static void check_ring(const uint8_t *data, size_t size, const ref_frame_t *ref)
+{
+    beam_frame_buf_t slots[RING_SLOTS];
+    beam_ring_t ring;
+    FUZZ_CHECK(beam_ring_init(&ring, slots, RING_SLOTS) == ESP_OK);
+
+    FUZZ_CHECK(beam_ring_push_frame(&ring, data, size) == ref->err);
+
+    beam_frame_view_t view;
+    esp_err_t err = beam_ring_peek(&ring, &view);
+    if (ref->err != ESP_OK) {
+        FUZZ_CHECK(err == ESP_ERR_NOT_FOUND);
+        return;
+    }
+    FUZZ_CHECK(err == ESP_OK);
+    FUZZ_CHECK(view.size == FRAME_SIZE(ref->wire_len));
+    FUZZ_CHECK(memcmp(view.data, data, view.size) == 0);
+    FUZZ_CHECK(beam_ring_release(&ring) == ESP_OK);
+}
+
+static void check_decompress(const uint8_t *data, size_t size)
+{
+    uint8_t out[MAX_PAYLOAD_SIZE];
+    size_t out_len = 0;
+
+    if (beam_decompress(data, size, out, sizeof(out), &out_len) == ESP_OK) {
+        FUZZ_CHECK(out_len <= sizeof(out));
+    }
+}
+
+static void on_stream_frame(const beam_frame_view_t *view, void *ctx)
+{
+    (void)ctx;
+    ref_frame_t ref = ref_parse(view->data, view->size);
+    FUZZ_CHECK(ref.err == ESP_OK);
+    FUZZ_CHECK(view->size == FRAME_SIZE(ref.wire_len));
+}
+
+/**
+ * @brief Feeds the input to both stream decoders in two chunks.
+ */
+static void check_stream(const uint8_t *data, size_t size)
+{
+    static beam_stream_decoder_t decoder;
+    static const beam_stream_mode_t modes[] = {BEAM_STREAM_MODE_SYNC, BEAM_STREAM_MODE_COBS};
+    size_t split = size / 2;
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        FUZZ_CHECK(beam_stream_decoder_init(&decoder, modes[m], on_stream_frame, NULL) == ESP_OK);
+        FUZZ_CHECK(beam_stream_decoder_feed(&decoder, data, split) == ESP_OK);
+        FUZZ_CHECK(beam_stream_decoder_feed(&decoder, data + split, size - split) == ESP_OK);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    ref_frame_t ref = ref_parse(data, size);
+
+    check_crc_backends(data, size);
+    check_validate(data, size, &ref);
+    check_view(data, size, &ref);
+    check_batch(data, size);
+    check_parse(data, size, &ref);
+    check_parse_telemetry(data, size);
+    check_ring(data, size, &ref);
+    check_decompress(data, size);
+    check_stream(data, size);
+
+    return 0;
+}
+
+#if BEAM_FUZZ_STANDALONE
+/**
+ * @brief Runs one input from an exactly sized heap buffer, so ASan sees any over-read.
+ */
+static int run_file(FILE *file, const char *name)
+{
+    uint8_t chunk[4096];
+    uint8_t *data = NULL;
+    size_t size = 0;
+    size_t n;
+
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        uint8_t *grown = realloc(data, size + n);
+        if (grown == NULL) {
+            free(data);
+            fprintf(stderr, "%s: out of memory\n", name);
+            return 1;
+        }
+        data = grown;
+        memcpy(data + size, chunk, n);
+        size += n;
+    }
+
+    // malloc(0) may return NULL; the paths under test want a pointer even for an empty input
+    uint8_t *input = size > 0 ? data : malloc(1);
+    LLVMFuzzerTestOneInput(input, size);
+    free(input);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        return run_file(stdin, "<stdin>");
+    }
+
+    size_t inputs = 0;
+    for (int i = 1; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        if (file == NULL) {
+            perror(argv[i]);
+            return 1;
+        }
+        int err = run_file(file, argv[i]);
+        fclose(file);
+        if (err != 0) {
+            return err;
+        }
+        inputs++;
+    }
+    fprintf(stderr, "%zu inputs OK\n", inputs);
+
+    return 0;
+}
+#endif
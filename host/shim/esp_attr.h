@@ -0,0 +1,27 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Host build: memory placement attributes have no meaning off-target; FORCE_INLINE_ATTR is as in IDF. */
+
+#ifndef BEAM_HOST_ESP_ATTR_H
+#define BEAM_HOST_ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define EXT_RAM_BSS_ATTR
+#define FORCE_INLINE_ATTR static inline __attribute__((always_inline))
+
+#endif /* BEAM_HOST_ESP_ATTR_H */
@@ -0,0 +1,24 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Host build: BIT() from ESP-IDF esp_bit_defs.h. */
+
+#ifndef BEAM_HOST_ESP_BIT_DEFS_H
+#define BEAM_HOST_ESP_BIT_DEFS_H
+
+#define BIT(nr) (1UL << (nr))
+
+#endif /* BEAM_HOST_ESP_BIT_DEFS_H */
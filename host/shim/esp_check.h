@@ -0,0 +1,50 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Host build: the ESP-IDF esp_check.h macros used by the component. */
+
+#ifndef BEAM_HOST_ESP_CHECK_H
+#define BEAM_HOST_ESP_CHECK_H
+
+#include "esp_err.h"
+#include "esp_log.h"
+
+#define ESP_RETURN_ON_FALSE(a, err_code, log_tag, format, ...)                      \
+    do {                                                                            \
+        if (!(a)) {                                                                 \
+            ESP_LOGE(log_tag, "%s(%d): " format, __func__, __LINE__, ##__VA_ARGS__); \
+            return err_code;                                                        \
+        }                                                                           \
+    } while (0)
+
+#define ESP_RETURN_ON_FALSE_ISR(a, err_code, log_tag, format, ...)                        \
+    do {                                                                                  \
+        if (!(a)) {                                                                       \
+            ESP_EARLY_LOGE(log_tag, "%s(%d): " format, __func__, __LINE__, ##__VA_ARGS__); \
+            return err_code;                                                              \
+        }                                                                                 \
+    } while (0)
+
+#define ESP_RETURN_ON_ERROR(x, log_tag, format, ...)                                \
+    do {                                                                            \
+        esp_err_t err_rc_ = (x);                                                    \
+        if (err_rc_ != ESP_OK) {                                                    \
+            ESP_LOGE(log_tag, "%s(%d): " format, __func__, __LINE__, ##__VA_ARGS__); \
+            return err_rc_;                                                         \
+        }                                                                           \
+    } while (0)
+
+#endif /* BEAM_HOST_ESP_CHECK_H */
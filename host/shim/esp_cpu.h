@@ -0,0 +1,35 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Host build: a nanosecond clock stands in for the CPU cycle counter. */
+
+#ifndef BEAM_HOST_ESP_CPU_H
+#define BEAM_HOST_ESP_CPU_H
+
+#include <stdint.h>
+#include <time.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (esp_cpu_cycle_count_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+#endif /* BEAM_HOST_ESP_CPU_H */
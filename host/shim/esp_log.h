@@ -0,0 +1,44 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Host build: ESP-IDF logging macros printing to stderr. */
+
+#ifndef BEAM_HOST_ESP_LOG_H
+#define BEAM_HOST_ESP_LOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_LOGE(tag, format, ...) fprintf(stderr, "E (%u) %s: " format "\n", esp_log_timestamp(), tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) fprintf(stderr, "W (%u) %s: " format "\n", esp_log_timestamp(), tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) fprintf(stderr, "I (%u) %s: " format "\n", esp_log_timestamp(), tag, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ((void)(tag))
+#define ESP_EARLY_LOGE ESP_LOGE
+
+/**
+ * @brief Milliseconds since start, as in ESP-IDF.
+ */
+uint32_t esp_log_timestamp(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_HOST_ESP_LOG_H */
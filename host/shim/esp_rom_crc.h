@@ -0,0 +1,37 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Host build: bitwise equivalent of the ROM esp_rom_crc16_be() (inverted in and out). */
+
+#ifndef BEAM_HOST_ESP_ROM_CRC_H
+#define BEAM_HOST_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+static inline uint16_t esp_rom_crc16_be(uint16_t crc, uint8_t const *buf, uint32_t len)
+{
+    crc = (uint16_t)~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)(buf[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return (uint16_t)~crc;
+}
+
+#endif /* BEAM_HOST_ESP_ROM_CRC_H */
@@ -0,0 +1,237 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Host build: out-of-line functions of the ESP-IDF shims. */
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+struct beam_host_task {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t notify;
+    bool deleted;
+    TaskFunction_t entry;
+    void *arg;
+};
+
+static __thread struct beam_host_task *s_current_task;
+
+uint32_t esp_log_timestamp(void)
+{
+    static struct timespec s_start;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (s_start.tv_sec == 0 && s_start.tv_nsec == 0) {
+        s_start = now;
+    }
+
+    return (uint32_t)((now.tv_sec - s_start.tv_sec) * 1000 + (now.tv_nsec - s_start.tv_nsec) / 1000000);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:
+        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+        return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:
+        return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:
+        return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC:
+        return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION:
+        return "ESP_ERR_INVALID_VERSION";
+    case ESP_ERR_INVALID_MAC:
+        return "ESP_ERR_INVALID_MAC";
+    case ESP_ERR_NOT_FINISHED:
+        return "ESP_ERR_NOT_FINISHED";
+    default:
+        return "UNKNOWN ERROR";
+    }
+}
+
+static void *task_trampoline(void *arg)
+{
+    struct beam_host_task *task = arg;
+
+    s_current_task = task;
+    task->entry(task->arg);
+
+    return NULL;
+}
+
+/**
+ * @brief Exit the calling task if another task deleted it. Call with task->mutex held.
+ */
+static void exit_if_deleted(struct beam_host_task *task)
+{
+    if (task->deleted) {
+        pthread_mutex_unlock(&task->mutex);
+        pthread_exit(NULL);
+    }
+}
+
+static struct timespec deadline_after(TickType_t ticks)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ticks / 1000;
+    ts.tv_nsec += (long)(ticks % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+
+    return ts;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t entry,
+                                   const char *name,
+                                   uint32_t stack_depth,
+                                   void *arg,
+                                   UBaseType_t priority,
+                                   TaskHandle_t *out_handle,
+                                   BaseType_t core_id)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    (void)core_id;
+
+    struct beam_host_task *task = calloc(1, sizeof(*task));
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    pthread_mutex_init(&task->mutex, NULL);
+    pthread_cond_init(&task->cond, NULL);
+    task->entry = entry;
+    task->arg = arg;
+
+    if (pthread_create(&task->thread, NULL, task_trampoline, task) != 0) {
+        free(task);
+        return pdFAIL;
+    }
+    if (out_handle != NULL) {
+        *out_handle = task;
+    }
+
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL || task == s_current_task) {
+        task = s_current_task;
+        pthread_detach(task->thread);
+        free(task);
+        pthread_exit(NULL);
+    }
+
+    pthread_mutex_lock(&task->mutex);
+    task->deleted = true;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->mutex);
+
+    pthread_join(task->thread, NULL);
+    pthread_cond_destroy(&task->cond);
+    pthread_mutex_destroy(&task->mutex);
+    free(task);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct beam_host_task *task = s_current_task;
+    struct timespec deadline = deadline_after(ticks);
+
+    if (task == NULL) {
+        while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&task->mutex);
+    while (!task->deleted && pthread_cond_timedwait(&task->cond, &task->mutex, &deadline) != ETIMEDOUT) {
+    }
+    exit_if_deleted(task);
+    pthread_mutex_unlock(&task->mutex);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->mutex);
+    task->notify++;
+    pthread_cond_signal(&task->cond);
+    pthread_mutex_unlock(&task->mutex);
+
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    struct beam_host_task *task = s_current_task;
+    struct timespec deadline = deadline_after(ticks == portMAX_DELAY ? 0 : ticks);
+
+    pthread_mutex_lock(&task->mutex);
+    while (task->notify == 0 && !task->deleted) {
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&task->cond, &task->mutex);
+        }
+        else if (pthread_cond_timedwait(&task->cond, &task->mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    exit_if_deleted(task);
+
+    uint32_t value = task->notify;
+    if (value > 0) {
+        task->notify = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->mutex);
+
+    return value;
+}
@@ -0,0 +1,49 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/* Host build: critical sections map to a pthread mutex per portMUX_TYPE; one tick is 1 ms. */
+
+#ifndef BEAM_HOST_FREERTOS_H
+#define BEAM_HOST_FREERTOS_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+typedef struct {
+    pthread_mutex_t mutex;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {PTHREAD_MUTEX_INITIALIZER}
+
+#define portENTER_CRITICAL(mux) pthread_mutex_lock(&(mux)->mutex)
+#define portEXIT_CRITICAL(mux) pthread_mutex_unlock(&(mux)->mutex)
+#define portENTER_CRITICAL_SAFE(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_SAFE(mux) portEXIT_CRITICAL(mux)
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define portMAX_DELAY ((TickType_t)UINT32_MAX)
+#define portTICK_PERIOD_MS 1u
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif /* BEAM_HOST_FREERTOS_H */
@@ -0,0 +1,45 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * Host build: tasks are pthreads (core and priority are ignored) and direct-to-task
+ * notifications are a counter under a mutex and condition variable. vTaskDelete() of
+ * another task takes effect when that task next blocks in ulTaskNotifyTake() or vTaskDelay().
+ */
+
+#ifndef BEAM_HOST_FREERTOS_TASK_H
+#define BEAM_HOST_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+
+typedef struct beam_host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *arg);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task,
+                                   const char *name,
+                                   uint32_t stack_depth,
+                                   void *arg,
+                                   UBaseType_t priority,
+                                   TaskHandle_t *out_handle,
+                                   BaseType_t core_id);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+
+#endif /* BEAM_HOST_FREERTOS_TASK_H */
@@ -0,0 +1,145 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * Host build: Kconfig defaults of the component. Override any option on the compiler
+ * command line (e.g. -DCONFIG_BEAM_POOL_BUFFER_COUNT=64); the CRC backend is selected
+ * with the BEAM_CRC_BACKEND CMake cache variable.
+ */
+
+#ifndef BEAM_HOST_SDKCONFIG_H
+#define BEAM_HOST_SDKCONFIG_H
+
+#define CONFIG_IDF_TARGET "linux"
+
+#if !defined(CONFIG_BEAM_CRC_BACKEND_ROM) && !defined(CONFIG_BEAM_CRC_BACKEND_TABLE) && \
+    !defined(CONFIG_BEAM_CRC_BACKEND_SLICE4)
+#define CONFIG_BEAM_CRC_BACKEND_ROM 1
+#endif
+
+#ifndef CONFIG_BEAM_STATS
+#define CONFIG_BEAM_STATS 1
+#endif
+
+#if CONFIG_BEAM_PARSER_SILENT && CONFIG_BEAM_STATS && !defined(CONFIG_BEAM_PARSER_ERROR_LOG_INTERVAL_MS)
+#define CONFIG_BEAM_PARSER_ERROR_LOG_INTERVAL_MS 1000
+#endif
+
+#ifndef CONFIG_BEAM_DISPATCH_MAX_SUBSCRIBERS
+#define CONFIG_BEAM_DISPATCH_MAX_SUBSCRIBERS 16
+#endif
+
+#ifndef CONFIG_BEAM_SEQ_MAX_PEERS
+#define CONFIG_BEAM_SEQ_MAX_PEERS 8
+#endif
+
+#ifndef CONFIG_BEAM_GATEWAY_MAX_PEERS
+#define CONFIG_BEAM_GATEWAY_MAX_PEERS 24
+#endif
+
+#ifndef CONFIG_BEAM_GATEWAY_QUEUE_DEPTH
+#define CONFIG_BEAM_GATEWAY_QUEUE_DEPTH 4
+#endif
+
+#ifndef CONFIG_BEAM_PIPELINE_QUEUE_DEPTH
+#define CONFIG_BEAM_PIPELINE_QUEUE_DEPTH 16
+#endif
+
+#ifndef CONFIG_BEAM_PIPELINE_RX_CORE
+#define CONFIG_BEAM_PIPELINE_RX_CORE 0
+#endif
+
+#ifndef CONFIG_BEAM_PIPELINE_DISPATCH_CORE
+#define CONFIG_BEAM_PIPELINE_DISPATCH_CORE 1
+#endif
+
+#ifndef CONFIG_BEAM_PIPELINE_RX_PRIORITY
+#define CONFIG_BEAM_PIPELINE_RX_PRIORITY 10
+#endif
+
+#ifndef CONFIG_BEAM_PIPELINE_DISPATCH_PRIORITY
+#define CONFIG_BEAM_PIPELINE_DISPATCH_PRIORITY 5
+#endif
+
+#ifndef CONFIG_BEAM_PIPELINE_RX_STACK_SIZE
+#define CONFIG_BEAM_PIPELINE_RX_STACK_SIZE 2048
+#endif
+
+#ifndef CONFIG_BEAM_PIPELINE_DISPATCH_STACK_SIZE
+#define CONFIG_BEAM_PIPELINE_DISPATCH_STACK_SIZE 4096
+#endif
+
+#ifndef CONFIG_BEAM_SCHED_MAX_RATE_LIMITS
+#define CONFIG_BEAM_SCHED_MAX_RATE_LIMITS 4
+#endif
+
+#ifndef CONFIG_BEAM_ARQ_WINDOW_SIZE
+#define CONFIG_BEAM_ARQ_WINDOW_SIZE 8
+#endif
+
+#ifndef CONFIG_BEAM_ARQ_MAX_RETRIES
+#define CONFIG_BEAM_ARQ_MAX_RETRIES 4
+#endif
+
+#ifndef CONFIG_BEAM_ARQ_INITIAL_RTO_MS
+#define CONFIG_BEAM_ARQ_INITIAL_RTO_MS 100
+#endif
+
+#ifndef CONFIG_BEAM_ARQ_MIN_RTO_MS
+#define CONFIG_BEAM_ARQ_MIN_RTO_MS 10
+#endif
+
+#ifndef CONFIG_BEAM_ARQ_MAX_RTO_MS
+#define CONFIG_BEAM_ARQ_MAX_RTO_MS 2000
+#endif
+
+#ifndef CONFIG_BEAM_ARQ_RESYNC_STALE
+#define CONFIG_BEAM_ARQ_RESYNC_STALE 3
+#endif
+
+#ifndef CONFIG_BEAM_FRAG_MAX_FRAGMENTS
+#define CONFIG_BEAM_FRAG_MAX_FRAGMENTS 16
+#endif
+
+#ifndef CONFIG_BEAM_FRAG_MAX_REASSEMBLIES
+#define CONFIG_BEAM_FRAG_MAX_REASSEMBLIES 2
+#endif
+
+#ifndef CONFIG_BEAM_FRAG_TIMEOUT_MS
+#define CONFIG_BEAM_FRAG_TIMEOUT_MS 2000
+#endif
+
+#ifndef CONFIG_BEAM_TELEMETRY_COMPACT_SCALE
+#define CONFIG_BEAM_TELEMETRY_COMPACT_SCALE 100
+#endif
+
+#ifndef CONFIG_BEAM_TELEMETRY_KEYFRAME_INTERVAL
+#define CONFIG_BEAM_TELEMETRY_KEYFRAME_INTERVAL 10
+#endif
+
+#ifndef CONFIG_BEAM_POOL_BUFFER_COUNT
+#define CONFIG_BEAM_POOL_BUFFER_COUNT 16
+#endif
+
+#ifndef CONFIG_BEAM_RECORDER_BATCH_SIZE
+#define CONFIG_BEAM_RECORDER_BATCH_SIZE 4096
+#endif
+
+#if CONFIG_BEAM_LATENCY_TRACE && !defined(CONFIG_BEAM_LATENCY_MAX_CATEGORIES)
+#define CONFIG_BEAM_LATENCY_MAX_CATEGORIES 4
+#endif
+
+#endif /* BEAM_HOST_SDKCONFIG_H */
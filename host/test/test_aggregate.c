@@ -0,0 +1,196 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_aggregate: coalescing small messages into aggregate frames and reading them back.
+ */
+
+#include "beam_aggregate.h"
+#include "beam_message_common.h"
+#include "beam_parser.h"
+#include "test_util.h"
+#include <string.h>
+
+#define MAX_FRAMES 8       /**< Frames the sink records per test */
+#define MAX_DELAY_US 10000 /**< Coalescer deadline */
+
+/* Frames passed to the flush callback, in order */
+typedef struct sink {
+    beam_frame_buf_t frames[MAX_FRAMES];
+    size_t count;
+} sink_t;
+
+static esp_err_t sink_flush(const uint8_t *frame, size_t frame_len, void *ctx)
+{
+    sink_t *sink = ctx;
+    if (sink->count == MAX_FRAMES) {
+        return ESP_FAIL;
+    }
+
+    memcpy(sink->frames[sink->count].data, frame, frame_len);
+    sink->frames[sink->count].len = (uint16_t)frame_len;
+    sink->count++;
+
+    return ESP_OK;
+}
+
+static int parse(const sink_t *sink, size_t i, beam_frame_view_t *out_view)
+{
+    CHECK(i < sink->count);
+    CHECK(beam_parse_view(sink->frames[i].data, sink->frames[i].len, out_view) == ESP_OK);
+
+    return 0;
+}
+
+/* Several messages share one frame, which takes the caller's next seq */
+static int test_messages_coalesced(void)
+{
+    static const uint8_t payloads[3][4] = {{1}, {2, 2}, {3, 3, 3}};
+    beam_coalescer_t coalescer;
+    beam_frame_view_t view;
+    beam_aggregate_iter_t it;
+    beam_aggregate_item_t item;
+    sink_t sink = {0};
+    uint8_t seq = 41;
+
+    CHECK(beam_coalescer_init(&coalescer, MSG_FLAG_PRIORITY, &seq, MAX_DELAY_US, sink_flush, &sink) == ESP_OK);
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(beam_coalescer_add(&coalescer, MSG_CAT_BATTERY, payloads[i], (uint8_t)(i + 1), 0) == ESP_OK);
+    }
+    CHECK(sink.count == 0);
+    CHECK(beam_coalescer_flush(&coalescer) == ESP_OK);
+
+    CHECK(parse(&sink, 0, &view) == 0);
+    CHECK(beam_frame_view_category(&view) == MSG_CAT_AGGREGATE);
+    CHECK(beam_frame_view_flags(&view) == MSG_FLAG_PRIORITY);
+    CHECK(beam_frame_view_seq(&view) == 41);
+    CHECK(seq == 42);
+
+    CHECK(beam_aggregate_iter_init(&it, &view) == ESP_OK);
+    for (uint8_t i = 0; i < 3; i++) {
+        CHECK(beam_aggregate_next(&it, &item) == ESP_OK);
+        CHECK(item.category == MSG_CAT_BATTERY);
+        CHECK(item.len == i + 1);
+        CHECK(memcmp(item.payload, payloads[i], item.len) == 0);
+    }
+    CHECK(beam_aggregate_next(&it, &item) == ESP_ERR_NOT_FOUND);
+
+    return 0;
+}
+
+/* A lone message goes out as a plain frame, except one that is itself an aggregate */
+static int test_lone_message(void)
+{
+    static const uint8_t payload[] = {9, 8, 7};
+    beam_coalescer_t coalescer;
+    beam_frame_view_t view;
+    sink_t sink = {0};
+    uint8_t seq = 0;
+
+    CHECK(beam_coalescer_init(&coalescer, 0, &seq, MAX_DELAY_US, sink_flush, &sink) == ESP_OK);
+    CHECK(beam_coalescer_add(&coalescer, MSG_CAT_BATTERY, payload, sizeof(payload), 0) == ESP_OK);
+    CHECK(beam_coalescer_flush(&coalescer) == ESP_OK);
+    CHECK(beam_coalescer_add(&coalescer, MSG_CAT_AGGREGATE, payload, sizeof(payload), 0) == ESP_OK);
+    CHECK(beam_coalescer_flush(&coalescer) == ESP_OK);
+
+    CHECK(parse(&sink, 0, &view) == 0);
+    CHECK(beam_frame_view_category(&view) == MSG_CAT_BATTERY);
+    CHECK(beam_frame_view_seq(&view) == 0);
+    CHECK(beam_frame_view_payload_len(&view) == sizeof(payload));
+    CHECK(memcmp(beam_frame_view_payload(&view), payload, sizeof(payload)) == 0);
+
+    CHECK(parse(&sink, 1, &view) == 0);
+    CHECK(beam_frame_view_category(&view) == MSG_CAT_AGGREGATE);
+    CHECK(beam_frame_view_seq(&view) == 1);
+    CHECK(beam_frame_view_payload_len(&view) == BEAM_AGGREGATE_ITEM_HEADER_SIZE + sizeof(payload));
+    CHECK(seq == 2);
+
+    return 0;
+}
+
+/* Pending messages go out at their deadline, or when the next one does not fit */
+static int test_flush_triggers(void)
+{
+    static const uint8_t payload[BEAM_AGGREGATE_MAX_ITEM_LEN] = {0};
+    beam_coalescer_t coalescer;
+    sink_t sink = {0};
+    uint8_t seq = 0;
+
+    CHECK(beam_coalescer_init(&coalescer, 0, &seq, MAX_DELAY_US, sink_flush, &sink) == ESP_OK);
+    CHECK(beam_coalescer_add(&coalescer, MSG_CAT_BATTERY, payload, 1, 100) == ESP_OK);
+    CHECK(beam_coalescer_poll(&coalescer, 100 + MAX_DELAY_US - 1) == ESP_OK);
+    CHECK(sink.count == 0);
+    CHECK(beam_coalescer_poll(&coalescer, 100 + MAX_DELAY_US) == ESP_OK);
+    CHECK(sink.count == 1);
+
+    CHECK(beam_coalescer_add(&coalescer, MSG_CAT_BATTERY, payload, 100, 0) == ESP_OK);
+    CHECK(beam_coalescer_add(&coalescer, MSG_CAT_BATTERY, payload, 100, 0) == ESP_OK);
+    CHECK(sink.count == 2);
+    CHECK(beam_coalescer_flush(&coalescer) == ESP_OK);
+    CHECK(sink.count == 3);
+
+    return 0;
+}
+
+/* Reliable frames leave the best-effort counter alone: beam_arq_send() numbers them */
+static int test_ack_req_not_numbered(void)
+{
+    static const uint8_t payload[] = {1};
+    beam_coalescer_t coalescer;
+    sink_t sink = {0};
+    uint8_t seq = 5;
+
+    CHECK(beam_coalescer_init(&coalescer, MSG_FLAG_ACK_REQ, &seq, MAX_DELAY_US, sink_flush, &sink) == ESP_OK);
+    CHECK(beam_coalescer_add(&coalescer, MSG_CAT_BATTERY, payload, sizeof(payload), 0) == ESP_OK);
+    CHECK(beam_coalescer_flush(&coalescer) == ESP_OK);
+    CHECK(sink.count == 1);
+    CHECK(seq == 5);
+    CHECK(beam_coalescer_init(&coalescer, MSG_FLAG_ACK_REQ, NULL, MAX_DELAY_US, sink_flush, &sink) == ESP_OK);
+
+    return 0;
+}
+
+/* Payload encoding flags cannot describe an aggregate */
+static int test_flags_restricted(void)
+{
+    beam_coalescer_t coalescer;
+    sink_t sink = {0};
+    uint8_t seq = 0;
+    const beam_flags_t rejected[] = {MSG_FLAG_COMPACT, MSG_FLAG_DELTA, MSG_FLAG_COMPRESSED, MSG_FLAG_EXT_TS};
+
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+        CHECK(beam_coalescer_init(&coalescer, rejected[i], &seq, MAX_DELAY_US, sink_flush, &sink) ==
+              ESP_ERR_INVALID_ARG);
+    }
+    CHECK(beam_coalescer_init(&coalescer, 0, NULL, MAX_DELAY_US, sink_flush, &sink) == ESP_ERR_INVALID_ARG);
+    const beam_flags_t allowed = MSG_FLAG_PRIORITY | MSG_FLAG_ACK_REQ;
+    CHECK(beam_coalescer_init(&coalescer, allowed, &seq, MAX_DELAY_US, sink_flush, &sink) == ESP_OK);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_messages_coalesced);
+    RUN_TEST(failures, test_lone_message);
+    RUN_TEST(failures, test_flush_triggers);
+    RUN_TEST(failures, test_ack_req_not_numbered);
+    RUN_TEST(failures, test_flags_restricted);
+
+    return failures == 0 ? 0 : 1;
+}
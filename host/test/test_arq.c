@@ -0,0 +1,382 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_arq: selective repeat over a simulated link that records every frame sent, so
+ * each test decides which frames and ACKs get through.
+ */
+
+#include "beam_arq.h"
+#include "beam_frame_builder.h"
+#include "beam_message_common.h"
+#include "beam_parser.h"
+#include "beam_telemetry.h"
+#include "test_util.h"
+#include <string.h>
+
+#define LINK_CAPACITY 64 /**< Frames the simulated link holds between drains */
+
+/* Frames handed to the send callback, in order */
+typedef struct link {
+    beam_frame_buf_t frames[LINK_CAPACITY];
+    size_t count;
+    uint32_t failed; /**< on_fail calls */
+} link_t;
+
+static esp_err_t link_send(const uint8_t *frame, size_t frame_len, void *ctx)
+{
+    link_t *link = ctx;
+    if (link->count == LINK_CAPACITY) {
+        return ESP_FAIL;
+    }
+
+    memcpy(link->frames[link->count].data, frame, frame_len);
+    link->frames[link->count].len = (uint16_t)frame_len;
+    link->count++;
+
+    return ESP_OK;
+}
+
+static void link_fail(uint8_t seq, void *ctx)
+{
+    (void)seq;
+    ((link_t *)ctx)->failed++;
+}
+
+/* Build a one-byte battery frame into out */
+static void build_frame(beam_frame_buf_t *out, beam_flags_t flags, uint8_t seq)
+{
+    beam_frame_builder_t builder;
+    size_t size = 0;
+
+    beam_frame_begin_len(&builder, out->data, sizeof(out->data), MSG_CAT_BATTERY, flags, seq, 1);
+    beam_frame_put_u8(&builder, seq);
+    beam_frame_finish(&builder, &size);
+    out->len = (uint16_t)size;
+}
+
+/* Deliver frame index i of the link to rx; ack receives the reply (len 0 if none) */
+static int deliver(link_t *link, size_t i, beam_arq_rx_t *rx, bool *out_deliver, beam_frame_buf_t *ack)
+{
+    beam_frame_view_t view;
+    CHECK(beam_parse_view(link->frames[i].data, link->frames[i].len, &view) == ESP_OK);
+    CHECK(beam_arq_receive(rx, &view, out_deliver, ack) == ESP_OK);
+
+    return 0;
+}
+
+/* Pass an ACK built by beam_arq_receive() to the sender */
+static int handle_ack(beam_arq_tx_t *tx, const beam_frame_buf_t *ack, int64_t now_us)
+{
+    beam_frame_view_t view;
+    CHECK(ack->len > 0);
+    CHECK(beam_parse_view(ack->data, ack->len, &view) == ESP_OK);
+    CHECK(beam_arq_handle_ack(tx, &view, now_us) == ESP_OK);
+
+    return 0;
+}
+
+/* The ACK of a delivered frame is lost while more than 32 best-effort frames follow */
+static int test_lost_ack_behind_best_effort(void)
+{
+    link_t link = {0};
+    beam_arq_tx_t tx;
+    beam_arq_rx_t rx;
+    beam_frame_buf_t frame;
+    beam_frame_buf_t ack;
+    bool delivered = false;
+    uint8_t seq = 0;
+
+    CHECK(beam_arq_tx_init(&tx, link_send, link_fail, &link) == ESP_OK);
+    CHECK(beam_arq_rx_init(&rx) == ESP_OK);
+
+    build_frame(&frame, MSG_FLAG_ACK_REQ, seq++);
+    CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+    CHECK(deliver(&link, 0, &rx, &delivered, &ack) == 0);
+    CHECK(delivered);
+    CHECK(ack.len > 0); // Dropped
+
+    for (size_t i = 1; i <= 40; i++) {
+        build_frame(&frame, 0, seq++);
+        CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+        CHECK(deliver(&link, i, &rx, &delivered, &ack) == 0);
+        CHECK(delivered);
+        CHECK(ack.len == 0);
+    }
+    CHECK(beam_arq_in_flight(&tx) == 1);
+
+    link.count = 0;
+    CHECK(beam_arq_poll(&tx, BEAM_ARQ_INITIAL_RTO_US) == ESP_OK);
+    CHECK(link.count == 1);
+    CHECK(deliver(&link, 0, &rx, &delivered, &ack) == 0);
+    CHECK(!delivered); // Duplicate of the first copy
+    CHECK(handle_ack(&tx, &ack, BEAM_ARQ_INITIAL_RTO_US) == 0);
+
+    CHECK(beam_arq_in_flight(&tx) == 0);
+    CHECK(tx.stats.acked == 1);
+    CHECK(link.failed == 0);
+
+    return 0;
+}
+
+/* A lost frame holds back the sequence span; its retransmission is still covered by one ACK */
+static int test_span_limited_to_window(void)
+{
+    link_t link = {0};
+    beam_arq_tx_t tx;
+    beam_arq_rx_t rx;
+    beam_frame_buf_t frame;
+    beam_frame_buf_t ack;
+    bool delivered = false;
+
+    CHECK(beam_arq_tx_init(&tx, link_send, link_fail, &link) == ESP_OK);
+    CHECK(beam_arq_rx_init(&rx) == ESP_OK);
+
+    // The first frame is lost; the next 31 get through and are acknowledged
+    build_frame(&frame, MSG_FLAG_ACK_REQ, 0);
+    CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+    for (size_t i = 1; i < BEAM_SEQ_WINDOW_SIZE; i++) {
+        link.count = 0;
+        CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+        CHECK(deliver(&link, 0, &rx, &delivered, &ack) == 0);
+        CHECK(delivered);
+        CHECK(handle_ack(&tx, &ack, 0) == 0);
+    }
+    CHECK(beam_arq_in_flight(&tx) == 1);
+
+    // One more would put the lost frame out of reach of the receiver's window
+    CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_ERR_NO_MEM);
+
+    link.count = 0;
+    CHECK(beam_arq_poll(&tx, BEAM_ARQ_INITIAL_RTO_US) == ESP_OK);
+    CHECK(deliver(&link, 0, &rx, &delivered, &ack) == 0);
+    CHECK(delivered);
+    CHECK(handle_ack(&tx, &ack, BEAM_ARQ_INITIAL_RTO_US) == 0);
+    CHECK(beam_arq_in_flight(&tx) == 0);
+    CHECK(beam_arq_send(&tx, frame.data, frame.len, BEAM_ARQ_INITIAL_RTO_US) == ESP_OK);
+
+    return 0;
+}
+
+/* beam_arq_send() renumbers reliable frames densely and keeps the CRC valid */
+static int test_reliable_frames_renumbered(void)
+{
+    link_t link = {0};
+    beam_arq_tx_t tx;
+    beam_frame_buf_t frame;
+    beam_frame_view_t view;
+
+    CHECK(beam_arq_tx_init(&tx, link_send, NULL, &link) == ESP_OK);
+
+    build_frame(&frame, MSG_FLAG_ACK_REQ, 100);
+    CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+    build_frame(&frame, 0, 101);
+    CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+    build_frame(&frame, MSG_FLAG_ACK_REQ, 102);
+    CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+
+    CHECK(link.count == 3);
+    CHECK(beam_parse_view(link.frames[0].data, link.frames[0].len, &view) == ESP_OK);
+    CHECK(beam_frame_view_seq(&view) == 0);
+    CHECK(beam_parse_view(link.frames[1].data, link.frames[1].len, &view) == ESP_OK);
+    CHECK(beam_frame_view_seq(&view) == 101);
+    CHECK(beam_parse_view(link.frames[2].data, link.frames[2].len, &view) == ESP_OK);
+    CHECK(beam_frame_view_seq(&view) == 1);
+    CHECK(beam_arq_tx_reset(&tx) == ESP_OK);
+
+    return 0;
+}
+
+/* Compact deltas still find their keyframe after beam_arq_send() renumbers both frames */
+static int test_compact_telemetry_renumbered(void)
+{
+    link_t link = {0};
+    beam_arq_tx_t tx;
+    beam_arq_rx_t rx;
+    beam_telemetry_encoder_t encoder;
+    beam_telemetry_decoder_t decoder;
+    const beam_payload_telemetry_t samples[2] = {{1.0f, 2.0f, 3.0f}, {1.5f, 2.0f, 2.5f}};
+
+    CHECK(beam_arq_tx_init(&tx, link_send, NULL, &link) == ESP_OK);
+    CHECK(beam_arq_rx_init(&rx) == ESP_OK);
+    CHECK(beam_telemetry_encoder_init(&encoder) == ESP_OK);
+    CHECK(beam_telemetry_decoder_init(&decoder) == ESP_OK);
+
+    for (size_t i = 0; i < 2; i++) {
+        uint8_t payload[BEAM_TELEMETRY_COMPACT_MAX_SIZE];
+        uint8_t len = 0;
+        beam_flags_t flags = 0;
+        CHECK(beam_telemetry_encode(&encoder, &samples[i], payload, &len, &flags) == ESP_OK);
+        CHECK(((flags & MSG_FLAG_DELTA) != 0) == (i == 1));
+
+        beam_frame_t compact;
+        beam_frame_buf_t frame;
+        size_t size = 0;
+        memset(&compact, 0, sizeof(compact));
+        compact.header.msg_category = MSG_CAT_TELEMETRY;
+        compact.header.flags = flags | MSG_FLAG_ACK_REQ;
+        compact.header.seq = 200;
+        compact.header.len = len;
+        memcpy(compact.payload.raw, payload, len);
+        CHECK(beam_serialize_frame(&compact, frame.data, sizeof(frame.data), &size) == ESP_OK);
+        CHECK(beam_arq_send(&tx, frame.data, size, 0) == ESP_OK);
+    }
+
+    CHECK(link.count == 2);
+    for (size_t i = 0; i < 2; i++) {
+        beam_frame_view_t view;
+        beam_frame_buf_t ack;
+        beam_payload_telemetry_t decoded;
+        bool delivered = false;
+        CHECK(beam_parse_view(link.frames[i].data, link.frames[i].len, &view) == ESP_OK);
+        CHECK(beam_frame_view_seq(&view) == i);
+        CHECK(beam_arq_receive(&rx, &view, &delivered, &ack) == ESP_OK);
+        CHECK(delivered);
+        CHECK(beam_telemetry_decode(&decoder, &view, &decoded) == ESP_OK);
+        CHECK(decoded.roll == samples[i].roll && decoded.pitch == samples[i].pitch && decoded.yaw == samples[i].yaw);
+    }
+    CHECK(beam_arq_tx_reset(&tx) == ESP_OK);
+
+    return 0;
+}
+
+/* An ACK for seq values never sent (an alias from an earlier wrap) releases nothing */
+static int test_aliased_ack_ignored(void)
+{
+    link_t link = {0};
+    beam_arq_tx_t tx;
+    beam_frame_buf_t frame;
+    beam_frame_buf_t ack;
+    beam_frame_builder_t builder;
+    size_t size = 0;
+
+    CHECK(beam_arq_tx_init(&tx, link_send, NULL, &link) == ESP_OK);
+    build_frame(&frame, MSG_FLAG_ACK_REQ, 0);
+    CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+
+    // ack_seq 5 with every bit set claims seq 0 among others, but only seq 0 was sent
+    beam_frame_begin_len(&builder, ack.data, sizeof(ack.data), MSG_CAT_ACK, 0, 5, BEAM_ARQ_ACK_PAYLOAD_SIZE);
+    beam_frame_put_u8(&builder, 5);
+    beam_frame_put_u32(&builder, UINT32_MAX);
+    beam_frame_finish(&builder, &size);
+    ack.len = (uint16_t)size;
+
+    CHECK(handle_ack(&tx, &ack, 0) == 0);
+    CHECK(beam_arq_in_flight(&tx) == 1);
+    CHECK(beam_arq_tx_reset(&tx) == ESP_OK);
+
+    return 0;
+}
+
+/* A reliable frame too far behind to classify is dropped unacknowledged and counted */
+static int test_stale_frame_dropped(void)
+{
+    beam_arq_rx_t rx;
+    beam_arq_rx_stats_t stats;
+    beam_frame_buf_t frame;
+    beam_frame_buf_t ack;
+    beam_frame_view_t view;
+    bool delivered = false;
+
+    CHECK(beam_arq_rx_init(&rx) == ESP_OK);
+
+    build_frame(&frame, MSG_FLAG_ACK_REQ, 100);
+    CHECK(beam_parse_view(frame.data, frame.len, &view) == ESP_OK);
+    CHECK(beam_arq_receive(&rx, &view, &delivered, &ack) == ESP_OK);
+    CHECK(delivered);
+
+    build_frame(&frame, MSG_FLAG_ACK_REQ, 100 - BEAM_SEQ_WINDOW_SIZE);
+    CHECK(beam_parse_view(frame.data, frame.len, &view) == ESP_OK);
+    CHECK(beam_arq_receive(&rx, &view, &delivered, &ack) == ESP_OK);
+    CHECK(!delivered);
+    CHECK(ack.len == 0);
+
+    CHECK(beam_arq_rx_get_stats(&rx, &stats) == ESP_OK);
+    CHECK(stats.stale == 1);
+    CHECK(stats.seq.received == 1);
+
+    return 0;
+}
+
+/* A sender that restarts counts from 0 again; the receiver resyncs and nothing fails */
+static int test_sender_restart_resyncs(void)
+{
+    link_t link = {0};
+    beam_arq_tx_t tx;
+    beam_arq_rx_t rx;
+    beam_arq_rx_stats_t stats;
+    beam_frame_buf_t frame;
+    beam_frame_buf_t ack;
+    beam_frame_view_t view;
+    bool delivered = false;
+    uint32_t delivered_mask = 0;
+    const size_t count = 5;
+
+    // The receiver's window sits at 100 from before the restart
+    CHECK(beam_arq_rx_init(&rx) == ESP_OK);
+    build_frame(&frame, MSG_FLAG_ACK_REQ, 100);
+    CHECK(beam_parse_view(frame.data, frame.len, &view) == ESP_OK);
+    CHECK(beam_arq_receive(&rx, &view, &delivered, &ack) == ESP_OK);
+
+    CHECK(beam_arq_tx_init(&tx, link_send, link_fail, &link) == ESP_OK);
+    for (size_t i = 0; i < count; i++) {
+        build_frame(&frame, MSG_FLAG_ACK_REQ, (uint8_t)i);
+        CHECK(beam_arq_send(&tx, frame.data, frame.len, 0) == ESP_OK);
+    }
+
+    int64_t now_us = 0;
+    for (int round = 0; round <= BEAM_ARQ_MAX_RETRIES && beam_arq_in_flight(&tx) > 0; round++) {
+        size_t sent = link.count;
+        for (size_t i = 0; i < sent; i++) {
+            CHECK(deliver(&link, i, &rx, &delivered, &ack) == 0);
+            if (delivered) {
+                uint8_t id = link.frames[i].data[FRAME_HEADER_SIZE];
+                CHECK(!(delivered_mask & (1u << id)));
+                delivered_mask |= 1u << id;
+            }
+            if (ack.len > 0) {
+                CHECK(handle_ack(&tx, &ack, now_us) == 0);
+            }
+        }
+        link.count = 0;
+        now_us += BEAM_ARQ_MAX_RTO_US;
+        CHECK(beam_arq_poll(&tx, now_us) == ESP_OK);
+    }
+
+    CHECK(beam_arq_in_flight(&tx) == 0);
+    CHECK(link.failed == 0);
+    CHECK(delivered_mask == (1u << count) - 1);
+    CHECK(beam_arq_rx_get_stats(&rx, &stats) == ESP_OK);
+    CHECK(stats.resyncs == 1);
+    CHECK(stats.stale == BEAM_ARQ_RESYNC_STALE - 1);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_lost_ack_behind_best_effort);
+    RUN_TEST(failures, test_span_limited_to_window);
+    RUN_TEST(failures, test_reliable_frames_renumbered);
+    RUN_TEST(failures, test_compact_telemetry_renumbered);
+    RUN_TEST(failures, test_aliased_ack_ignored);
+    RUN_TEST(failures, test_stale_frame_dropped);
+    RUN_TEST(failures, test_sender_restart_resyncs);
+
+    return failures == 0 ? 0 : 1;
+}
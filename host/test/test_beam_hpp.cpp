@@ -0,0 +1,94 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam.hpp: the C++17 layer builds warning-free and produces the wire format of the C API.
+ */
+
+#include "beam.hpp"
+#include "test_util.h"
+
+static_assert(beam::Frame<beam_payload_telemetry_t>::category == MSG_CAT_TELEMETRY, "telemetry category");
+static_assert(beam::Frame<beam_payload_battery_t>::payload_size == sizeof(beam_payload_battery_t), "battery size");
+static_assert(beam::Frame<beam_payload_telemetry_t>::wire_size == FRAME_SIZE(12), "telemetry wire size");
+
+/* serialize() writes what the C parser reads back */
+static int test_serialize_parse(void)
+{
+    beam::Frame<beam_payload_telemetry_t> frame;
+    frame.flags = MSG_FLAG_PRIORITY | MSG_FLAG_COMPACT | MSG_FLAG_EXT_TS;
+    frame.seq = 7;
+    frame.payload = {1.0f, 2.0f, -3.5f};
+
+    auto wire = beam::serialize(frame);
+    beam_frame_t parsed;
+    CHECK(beam_parse_into_frame(wire.data(), wire.size(), &parsed) == ESP_OK);
+    CHECK(parsed.header.msg_category == MSG_CAT_TELEMETRY);
+    CHECK(parsed.header.flags == MSG_FLAG_PRIORITY);
+    CHECK(parsed.header.seq == 7);
+    CHECK(parsed.payload.telemetry.yaw == -3.5f);
+
+    return 0;
+}
+
+/* View::parse() validates, and visit() calls only the overload of the frame's type */
+static int test_view_visit(void)
+{
+    beam::Frame<beam_payload_battery_t> frame;
+    frame.seq = 3;
+    frame.payload = {3700, 120, 88};
+    auto wire = beam::serialize(frame);
+
+    auto view = beam::View::parse(wire);
+    CHECK(view.has_value());
+    CHECK(view->category() == MSG_CAT_BATTERY);
+    CHECK(view->seq() == 3);
+    CHECK(view->payload().size() == sizeof(beam_payload_battery_t));
+    CHECK(view->wire().size() == wire.size());
+    CHECK(view->is<beam_payload_battery_t>());
+    CHECK(!view->as<beam_payload_telemetry_t>().has_value());
+
+    int telemetry_calls = 0;
+    std::uint8_t percent = 0;
+    struct visitor {
+        int &telemetry_calls;
+        std::uint8_t &percent;
+        void operator()(const beam_payload_telemetry_t &) const { telemetry_calls++; }
+        void operator()(const beam_payload_battery_t &battery) const { percent = battery.percent; }
+    };
+    CHECK(beam::visit(*view, visitor{telemetry_calls, percent}));
+    CHECK(telemetry_calls == 0);
+    CHECK(percent == 88);
+
+    // A visitor without a battery overload skips the frame
+    CHECK(!beam::visit(*view, [](const beam_payload_telemetry_t &) {}));
+
+    wire[wire.size() - 1] ^= 0xFF;
+    CHECK(!beam::View::parse(wire).has_value());
+    CHECK(!beam::View::parse({wire.data(), 2}).has_value());
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_serialize_parse);
+    RUN_TEST(failures, test_view_visit);
+
+    return failures == 0 ? 0 : 1;
+}
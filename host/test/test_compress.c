@@ -0,0 +1,184 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_compress: round trips over the payload shapes a frame can carry, and the
+ * serializer's fallback to the plain payload when compression does not pay off.
+ */
+
+#include "beam_compress.h"
+#include "beam_parser.h"
+#include "test_util.h"
+#include <string.h>
+
+/* Pseudo-random bytes (LCG): no repeats for the match finder to use */
+static void fill_random(uint8_t *buf, size_t len, uint32_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        buf[i] = (uint8_t)(seed >> 24);
+    }
+}
+
+/* Compress src with room to spare and check that it decompresses back; 0 on success */
+static int round_trip(const uint8_t *src, size_t len, size_t *out_packed)
+{
+    uint8_t packed[2 * MAX_PAYLOAD_SIZE];
+    uint8_t unpacked[MAX_PAYLOAD_SIZE];
+    size_t packed_len = 0;
+    size_t unpacked_len = 0;
+
+    CHECK(beam_compress(src, len, packed, sizeof(packed), &packed_len) == ESP_OK);
+    CHECK(beam_decompress(packed, packed_len, unpacked, sizeof(unpacked), &unpacked_len) == ESP_OK);
+    CHECK(unpacked_len == len);
+    CHECK(len == 0 || memcmp(unpacked, src, len) == 0);
+    *out_packed = packed_len;
+
+    return 0;
+}
+
+static int test_round_trips(void)
+{
+    uint8_t data[MAX_PAYLOAD_SIZE] = {0};
+    size_t packed = 0;
+
+    CHECK(round_trip(data, 0, &packed) == 0);
+    CHECK(packed <= 1);
+
+    memset(data, 0x5A, sizeof(data));
+    CHECK(round_trip(data, sizeof(data), &packed) == 0);
+    CHECK(packed < sizeof(data) / 8);
+
+    fill_random(data, sizeof(data), 1);
+    CHECK(round_trip(data, sizeof(data), &packed) == 0);
+    CHECK(packed > sizeof(data));
+
+    // Text-like: repeats at several distances, up to the largest payload
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)("beam telemetry "[i % 15] + (i / 60));
+    }
+    for (size_t len = 1; len <= sizeof(data); len++) {
+        CHECK(round_trip(data, len, &packed) == 0);
+    }
+
+    CHECK(beam_compress(data, MAX_PAYLOAD_SIZE + 1, data, sizeof(data), &packed) == ESP_ERR_INVALID_SIZE);
+
+    return 0;
+}
+
+/* dst_cap = src_len - 1 rejects output that would not be shorter */
+static int test_incompressible_rejected(void)
+{
+    uint8_t data[MAX_PAYLOAD_SIZE];
+    uint8_t packed[MAX_PAYLOAD_SIZE];
+    size_t packed_len = 0;
+
+    fill_random(data, sizeof(data), 7);
+    CHECK(beam_compress(data, sizeof(data), packed, sizeof(data) - 1, &packed_len) == ESP_ERR_INVALID_SIZE);
+
+    memset(data, 0, sizeof(data));
+    CHECK(beam_compress(data, sizeof(data), packed, sizeof(data) - 1, &packed_len) == ESP_OK);
+
+    return 0;
+}
+
+/* Serialize with MSG_FLAG_COMPRESSED; return the wire size and whether the flag stayed set */
+static int serialize_compressed(const uint8_t *payload, uint8_t len, uint8_t *wire, size_t *wire_len, bool *compressed)
+{
+    beam_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.header.msg_category = 0x42;
+    frame.header.flags = MSG_FLAG_COMPRESSED;
+    frame.header.len = len;
+    memcpy(frame.payload.raw, payload, len);
+
+    CHECK(beam_serialize_frame(&frame, wire, FRAME_MAX_SIZE, wire_len) == ESP_OK);
+    *compressed = (wire[FRAME_OFFSET_FLAGS] & MSG_FLAG_COMPRESSED) != 0;
+
+    beam_frame_t parsed;
+    CHECK(beam_parse_into_frame(wire, *wire_len, &parsed) == ESP_OK);
+    CHECK(parsed.header.flags == 0);
+    CHECK(parsed.header.len == len);
+    CHECK(memcmp(parsed.payload.raw, payload, len) == 0);
+
+    beam_frame_view_t view;
+    uint8_t out[MAX_PAYLOAD_SIZE];
+    size_t out_len = 0;
+    CHECK(beam_parse_view(wire, *wire_len, &view) == ESP_OK);
+    CHECK(beam_decompress_view(&view, out, sizeof(out), &out_len) == ESP_OK);
+    CHECK(out_len == len);
+    CHECK(memcmp(out, payload, len) == 0);
+
+    return 0;
+}
+
+/* The serializer sends incompressible and empty payloads as they are, with the flag cleared */
+static int test_serializer_fallback(void)
+{
+    uint8_t payload[MAX_PAYLOAD_SIZE];
+    uint8_t wire[FRAME_MAX_SIZE];
+    size_t wire_len = 0;
+    bool compressed = false;
+
+    fill_random(payload, sizeof(payload), 3);
+    CHECK(serialize_compressed(payload, MAX_PAYLOAD_SIZE, wire, &wire_len, &compressed) == 0);
+    CHECK(!compressed);
+    CHECK(wire_len == FRAME_MAX_SIZE);
+    CHECK(memcmp(wire + FRAME_HEADER_SIZE, payload, sizeof(payload)) == 0);
+
+    CHECK(serialize_compressed(payload, 0, wire, &wire_len, &compressed) == 0);
+    CHECK(!compressed);
+    CHECK(wire_len == FRAME_MIN_SIZE);
+
+    memset(payload, 0xEE, sizeof(payload));
+    CHECK(serialize_compressed(payload, MAX_PAYLOAD_SIZE, wire, &wire_len, &compressed) == 0);
+    CHECK(compressed);
+    CHECK(wire_len < FRAME_MAX_SIZE / 4);
+
+    return 0;
+}
+
+/* Streams from the air that end early or point before the output are rejected */
+static int test_malformed_rejected(void)
+{
+    uint8_t out[MAX_PAYLOAD_SIZE];
+    size_t out_len = 0;
+
+    static const uint8_t truncated_literals[] = {0x30, 'a'};
+    CHECK(beam_decompress(truncated_literals, sizeof(truncated_literals), out, sizeof(out), &out_len) ==
+          ESP_ERR_INVALID_SIZE);
+
+    static const uint8_t offset_before_start[] = {0x10, 'a', 2, 0x00};
+    CHECK(beam_decompress(offset_before_start, sizeof(offset_before_start), out, sizeof(out), &out_len) ==
+          ESP_ERR_INVALID_SIZE);
+
+    static const uint8_t run[] = {0x1F, 'a', 1, 0xFF, 0xFF, 0x00};
+    CHECK(beam_decompress(run, sizeof(run), out, 16, &out_len) == ESP_ERR_INVALID_SIZE);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_round_trips);
+    RUN_TEST(failures, test_incompressible_rejected);
+    RUN_TEST(failures, test_serializer_fallback);
+    RUN_TEST(failures, test_malformed_rejected);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_frag over beam_arq: a multi-fragment message crosses a simulated link that drops,
+ * reorders and delays frames and ACKs, with best-effort traffic in between.
+ */
+
+#include "beam_arq.h"
+#include "beam_frag.h"
+#include "beam_frame_builder.h"
+#include "beam_message_common.h"
+#include "beam_parser.h"
+#include "beam_pool.h"
+#include "test_util.h"
+#include <string.h>
+
+#define LINK_CAPACITY 32         /**< Frames the simulated link holds per round */
+#define MESSAGE_SIZE 900         /**< Five fragments */
+#define ROUND_US 50000           /**< Simulated time per round, half the initial RTO */
+#define BEST_EFFORT_PER_ROUND 40 /**< Best-effort frames interleaved each round */
+#define MAX_ROUNDS 40            /**< Give up after this many rounds */
+
+/* Frames handed to the ARQ send callback since the last drain */
+typedef struct link {
+    beam_frame_buf_t frames[LINK_CAPACITY];
+    size_t count;
+} link_t;
+
+/* Both ends of one direction, plus what the receiver got */
+typedef struct session {
+    link_t link;
+    beam_arq_tx_t arq_tx;
+    beam_arq_rx_t arq_rx;
+    beam_frag_tx_t frag_tx;
+    beam_frag_rx_t frag_rx;
+    uint8_t received[MESSAGE_SIZE];
+    size_t received_len;
+    uint32_t failed;
+    uint8_t sends[BEAM_FRAG_MAX_FRAGMENTS]; /**< Transmissions seen per fragment index */
+} session_t;
+
+static session_t s_session;
+
+static esp_err_t link_send(const uint8_t *frame, size_t frame_len, void *ctx)
+{
+    link_t *link = &((session_t *)ctx)->link;
+    if (link->count == LINK_CAPACITY) {
+        return ESP_FAIL;
+    }
+
+    memcpy(link->frames[link->count].data, frame, frame_len);
+    link->frames[link->count].len = (uint16_t)frame_len;
+    link->count++;
+
+    return ESP_OK;
+}
+
+static void link_fail(uint8_t seq, void *ctx)
+{
+    (void)seq;
+    ((session_t *)ctx)->failed++;
+}
+
+static void on_message(const beam_frag_message_t *message, void *ctx)
+{
+    session_t *session = ctx;
+    if (beam_frag_message_copy(message, session->received, sizeof(session->received)) == ESP_OK) {
+        session->received_len = message->len;
+    }
+}
+
+/* Receiver side of one frame; drop_ack loses the ACK it produces */
+static int receive(session_t *session, const beam_frame_buf_t *frame, bool drop_ack, int64_t now_us)
+{
+    beam_frame_view_t view;
+    beam_frame_buf_t ack;
+    bool deliver = false;
+
+    CHECK(beam_parse_view(frame->data, frame->len, &view) == ESP_OK);
+    CHECK(beam_arq_receive(&session->arq_rx, &view, &deliver, &ack) == ESP_OK);
+    if (deliver && beam_frame_view_category(&view) == MSG_CAT_FRAGMENT) {
+        CHECK(beam_frag_rx_handle(&session->frag_rx, &view, now_us) == ESP_OK);
+    }
+    if (ack.len > 0 && !drop_ack) {
+        CHECK(beam_parse_view(ack.data, ack.len, &view) == ESP_OK);
+        CHECK(beam_arq_handle_ack(&session->arq_tx, &view, now_us) == ESP_OK);
+    }
+
+    return 0;
+}
+
+/* A best-effort frame the receiver sees between fragments */
+static int receive_best_effort(session_t *session, uint8_t seq, int64_t now_us)
+{
+    beam_frame_builder_t builder;
+    beam_frame_buf_t frame;
+    size_t size = 0;
+
+    beam_frame_begin_len(&builder, frame.data, sizeof(frame.data), MSG_CAT_BATTERY, 0, seq, 1);
+    beam_frame_put_u8(&builder, seq);
+    beam_frame_finish(&builder, &size);
+    frame.len = (uint16_t)size;
+
+    return receive(session, &frame, false, now_us);
+}
+
+static int session_init(session_t *session)
+{
+    memset(session, 0, sizeof(*session));
+    CHECK(beam_arq_tx_init(&session->arq_tx, link_send, link_fail, session) == ESP_OK);
+    CHECK(beam_arq_rx_init(&session->arq_rx) == ESP_OK);
+    CHECK(beam_frag_tx_init(&session->frag_tx) == ESP_OK);
+    CHECK(beam_frag_rx_init(&session->frag_rx, on_message, session) == ESP_OK);
+
+    return 0;
+}
+
+static int pool_in_use(void)
+{
+    beam_pool_stats_t stats;
+    beam_pool_get_stats(&stats);
+
+    return stats.in_use;
+}
+
+/*
+ * Fragment 1 is lost on its first transmission and the ACKs of the others are lost, so
+ * all are retransmitted after more than 32 best-effort frames. Each round is delivered
+ * in reverse order.
+ */
+static int test_reassembly_with_loss_and_reordering(void)
+{
+    session_t *session = &s_session;
+    uint8_t message[MESSAGE_SIZE];
+    uint8_t best_effort_seq = 0;
+    int64_t now_us = 0;
+
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t)(i * 7 + 3);
+    }
+    CHECK(session_init(session) == 0);
+    CHECK(beam_frag_tx_start(&session->frag_tx, MSG_CAT_TELEMETRY, message, sizeof(message)) == ESP_OK);
+
+    for (int round = 0; round < MAX_ROUNDS && session->received_len == 0; round++) {
+        esp_err_t err = beam_frag_tx_pump(&session->frag_tx, &session->arq_tx, now_us);
+        CHECK(err == ESP_OK || err == ESP_ERR_NOT_FINISHED);
+
+        for (size_t i = session->link.count; i-- > 0;) {
+            const beam_frame_buf_t *frame = &session->link.frames[i];
+            uint8_t index = frame->data[FRAME_HEADER_SIZE + 2];
+            uint8_t sends = session->sends[index]++;
+            if (index == 1 && sends == 0) {
+                continue;
+            }
+            CHECK(receive(session, frame, sends == 0, now_us) == 0);
+        }
+        session->link.count = 0;
+
+        for (int i = 0; i < BEST_EFFORT_PER_ROUND; i++) {
+            CHECK(receive_best_effort(session, best_effort_seq++, now_us) == 0);
+        }
+
+        now_us += ROUND_US;
+        CHECK(beam_arq_poll(&session->arq_tx, now_us) == ESP_OK);
+        CHECK(beam_frag_rx_poll(&session->frag_rx, now_us) == ESP_OK);
+    }
+
+    CHECK(session->received_len == sizeof(message));
+    CHECK(memcmp(session->received, message, sizeof(message)) == 0);
+    CHECK(session->frag_rx.stats.completed == 1);
+    CHECK(session->frag_rx.stats.timeouts == 0);
+    for (size_t i = 0; i < session->frag_tx.count; i++) {
+        CHECK(session->sends[i] >= 2);
+    }
+
+    // Drain retransmissions still in flight, if any
+    for (int round = 0; round < MAX_ROUNDS && beam_arq_in_flight(&session->arq_tx) > 0; round++) {
+        for (size_t i = 0; i < session->link.count; i++) {
+            CHECK(receive(session, &session->link.frames[i], false, now_us) == 0);
+        }
+        session->link.count = 0;
+        now_us += ROUND_US;
+        CHECK(beam_arq_poll(&session->arq_tx, now_us) == ESP_OK);
+    }
+    CHECK(beam_arq_in_flight(&session->arq_tx) == 0);
+    CHECK(session->failed == 0);
+    CHECK(session->frag_rx.stats.completed == 1);
+    CHECK(pool_in_use() == 0);
+
+    return 0;
+}
+
+/* A fragment that never arrives times the reassembly out and returns its buffers */
+static int test_incomplete_message_times_out(void)
+{
+    session_t *session = &s_session;
+    uint8_t message[MESSAGE_SIZE] = {0};
+
+    CHECK(session_init(session) == 0);
+    CHECK(beam_frag_tx_start(&session->frag_tx, MSG_CAT_TELEMETRY, message, sizeof(message)) == ESP_OK);
+    CHECK(beam_frag_tx_pump(&session->frag_tx, &session->arq_tx, 0) == ESP_OK);
+
+    for (size_t i = 1; i < session->link.count; i++) {
+        CHECK(receive(session, &session->link.frames[i], false, 0) == 0);
+    }
+    session->link.count = 0;
+    CHECK(pool_in_use() > 0);
+
+    CHECK(beam_frag_rx_poll(&session->frag_rx, BEAM_FRAG_TIMEOUT_US) == ESP_OK);
+    CHECK(session->frag_rx.stats.timeouts == 1);
+    CHECK(session->received_len == 0);
+
+    CHECK(beam_arq_tx_reset(&session->arq_tx) == ESP_OK);
+    CHECK(pool_in_use() == 0);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_reassembly_with_loss_and_reordering);
+    RUN_TEST(failures, test_incomplete_message_times_out);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_frame_builder: a MSG_FLAG_EXT_TS frame is only finished once its timestamp
+ * came from beam_frame_put_timestamp(), and payload encoding flags are rejected.
+ */
+
+#include "beam_frame_builder.h"
+#include "beam_frame_view.h"
+#include "beam_parser.h"
+#include "test_util.h"
+
+static int test_timestamp_then_payload(void)
+{
+    uint8_t buf[FRAME_MAX_SIZE];
+    beam_frame_builder_t builder;
+    size_t n = 0;
+
+    CHECK(beam_frame_begin(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, MSG_FLAG_EXT_TS, 1) == ESP_OK);
+    CHECK(beam_frame_put_timestamp(&builder, 1234) == ESP_OK);
+    CHECK(beam_frame_put_timestamp(&builder, 1234) == ESP_ERR_INVALID_STATE);
+    CHECK(beam_frame_put_u8(&builder, 9) == ESP_OK);
+    CHECK(beam_frame_finish(&builder, &n) == ESP_OK);
+
+    beam_frame_view_t view;
+    CHECK(beam_parse_view(buf, n, &view) == ESP_OK);
+    CHECK(beam_frame_view_timestamp(&view) == 1234);
+    CHECK(beam_frame_view_payload_len(&view) == 1);
+    CHECK(beam_frame_view_payload(&view)[0] == 9);
+
+    return 0;
+}
+
+/* Four payload bytes are not a timestamp, even though they fill its place */
+static int test_payload_without_timestamp_rejected(void)
+{
+    uint8_t buf[FRAME_MAX_SIZE];
+    beam_frame_builder_t builder;
+
+    CHECK(beam_frame_begin(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, MSG_FLAG_EXT_TS, 1) == ESP_OK);
+    CHECK(beam_frame_put_u32(&builder, 0xDEADBEEFu) == ESP_OK);
+    CHECK(beam_frame_put_timestamp(&builder, 1) == ESP_ERR_INVALID_STATE);
+    CHECK(beam_frame_finish(&builder, NULL) == ESP_ERR_INVALID_STATE);
+
+    CHECK(beam_frame_begin_len(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, MSG_FLAG_EXT_TS, 1, 4) == ESP_OK);
+    CHECK(beam_frame_put_u32(&builder, 0xDEADBEEFu) == ESP_OK);
+    CHECK(beam_frame_finish(&builder, NULL) == ESP_ERR_INVALID_STATE);
+
+    // A reused builder does not keep the timestamp of the previous frame
+    CHECK(beam_frame_begin(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, MSG_FLAG_EXT_TS, 2) == ESP_OK);
+    CHECK(beam_frame_put_timestamp(&builder, 1) == ESP_OK);
+    CHECK(beam_frame_finish(&builder, NULL) == ESP_OK);
+    CHECK(beam_frame_begin(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, MSG_FLAG_EXT_TS, 3) == ESP_OK);
+    CHECK(beam_frame_put_u32(&builder, 0) == ESP_OK);
+    CHECK(beam_frame_finish(&builder, NULL) == ESP_ERR_INVALID_STATE);
+
+    return 0;
+}
+
+/* The builder copies payload bytes verbatim, so it cannot honour a payload encoding flag */
+static int test_encoding_flags_rejected(void)
+{
+    uint8_t buf[FRAME_MAX_SIZE];
+    beam_frame_builder_t builder;
+    const beam_flags_t rejected[] = {MSG_FLAG_COMPACT, MSG_FLAG_DELTA, MSG_FLAG_COMPRESSED};
+
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+        beam_flags_t flags = rejected[i] | MSG_FLAG_PRIORITY;
+        CHECK(beam_frame_begin(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, flags, 1) == ESP_ERR_INVALID_ARG);
+        CHECK(beam_frame_begin_len(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, flags, 1, 2) == ESP_ERR_INVALID_ARG);
+    }
+
+    beam_flags_t accepted = MSG_FLAG_PRIORITY | MSG_FLAG_ACK_REQ | MSG_FLAG_EXT_TS;
+    CHECK(beam_frame_begin(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, accepted, 1) == ESP_OK);
+    CHECK(beam_frame_begin_len(&builder, buf, sizeof(buf), MSG_CAT_TELEMETRY, accepted, 1, 2) == ESP_OK);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_timestamp_then_payload);
+    RUN_TEST(failures, test_payload_without_timestamp_rejected);
+    RUN_TEST(failures, test_encoding_flags_rejected);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_gateway: per-peer deduplication, queueing and round-robin service.
+ */
+
+#include "beam_frame_builder.h"
+#include "beam_gateway.h"
+#include "beam_message_common.h"
+#include "test_util.h"
+#include <string.h>
+
+#define MAX_HANDLED 32 /**< Frames the handler records per test */
+
+static const uint8_t s_mac_a[BEAM_MAC_LEN] = {0x02, 0, 0, 0, 0, 0xA};
+static const uint8_t s_mac_b[BEAM_MAC_LEN] = {0x02, 0, 0, 0, 0, 0xB};
+
+static beam_gateway_t s_gw;
+
+/* What the handler saw, in order */
+typedef struct handled {
+    uint8_t peer[MAX_HANDLED]; /**< Last MAC byte */
+    uint8_t seq[MAX_HANDLED];
+    size_t count;
+} handled_t;
+
+static void on_frame(const uint8_t *mac, const beam_frame_view_t *view, void *ctx)
+{
+    handled_t *handled = ctx;
+    if (handled->count < MAX_HANDLED) {
+        handled->peer[handled->count] = mac[BEAM_MAC_LEN - 1];
+        handled->seq[handled->count] = beam_frame_view_seq(view);
+        handled->count++;
+    }
+}
+
+/* Build a frame and pass it to beam_gateway_receive() */
+static esp_err_t receive(const uint8_t *mac, beam_msg_category_t category, beam_flags_t flags, uint8_t seq)
+{
+    beam_frame_builder_t builder;
+    uint8_t frame[FRAME_MAX_SIZE];
+    size_t size = 0;
+
+    beam_frame_begin_len(&builder, frame, sizeof(frame), category, flags, seq, 1);
+    beam_frame_put_u8(&builder, seq);
+    beam_frame_finish(&builder, &size);
+
+    return beam_gateway_receive(&s_gw, mac, frame, size, 0);
+}
+
+/* Best-effort duplicates are dropped; reliable frames and ACKs pass for beam_arq_receive() */
+static int test_duplicates(void)
+{
+    beam_gateway_peer_stats_t stats;
+    handled_t handled = {0};
+
+    CHECK(beam_gateway_init(&s_gw) == ESP_OK);
+    CHECK(receive(s_mac_a, MSG_CAT_BATTERY, 0, 7) == ESP_OK);
+    CHECK(receive(s_mac_a, MSG_CAT_BATTERY, 0, 7) == ESP_ERR_INVALID_STATE);
+    CHECK(receive(s_mac_a, MSG_CAT_BATTERY, MSG_FLAG_ACK_REQ, 7) == ESP_OK);
+    CHECK(receive(s_mac_a, MSG_CAT_ACK, 0, 7) == ESP_OK);
+
+    CHECK(beam_gateway_get_peer_stats(&s_gw, s_mac_a, &stats) == ESP_OK);
+    CHECK(stats.queued == 3);
+    CHECK(stats.seq.received == 2);
+    CHECK(stats.seq.duplicates == 1);
+
+    CHECK(beam_gateway_process(&s_gw, on_frame, &handled, MAX_HANDLED, NULL) == ESP_OK);
+    CHECK(handled.count == 3);
+
+    return 0;
+}
+
+/* A full queue drops the frame without marking its seq as seen */
+static int test_queue_full(void)
+{
+    beam_gateway_peer_stats_t stats;
+    handled_t handled = {0};
+    uint8_t seq = 0;
+
+    CHECK(beam_gateway_init(&s_gw) == ESP_OK);
+    while (receive(s_mac_a, MSG_CAT_BATTERY, 0, seq) == ESP_OK) {
+        seq++;
+        CHECK(seq <= BEAM_GATEWAY_QUEUE_DEPTH);
+    }
+    CHECK(beam_gateway_get_peer_stats(&s_gw, s_mac_a, &stats) == ESP_OK);
+    CHECK(stats.queue_full == 1);
+
+    CHECK(beam_gateway_process(&s_gw, on_frame, &handled, MAX_HANDLED, NULL) == ESP_OK);
+    CHECK(handled.count == seq);
+    CHECK(receive(s_mac_a, MSG_CAT_BATTERY, 0, seq) == ESP_OK);
+
+    return 0;
+}
+
+/* Peers are served one frame each in turn, and max_frames carries over between calls */
+static int test_round_robin(void)
+{
+    handled_t handled = {0};
+    size_t count = 0;
+
+    CHECK(beam_gateway_init(&s_gw) == ESP_OK);
+    for (uint8_t seq = 0; seq < 3; seq++) {
+        CHECK(receive(s_mac_a, MSG_CAT_BATTERY, 0, seq) == ESP_OK);
+    }
+    CHECK(receive(s_mac_b, MSG_CAT_BATTERY, 0, 0) == ESP_OK);
+
+    CHECK(beam_gateway_process(&s_gw, on_frame, &handled, 1, &count) == ESP_OK);
+    CHECK(count == 1);
+    CHECK(beam_gateway_process(&s_gw, on_frame, &handled, MAX_HANDLED, &count) == ESP_OK);
+    CHECK(count == 3);
+
+    const uint8_t peers[] = {0xA, 0xB, 0xA, 0xA};
+    CHECK(handled.count == sizeof(peers));
+    CHECK(memcmp(handled.peer, peers, sizeof(peers)) == 0);
+
+    return 0;
+}
+
+/* A removed peer starts over with fresh sequence state */
+static int test_remove_peer(void)
+{
+    beam_gateway_peer_stats_t stats;
+
+    CHECK(beam_gateway_init(&s_gw) == ESP_OK);
+    CHECK(receive(s_mac_a, MSG_CAT_BATTERY, 0, 1) == ESP_OK);
+    CHECK(receive(s_mac_b, MSG_CAT_BATTERY, 0, 1) == ESP_OK);
+    CHECK(beam_gateway_remove_peer(&s_gw, s_mac_a) == ESP_OK);
+    CHECK(beam_gateway_get_peer_stats(&s_gw, s_mac_a, &stats) == ESP_ERR_NOT_FOUND);
+    CHECK(beam_gateway_get_peer_stats(&s_gw, s_mac_b, &stats) == ESP_OK);
+
+    CHECK(receive(s_mac_a, MSG_CAT_BATTERY, 0, 1) == ESP_OK);
+    CHECK(beam_gateway_get_peer_stats(&s_gw, s_mac_a, &stats) == ESP_OK);
+    CHECK(stats.seq.received == 1);
+    CHECK(stats.seq.duplicates == 0);
+
+    return 0;
+}
+
+/* Slots of the hash table in use */
+static size_t used_slots(void)
+{
+    size_t used = 0;
+    for (size_t i = 0; i < BEAM_GATEWAY_TABLE_SIZE; i++) {
+        used += s_gw.table[i].state != 0;
+    }
+
+    return used;
+}
+
+/* Removing and adding peers for a long time leaves no dead slots, and every peer stays reachable */
+static int test_peer_churn(void)
+{
+    beam_gateway_peer_stats_t stats;
+    uint8_t mac[BEAM_MAC_LEN] = {0x02, 0, 0, 0, 0, 0};
+
+    CHECK(beam_gateway_init(&s_gw) == ESP_OK);
+    for (uint16_t id = 0; id < 2000; id++) {
+        // Keep a window of BEAM_GATEWAY_MAX_PEERS peers: add id, remove the oldest
+        mac[3] = (uint8_t)(id >> 8);
+        mac[4] = (uint8_t)id;
+        CHECK(receive(mac, MSG_CAT_BATTERY, 0, 0) == ESP_OK);
+        if (id >= BEAM_GATEWAY_MAX_PEERS - 1) {
+            uint16_t oldest = (uint16_t)(id - (BEAM_GATEWAY_MAX_PEERS - 1));
+            mac[3] = (uint8_t)(oldest >> 8);
+            mac[4] = (uint8_t)oldest;
+            CHECK(beam_gateway_remove_peer(&s_gw, mac) == ESP_OK);
+            CHECK(beam_gateway_get_peer_stats(&s_gw, mac, &stats) == ESP_ERR_NOT_FOUND);
+        }
+        CHECK(used_slots() == (id < BEAM_GATEWAY_MAX_PEERS - 1 ? id + 1u : BEAM_GATEWAY_MAX_PEERS - 1u));
+    }
+
+    for (uint16_t id = 2000 - (BEAM_GATEWAY_MAX_PEERS - 1); id < 2000; id++) {
+        mac[3] = (uint8_t)(id >> 8);
+        mac[4] = (uint8_t)id;
+        CHECK(beam_gateway_get_peer_stats(&s_gw, mac, &stats) == ESP_OK);
+        CHECK(stats.seq.received == 1);
+    }
+    CHECK(s_gw.table_full == 0);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_duplicates);
+    RUN_TEST(failures, test_queue_full);
+    RUN_TEST(failures, test_round_robin);
+    RUN_TEST(failures, test_remove_peer);
+    RUN_TEST(failures, test_peer_churn);
+
+    return failures == 0 ? 0 : 1;
+}
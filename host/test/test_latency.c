@@ -0,0 +1,129 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_latency: samples land in the histogram of their category and stage, and frames
+ * are marked against their MSG_FLAG_EXT_TS timestamp. Built twice, with and without
+ * CONFIG_BEAM_LATENCY_TRACE; without it every call reports ESP_ERR_NOT_SUPPORTED.
+ */
+
+#include "beam_frame_builder.h"
+#include "beam_latency.h"
+#include "beam_parser.h"
+#include "test_util.h"
+
+static size_t build_frame(uint8_t *buf, size_t size, beam_flags_t flags, uint32_t timestamp_us)
+{
+    beam_frame_builder_t builder;
+    size_t n = 0;
+
+    if (beam_frame_begin(&builder, buf, size, MSG_CAT_TELEMETRY, flags, 0) != ESP_OK) {
+        return 0;
+    }
+    if ((flags & MSG_FLAG_EXT_TS) && beam_frame_put_timestamp(&builder, timestamp_us) != ESP_OK) {
+        return 0;
+    }
+    if (beam_frame_put_u8(&builder, 1) != ESP_OK || beam_frame_finish(&builder, &n) != ESP_OK) {
+        return 0;
+    }
+
+    return n;
+}
+
+#if CONFIG_BEAM_LATENCY_TRACE
+
+static int test_record_percentiles(void)
+{
+    beam_latency_summary_t summary;
+
+    beam_latency_reset();
+    for (uint32_t i = 1; i <= 100; i++) {
+        CHECK(beam_latency_record(MSG_CAT_TELEMETRY, BEAM_LATENCY_STAGE_DISPATCH, i) == ESP_OK);
+    }
+
+    CHECK(beam_latency_get(MSG_CAT_TELEMETRY, BEAM_LATENCY_STAGE_DISPATCH, &summary) == ESP_OK);
+    CHECK(summary.count == 100);
+    CHECK(summary.max_us == 100);
+    // Percentiles are bucket upper edges: never below the true value, at most 25 % above
+    CHECK(summary.p50_us >= 50 && summary.p50_us <= 63);
+    CHECK(summary.p99_us >= 99 && summary.p99_us <= 100);
+
+    CHECK(beam_latency_get(MSG_CAT_TELEMETRY, BEAM_LATENCY_STAGE_RX, &summary) == ESP_OK);
+    CHECK(summary.count == 0);
+    CHECK(beam_latency_get(MSG_CAT_BATTERY, BEAM_LATENCY_STAGE_RX, &summary) == ESP_ERR_NOT_FOUND);
+    CHECK(beam_latency_record(MSG_CAT_TELEMETRY, BEAM_LATENCY_STAGE_COUNT, 1) == ESP_ERR_INVALID_ARG);
+
+    return 0;
+}
+
+static int test_mark_uses_timestamp(void)
+{
+    uint8_t buf[FRAME_MAX_SIZE];
+    beam_frame_view_t view;
+    beam_latency_summary_t summary;
+
+    beam_latency_reset();
+    size_t n = build_frame(buf, sizeof(buf), MSG_FLAG_EXT_TS, 1000);
+    CHECK(beam_parse_view(buf, n, &view) == ESP_OK);
+    CHECK(beam_latency_mark(&view, BEAM_LATENCY_STAGE_VALIDATE, 1040) == ESP_OK);
+    // A receiver clock behind the sender counts as 0
+    CHECK(beam_latency_mark(&view, BEAM_LATENCY_STAGE_VALIDATE, 900) == ESP_OK);
+
+    CHECK(beam_latency_get(MSG_CAT_TELEMETRY, BEAM_LATENCY_STAGE_VALIDATE, &summary) == ESP_OK);
+    CHECK(summary.count == 2);
+    CHECK(summary.max_us == 40);
+
+    n = build_frame(buf, sizeof(buf), 0, 0);
+    CHECK(beam_parse_view(buf, n, &view) == ESP_OK);
+    CHECK(beam_latency_mark(&view, BEAM_LATENCY_STAGE_VALIDATE, 1040) == ESP_ERR_NOT_FOUND);
+
+    return 0;
+}
+
+#else
+
+static int test_disabled(void)
+{
+    uint8_t buf[FRAME_MAX_SIZE];
+    beam_frame_view_t view;
+    beam_latency_summary_t summary;
+
+    size_t n = build_frame(buf, sizeof(buf), MSG_FLAG_EXT_TS, 1000);
+    CHECK(beam_parse_view(buf, n, &view) == ESP_OK);
+
+    CHECK(beam_latency_record(MSG_CAT_TELEMETRY, BEAM_LATENCY_STAGE_RX, 1) == ESP_ERR_NOT_SUPPORTED);
+    CHECK(beam_latency_mark(&view, BEAM_LATENCY_STAGE_RX, 1040) == ESP_ERR_NOT_SUPPORTED);
+    CHECK(beam_latency_get(MSG_CAT_TELEMETRY, BEAM_LATENCY_STAGE_RX, &summary) == ESP_ERR_NOT_SUPPORTED);
+    CHECK(summary.count == 0);
+
+    return 0;
+}
+
+#endif /* CONFIG_BEAM_LATENCY_TRACE */
+
+int main(void)
+{
+    int failures = 0;
+
+#if CONFIG_BEAM_LATENCY_TRACE
+    RUN_TEST(failures, test_record_percentiles);
+    RUN_TEST(failures, test_mark_uses_timestamp);
+#else
+    RUN_TEST(failures, test_disabled);
+#endif
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_parser: MSG_FLAG_EXT_TS timestamps travel outside beam_frame_t, and every
+ * header.len the parser reports leaves them out. Compact telemetry arrives as floats.
+ */
+
+#include <string.h>
+
+#include "beam_parser.h"
+#include "test_util.h"
+
+static size_t build_timestamped(uint8_t *buf, size_t size, uint32_t timestamp_us)
+{
+    beam_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.header.msg_category = MSG_CAT_TELEMETRY;
+    frame.header.flags = MSG_FLAG_EXT_TS;
+    frame.header.seq = 3;
+    frame.header.len = sizeof(frame.payload.telemetry);
+    frame.payload.telemetry.roll = 1.5f;
+
+    size_t n = 0;
+    if (beam_serialize_frame_ts(&frame, timestamp_us, buf, size, &n) != ESP_OK) {
+        return 0;
+    }
+
+    return n;
+}
+
+/* The struct stays the wire layout: header, largest payload, CRC */
+static int test_frame_matches_wire_size(void)
+{
+    CHECK(sizeof(beam_frame_t) == FRAME_MAX_SIZE);
+
+    return 0;
+}
+
+static int test_timestamp_round_trip(void)
+{
+    uint8_t buf[FRAME_MAX_SIZE];
+    size_t n = build_timestamped(buf, sizeof(buf), 0xA1B2C3D4u);
+    CHECK(n == FRAME_SIZE(sizeof(beam_payload_telemetry_t) + FRAME_EXT_TS_SIZE));
+    CHECK(buf[FRAME_OFFSET_TS] == 0xD4 && buf[FRAME_OFFSET_TS + 3] == 0xA1);
+
+    beam_frame_t frame;
+    uint32_t timestamp_us = 0;
+    CHECK(beam_parse_into_frame_ts(buf, n, &frame, &timestamp_us) == ESP_OK);
+    CHECK(timestamp_us == 0xA1B2C3D4u);
+    CHECK(frame.header.len == sizeof(beam_payload_telemetry_t));
+    CHECK(frame.payload.telemetry.roll == 1.5f);
+
+    // The plain parser drops the timestamp but reports the same frame
+    memset(&frame, 0, sizeof(frame));
+    CHECK(beam_parse_into_frame(buf, n, &frame) == ESP_OK);
+    CHECK(frame.header.len == sizeof(beam_payload_telemetry_t));
+    CHECK(frame.payload.telemetry.roll == 1.5f);
+
+    return 0;
+}
+
+/* beam_validate_frame() and beam_parse_into_frame() agree on header.len */
+static int test_validate_len_excludes_timestamp(void)
+{
+    uint8_t buf[FRAME_MAX_SIZE];
+    size_t n = build_timestamped(buf, sizeof(buf), 42);
+    CHECK(n != 0);
+
+    beam_frame_header_t header;
+    CHECK(beam_validate_frame(buf, n, &header) == ESP_OK);
+    CHECK(header.flags == MSG_FLAG_EXT_TS);
+    CHECK(header.len == sizeof(beam_payload_telemetry_t));
+    CHECK(FRAME_SIZE(header.len + FRAME_EXT_SIZE(header.flags)) == n);
+
+    return 0;
+}
+
+static int test_serialize_needs_matching_call(void)
+{
+    beam_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.header.msg_category = MSG_CAT_TELEMETRY;
+    frame.header.len = 4;
+
+    uint8_t buf[FRAME_MAX_SIZE];
+    CHECK(beam_serialize_frame_ts(&frame, 1, buf, sizeof(buf), NULL) == ESP_ERR_INVALID_ARG);
+
+    frame.header.flags = MSG_FLAG_EXT_TS;
+    CHECK(beam_serialize_frame(&frame, buf, sizeof(buf), NULL) == ESP_ERR_INVALID_ARG);
+
+    frame.header.len = MAX_PAYLOAD_SIZE - FRAME_EXT_TS_SIZE + 1;
+    CHECK(beam_serialize_frame_ts(&frame, 1, buf, sizeof(buf), NULL) == ESP_ERR_INVALID_STATE);
+
+    return 0;
+}
+
+/* Serialize one beam_telemetry_encode() output as a MSG_CAT_TELEMETRY frame */
+static size_t build_compact(uint8_t *buf, size_t size, beam_telemetry_encoder_t *encoder, float roll)
+{
+    beam_payload_telemetry_t sample = {roll, -2.0f, 90.0f};
+    beam_frame_t frame;
+    beam_flags_t flags = 0;
+    memset(&frame, 0, sizeof(frame));
+    frame.header.msg_category = MSG_CAT_TELEMETRY;
+    if (beam_telemetry_encode(encoder, &sample, frame.payload.raw, &frame.header.len, &flags) != ESP_OK) {
+        return 0;
+    }
+    frame.header.flags = flags;
+
+    size_t n = 0;
+    if (beam_serialize_frame(&frame, buf, size, &n) != ESP_OK) {
+        return 0;
+    }
+
+    return n;
+}
+
+/* Keyframes expand in every parse path; deltas only with the sender's decoder */
+static int test_compact_telemetry_expanded(void)
+{
+    beam_telemetry_encoder_t encoder;
+    beam_telemetry_decoder_t decoder;
+    uint8_t key[FRAME_MAX_SIZE];
+    uint8_t delta[FRAME_MAX_SIZE];
+    beam_frame_t frame;
+
+    CHECK(beam_telemetry_encoder_init(&encoder) == ESP_OK);
+    CHECK(beam_telemetry_decoder_init(&decoder) == ESP_OK);
+    size_t key_size = build_compact(key, sizeof(key), &encoder, 10.0f);
+    size_t delta_size = build_compact(delta, sizeof(delta), &encoder, 10.5f);
+    CHECK(key_size == FRAME_SIZE(BEAM_TELEMETRY_KEYFRAME_SIZE));
+    CHECK(delta_size == FRAME_SIZE(BEAM_TELEMETRY_DELTA_SIZE));
+
+    CHECK(beam_parse_into_frame(key, key_size, &frame) == ESP_OK);
+    CHECK(frame.header.flags == 0);
+    CHECK(frame.header.len == sizeof(beam_payload_telemetry_t));
+    CHECK(frame.payload.telemetry.roll == 10.0f && frame.payload.telemetry.yaw == 90.0f);
+
+    // Without a decoder the delta stays compact
+    CHECK(beam_parse_into_frame(delta, delta_size, &frame) == ESP_OK);
+    CHECK(frame.header.flags == (MSG_FLAG_COMPACT | MSG_FLAG_DELTA));
+    CHECK(frame.header.len == BEAM_TELEMETRY_DELTA_SIZE);
+
+    // A delta before its keyframe cannot be expanded
+    CHECK(beam_parse_into_frame_telemetry(delta, delta_size, &frame, &decoder) == ESP_ERR_NOT_FOUND);
+
+    CHECK(beam_parse_into_frame_telemetry(key, key_size, &frame, &decoder) == ESP_OK);
+    CHECK(frame.payload.telemetry.roll == 10.0f);
+    CHECK(beam_parse_into_frame_telemetry(delta, delta_size, &frame, &decoder) == ESP_OK);
+    CHECK(frame.header.flags == 0);
+    CHECK(frame.header.len == sizeof(beam_payload_telemetry_t));
+    CHECK(frame.payload.telemetry.roll == 10.5f);
+    CHECK(frame.payload.telemetry.pitch == -2.0f);
+    CHECK(frame.payload.telemetry.yaw == 90.0f);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_frame_matches_wire_size);
+    RUN_TEST(failures, test_timestamp_round_trip);
+    RUN_TEST(failures, test_validate_len_excludes_timestamp);
+    RUN_TEST(failures, test_serialize_needs_matching_call);
+    RUN_TEST(failures, test_compact_telemetry_expanded);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_pipeline: submit -> validate -> dispatch across the two tasks, back-pressure and stop.
+ */
+
+#include "beam_frame_builder.h"
+#include "beam_message_common.h"
+#include "beam_pipeline.h"
+#include "test_util.h"
+#include <stdbool.h>
+
+#define MAX_HANDLED 64  /**< Frames the handler records per test */
+#define WAIT_TICKS 2000 /**< Upper bound of wait_for(), in ticks (ms on the host) */
+
+static beam_pipeline_t s_pipeline;
+static beam_dispatcher_t s_dispatcher;
+
+/* What the handler saw, in order; filled by the dispatch task */
+typedef struct handled {
+    uint8_t seq[MAX_HANDLED];
+    uint32_t count;       /**< Frames seen; read with __atomic_load_n() */
+    bool entered;         /**< The handler has taken the first frame */
+    bool hold;            /**< Block the first frame until cleared */
+    bool hold_until_stop; /**< Block the first frame until beam_pipeline_stop() is called */
+} handled_t;
+
+static handled_t s_handled;
+
+static void on_frame(const beam_frame_view_t *view, void *ctx)
+{
+    handled_t *handled = ctx;
+    uint32_t count = handled->count;
+
+    if (count == 0) {
+        __atomic_store_n(&handled->entered, true, __ATOMIC_RELEASE);
+        while (__atomic_load_n(&handled->hold, __ATOMIC_ACQUIRE)) {
+            vTaskDelay(1);
+        }
+        while (handled->hold_until_stop && __atomic_load_n(&s_pipeline.running, __ATOMIC_ACQUIRE)) {
+            vTaskDelay(1);
+        }
+    }
+    if (count < MAX_HANDLED) {
+        handled->seq[count] = beam_frame_view_seq(view);
+    }
+    __atomic_store_n(&handled->count, count + 1, __ATOMIC_RELEASE);
+}
+
+/* Build a battery frame and pass it to beam_pipeline_submit() */
+static esp_err_t submit(uint8_t seq)
+{
+    beam_frame_builder_t builder;
+    uint8_t frame[FRAME_MAX_SIZE];
+    size_t size = 0;
+
+    beam_frame_begin_len(&builder, frame, sizeof(frame), MSG_CAT_BATTERY, 0, seq, 1);
+    beam_frame_put_u8(&builder, seq);
+    beam_frame_finish(&builder, &size);
+
+    return beam_pipeline_submit(&s_pipeline, frame, size);
+}
+
+/* Wait until the handler has seen count frames; false on timeout */
+static bool wait_for(uint32_t count)
+{
+    for (int tick = 0; tick < WAIT_TICKS; tick++) {
+        if (__atomic_load_n(&s_handled.count, __ATOMIC_ACQUIRE) >= count) {
+            return true;
+        }
+        vTaskDelay(1);
+    }
+
+    return false;
+}
+
+/* Fresh dispatcher and handler state, then start */
+static esp_err_t start(void)
+{
+    s_handled = (handled_t){0};
+    beam_dispatcher_init(&s_dispatcher);
+    beam_subscribe(&s_dispatcher, MSG_CAT_BATTERY, on_frame, &s_handled);
+
+    return beam_pipeline_start(&s_pipeline, &s_dispatcher);
+}
+
+/* Frames reach the subscriber in order; invalid ones are counted and skipped */
+static int test_deliver(void)
+{
+    static const uint8_t garbage[] = {MSG_CAT_BATTERY, 0, 0, 1, 0xAA, 0x55, 0x55};
+    beam_pipeline_stats_t stats;
+
+    CHECK(beam_pipeline_submit(&s_pipeline, garbage, sizeof(garbage)) == ESP_ERR_INVALID_STATE);
+    CHECK(start() == ESP_OK);
+    CHECK(start() == ESP_ERR_INVALID_STATE);
+    CHECK(submit(1) == ESP_OK);
+    CHECK(beam_pipeline_submit(&s_pipeline, garbage, sizeof(garbage)) == ESP_OK);
+    CHECK(submit(2) == ESP_OK);
+    CHECK(submit(3) == ESP_OK);
+    CHECK(wait_for(3));
+
+    CHECK(s_handled.seq[0] == 1);
+    CHECK(s_handled.seq[1] == 2);
+    CHECK(s_handled.seq[2] == 3);
+    CHECK(beam_pipeline_get_stats(&s_pipeline, &stats) == ESP_OK);
+    CHECK(stats.submitted == 4);
+    CHECK(stats.invalid == 1);
+    CHECK(stats.dispatched == 3);
+    CHECK(stats.dropped == 0);
+
+    // Wrap the slot indices a few times
+    for (uint32_t seq = 4; seq <= MAX_HANDLED; seq++) {
+        CHECK(submit((uint8_t)seq) == ESP_OK);
+        CHECK(wait_for(seq));
+        CHECK(s_handled.seq[seq - 1] == seq);
+    }
+
+    CHECK(beam_pipeline_stop(&s_pipeline) == ESP_OK);
+    CHECK(beam_pipeline_stop(&s_pipeline) == ESP_ERR_INVALID_STATE);
+    CHECK(submit(0) == ESP_ERR_INVALID_STATE);
+
+    return 0;
+}
+
+/* A stalled subscriber fills the ring: submit fails with ESP_ERR_NO_MEM until it catches up */
+static int test_back_pressure(void)
+{
+    beam_pipeline_stats_t stats;
+
+    CHECK(start() == ESP_OK);
+    s_handled.hold = true;
+    // Slot 0 stays taken until the handler returns, however far the tasks have got
+    for (uint32_t seq = 0; seq < BEAM_PIPELINE_QUEUE_DEPTH; seq++) {
+        CHECK(submit((uint8_t)seq) == ESP_OK);
+    }
+    CHECK(submit(0xFF) == ESP_ERR_NO_MEM);
+    CHECK(beam_pipeline_get_stats(&s_pipeline, &stats) == ESP_OK);
+    CHECK(stats.dropped == 1);
+    CHECK(stats.submitted == BEAM_PIPELINE_QUEUE_DEPTH);
+
+    __atomic_store_n(&s_handled.hold, false, __ATOMIC_RELEASE);
+    CHECK(wait_for(BEAM_PIPELINE_QUEUE_DEPTH));
+    for (uint32_t i = 0; i < BEAM_PIPELINE_QUEUE_DEPTH; i++) {
+        CHECK(s_handled.seq[i] == i);
+    }
+    CHECK(submit(0xFE) == ESP_OK);
+    CHECK(wait_for(BEAM_PIPELINE_QUEUE_DEPTH + 1));
+    CHECK(s_handled.seq[BEAM_PIPELINE_QUEUE_DEPTH] == 0xFE);
+
+    CHECK(beam_pipeline_stop(&s_pipeline) == ESP_OK);
+
+    return 0;
+}
+
+/* Stop discards frames still queued, and a restarted pipeline does not deliver them */
+static int test_stop_with_queued(void)
+{
+    beam_pipeline_stats_t stats;
+
+    CHECK(start() == ESP_OK);
+    s_handled.hold_until_stop = true;
+    for (uint8_t seq = 0; seq < 4; seq++) {
+        CHECK(submit(seq) == ESP_OK);
+    }
+    for (int tick = 0; tick < WAIT_TICKS && !__atomic_load_n(&s_handled.entered, __ATOMIC_ACQUIRE); tick++) {
+        vTaskDelay(1);
+    }
+    CHECK(s_handled.entered);
+    CHECK(beam_pipeline_stop(&s_pipeline) == ESP_OK);
+    CHECK(beam_pipeline_get_stats(&s_pipeline, &stats) == ESP_OK);
+    CHECK(stats.submitted == 4);
+    CHECK(stats.dispatched == 1);
+    CHECK(s_handled.count == 1);
+
+    CHECK(start() == ESP_OK);
+    CHECK(submit(9) == ESP_OK);
+    CHECK(wait_for(1));
+    vTaskDelay(10);
+    CHECK(s_handled.count == 1);
+    CHECK(s_handled.seq[0] == 9);
+    CHECK(beam_pipeline_get_stats(&s_pipeline, &stats) == ESP_OK);
+    CHECK(stats.submitted == 1);
+    CHECK(stats.dispatched == 1);
+    CHECK(beam_pipeline_stop(&s_pipeline) == ESP_OK);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_deliver);
+    RUN_TEST(failures, test_back_pressure);
+    RUN_TEST(failures, test_stop_with_queued);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_recorder: frames recorded into batches in RAM storage and replayed back, across
+ * a wrap of the storage ring, with a torn batch and with a failing storage write.
+ */
+
+#include "beam_recorder.h"
+#include "test_util.h"
+#include <string.h>
+
+#define STORAGE_BATCHES 3                                                        /**< Batches the test storage holds */
+#define RECORD_LEN 20                                                            /**< Frame bytes per record */
+#define RECORD_SIZE (BEAM_RECORDER_RECORD_HEADER_SIZE + RECORD_LEN)              /**< Storage bytes per record */
+#define BATCH_SPACE (BEAM_RECORDER_BATCH_SIZE - BEAM_RECORDER_BATCH_HEADER_SIZE) /**< Record bytes per batch */
+#define PER_BATCH ((int)(BATCH_SPACE / RECORD_SIZE))                             /**< Records in one batch */
+#define MAX_REPLAYED (STORAGE_BATCHES * PER_BATCH)                               /**< Records the storage can hold */
+
+static uint8_t s_memory[STORAGE_BATCHES * BEAM_RECORDER_BATCH_SIZE];
+static beam_recorder_storage_t s_storage;
+static beam_recorder_t s_recorder;
+static beam_replay_t s_replay;
+
+/* Index of every replayed record, in delivery order; -1 if its contents were wrong */
+typedef struct replayed {
+    int index[MAX_REPLAYED];
+    size_t count;
+} replayed_t;
+
+static replayed_t s_replayed;
+
+/* Record i: distinct bytes, time, sender and RSSI derived from i */
+static void record_bytes(int i, uint8_t *data)
+{
+    for (int k = 0; k < RECORD_LEN; k++) {
+        data[k] = (uint8_t)(i * 31 + k);
+    }
+}
+
+static int record(int i)
+{
+    uint8_t data[RECORD_LEN];
+    const uint8_t mac[BEAM_MAC_LEN] = {0x02, 0, 0, 0, (uint8_t)(i >> 8), (uint8_t)i};
+
+    record_bytes(i, data);
+    CHECK(beam_recorder_record(&s_recorder, mac, (int8_t)(-(i % 90)), data, sizeof(data), (int64_t)i * 1000) == ESP_OK);
+    CHECK(beam_recorder_flush(&s_recorder) == ESP_OK);
+
+    return 0;
+}
+
+static void on_record(const beam_replay_record_t *record, void *ctx)
+{
+    replayed_t *replayed = ctx;
+    int i = (record->mac[4] << 8) | record->mac[5];
+    uint8_t data[RECORD_LEN];
+
+    record_bytes(i, data);
+    bool valid = record->len == RECORD_LEN && memcmp(record->data, data, RECORD_LEN) == 0 &&
+                 record->rssi == (int8_t)(-(i % 90)) && record->time_us == (uint32_t)i * 1000;
+    if (replayed->count < MAX_REPLAYED) {
+        replayed->index[replayed->count++] = valid ? i : -1;
+    }
+}
+
+/* Record indices [0, count), finish the log and replay all of it */
+static int record_and_replay(int count)
+{
+    memset(s_memory, 0, sizeof(s_memory));
+    memset(&s_replayed, 0, sizeof(s_replayed));
+    CHECK(beam_recorder_storage_init_memory(&s_storage, s_memory, sizeof(s_memory)) == ESP_OK);
+    CHECK(beam_recorder_init(&s_recorder, &s_storage) == ESP_OK);
+    for (int i = 0; i < count; i++) {
+        CHECK(record(i) == 0);
+    }
+    CHECK(beam_recorder_finish(&s_recorder) == ESP_OK);
+
+    return 0;
+}
+
+static int replay_all(beam_replay_stats_t *out_stats)
+{
+    CHECK(beam_replay_init(&s_replay, &s_storage, BEAM_REPLAY_MAX, NULL, on_record, &s_replayed) == ESP_OK);
+    while (beam_replay_poll(&s_replay, 0, 64, NULL) == ESP_OK) {
+    }
+    CHECK(beam_replay_get_stats(&s_replay, out_stats) == ESP_OK);
+
+    return 0;
+}
+
+/* Every record comes back intact and in order */
+static int test_round_trip(void)
+{
+    const int count = 2 * PER_BATCH + 5;
+    beam_recorder_stats_t recorder_stats;
+    beam_replay_stats_t stats;
+
+    CHECK(record_and_replay(count) == 0);
+    CHECK(beam_recorder_get_stats(&s_recorder, &recorder_stats) == ESP_OK);
+    CHECK(recorder_stats.recorded == (uint32_t)count);
+    CHECK(recorder_stats.batches == 3);
+    CHECK(recorder_stats.dropped == 0);
+
+    CHECK(replay_all(&stats) == 0);
+    CHECK(stats.records == (uint32_t)count);
+    CHECK(stats.dispatched == 0);
+    CHECK(stats.corrupt_batches == 0);
+    CHECK(s_replayed.count == (size_t)count);
+    for (int i = 0; i < count; i++) {
+        CHECK(s_replayed.index[i] == i);
+    }
+
+    return 0;
+}
+
+/* Once the ring wraps, replay starts at the oldest surviving batch */
+static int test_wrap(void)
+{
+    const int count = 4 * PER_BATCH + 7;
+    beam_replay_stats_t stats;
+
+    CHECK(record_and_replay(count) == 0);
+    CHECK(replay_all(&stats) == 0);
+
+    // Five batches written into three slots: the first two are gone
+    const int first = 2 * PER_BATCH;
+    CHECK(s_replayed.count == (size_t)(count - first));
+    for (size_t i = 0; i < s_replayed.count; i++) {
+        CHECK(s_replayed.index[i] == first + (int)i);
+    }
+
+    return 0;
+}
+
+/* A batch whose CRC does not match is skipped, the rest still replays */
+static int test_torn_batch_skipped(void)
+{
+    const int count = 2 * PER_BATCH + 5;
+    beam_replay_stats_t stats;
+
+    CHECK(record_and_replay(count) == 0);
+    s_memory[BEAM_RECORDER_BATCH_SIZE + BEAM_RECORDER_BATCH_HEADER_SIZE + 3] ^= 0xFF;
+
+    CHECK(replay_all(&stats) == 0);
+    CHECK(stats.corrupt_batches == 1);
+    CHECK(s_replayed.count == (size_t)(count - PER_BATCH));
+    CHECK(s_replayed.index[PER_BATCH - 1] == PER_BATCH - 1);
+    CHECK(s_replayed.index[PER_BATCH] == 2 * PER_BATCH);
+
+    return 0;
+}
+
+/* Storage whose write number s_fail_write fails after writing half the batch */
+static int s_writes;
+static int s_fail_write;
+
+static esp_err_t failing_write(void *ctx, size_t offset, const void *data, size_t len)
+{
+    (void)ctx;
+    memcpy(s_memory + offset, data, ++s_writes == s_fail_write ? len / 2 : len);
+
+    return s_writes == s_fail_write ? ESP_FAIL : ESP_OK;
+}
+
+/* A failed write loses its own batch only; everything recorded after it still replays */
+static int test_write_error_keeps_log(void)
+{
+    const int count = 2 * PER_BATCH + 5;
+    beam_recorder_stats_t recorder_stats;
+    beam_replay_stats_t stats;
+    int failed_flushes = 0;
+
+    memset(s_memory, 0, sizeof(s_memory));
+    memset(&s_replayed, 0, sizeof(s_replayed));
+    CHECK(beam_recorder_storage_init_memory(&s_storage, s_memory, sizeof(s_memory)) == ESP_OK);
+    s_storage.write = failing_write;
+    s_writes = 0;
+    s_fail_write = 2;
+    CHECK(beam_recorder_init(&s_recorder, &s_storage) == ESP_OK);
+
+    for (int i = 0; i < count; i++) {
+        uint8_t data[RECORD_LEN];
+        const uint8_t mac[BEAM_MAC_LEN] = {0x02, 0, 0, 0, (uint8_t)(i >> 8), (uint8_t)i};
+        record_bytes(i, data);
+        CHECK(beam_recorder_record(&s_recorder, mac, (int8_t)(-(i % 90)), data, sizeof(data), (int64_t)i * 1000) ==
+              ESP_OK);
+        failed_flushes += beam_recorder_flush(&s_recorder) != ESP_OK;
+    }
+    CHECK(beam_recorder_finish(&s_recorder) == ESP_OK);
+    CHECK(failed_flushes == 1);
+
+    CHECK(beam_recorder_get_stats(&s_recorder, &recorder_stats) == ESP_OK);
+    CHECK(recorder_stats.write_errors == 1);
+    CHECK(recorder_stats.batches == 2);
+
+    // The second batch is lost; the third took its slot, so replay runs on past the gap
+    CHECK(replay_all(&stats) == 0);
+    CHECK(stats.corrupt_batches == 0);
+    CHECK(s_replayed.count == (size_t)(count - PER_BATCH));
+    for (size_t i = 0; i < s_replayed.count; i++) {
+        int expected = (int)i < PER_BATCH ? (int)i : PER_BATCH + (int)i;
+        CHECK(s_replayed.index[i] == expected);
+    }
+
+    return 0;
+}
+
+/* BEAM_REPLAY_ORIGINAL delivers each record at its recorded offset from the first */
+static int test_original_pacing(void)
+{
+    size_t delivered = 0;
+
+    CHECK(record_and_replay(3) == 0);
+    CHECK(beam_replay_init(&s_replay, &s_storage, BEAM_REPLAY_ORIGINAL, NULL, on_record, &s_replayed) == ESP_OK);
+
+    CHECK(beam_replay_poll(&s_replay, 5000, 16, &delivered) == ESP_OK);
+    CHECK(delivered == 1);
+    CHECK(beam_replay_poll(&s_replay, 5999, 16, &delivered) == ESP_OK);
+    CHECK(delivered == 0);
+    CHECK(beam_replay_poll(&s_replay, 6000, 16, &delivered) == ESP_OK);
+    CHECK(delivered == 1);
+    CHECK(beam_replay_poll(&s_replay, 9000, 16, &delivered) == ESP_ERR_NOT_FOUND);
+    CHECK(delivered == 1);
+    CHECK(s_replayed.count == 3);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_round_trip);
+    RUN_TEST(failures, test_wrap);
+    RUN_TEST(failures, test_torn_batch_skipped);
+    RUN_TEST(failures, test_write_error_keeps_log);
+    RUN_TEST(failures, test_original_pacing);
+
+    return failures == 0 ? 0 : 1;
+}
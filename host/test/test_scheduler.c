@@ -0,0 +1,184 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_scheduler: priority over bulk, one frame in flight, per-category rate limits.
+ */
+
+#include "beam_frame_builder.h"
+#include "beam_scheduler.h"
+#include "test_util.h"
+#include <string.h>
+
+#define QUEUE_SLOTS 4 /**< Slots per queue */
+#define MAX_SENT 16   /**< Frames the sink records per test */
+
+/* Scheduler with its queue storage and the seq of every frame sent, in order */
+typedef struct fixture {
+    beam_scheduler_t sched;
+    beam_frame_buf_t priority_slots[QUEUE_SLOTS];
+    beam_frame_buf_t bulk_slots[QUEUE_SLOTS];
+    uint8_t sent[MAX_SENT];
+    size_t count;
+} fixture_t;
+
+static fixture_t s_fixture;
+
+static esp_err_t sink_send(const uint8_t *frame, size_t frame_len, void *ctx)
+{
+    (void)frame_len;
+    fixture_t *fixture = ctx;
+    if (fixture->count == MAX_SENT) {
+        return ESP_FAIL;
+    }
+    fixture->sent[fixture->count++] = frame[FRAME_OFFSET_SEQ];
+
+    return ESP_OK;
+}
+
+static int fixture_init(fixture_t *fixture)
+{
+    memset(fixture, 0, sizeof(*fixture));
+    CHECK(beam_scheduler_init(&fixture->sched,
+                              fixture->priority_slots,
+                              QUEUE_SLOTS,
+                              fixture->bulk_slots,
+                              QUEUE_SLOTS,
+                              sink_send,
+                              fixture) == ESP_OK);
+
+    return 0;
+}
+
+static esp_err_t enqueue(fixture_t *fixture, beam_msg_category_t category, beam_flags_t flags, uint8_t seq)
+{
+    beam_frame_builder_t builder;
+    uint8_t frame[FRAME_MAX_SIZE];
+    size_t size = 0;
+
+    beam_frame_begin_len(&builder, frame, sizeof(frame), category, flags, seq, 1);
+    beam_frame_put_u8(&builder, seq);
+    beam_frame_finish(&builder, &size);
+
+    return beam_scheduler_enqueue(&fixture->sched, frame, size);
+}
+
+/* Send everything eligible at now_us, completing each send at once */
+static size_t drain(fixture_t *fixture, int64_t now_us)
+{
+    size_t sent = 0;
+    while (beam_scheduler_run(&fixture->sched, now_us) == ESP_OK) {
+        beam_scheduler_on_send_done(&fixture->sched);
+        sent++;
+    }
+
+    return sent;
+}
+
+/* Priority frames overtake queued bulk frames; order within a queue is kept */
+static int test_priority_first(void)
+{
+    fixture_t *fixture = &s_fixture;
+
+    CHECK(fixture_init(fixture) == 0);
+    CHECK(enqueue(fixture, MSG_CAT_BATTERY, 0, 1) == ESP_OK);
+    CHECK(enqueue(fixture, MSG_CAT_BATTERY, 0, 2) == ESP_OK);
+    CHECK(enqueue(fixture, MSG_CAT_BATTERY, MSG_FLAG_PRIORITY, 3) == ESP_OK);
+    CHECK(enqueue(fixture, MSG_CAT_BATTERY, MSG_FLAG_PRIORITY, 4) == ESP_OK);
+
+    CHECK(drain(fixture, 0) == 4);
+    const uint8_t expected[] = {3, 4, 1, 2};
+    CHECK(fixture->count == sizeof(expected));
+    CHECK(memcmp(fixture->sent, expected, sizeof(expected)) == 0);
+    CHECK(fixture->sched.stats.sent == 4);
+
+    return 0;
+}
+
+/* Nothing more is sent until the previous send completes */
+static int test_one_in_flight(void)
+{
+    fixture_t *fixture = &s_fixture;
+
+    CHECK(fixture_init(fixture) == 0);
+    CHECK(enqueue(fixture, MSG_CAT_BATTERY, 0, 1) == ESP_OK);
+    CHECK(enqueue(fixture, MSG_CAT_BATTERY, 0, 2) == ESP_OK);
+
+    CHECK(beam_scheduler_run(&fixture->sched, 0) == ESP_OK);
+    CHECK(beam_scheduler_run(&fixture->sched, 0) == ESP_ERR_INVALID_STATE);
+    CHECK(fixture->count == 1);
+    CHECK(beam_scheduler_on_send_done(&fixture->sched) == ESP_OK);
+    CHECK(beam_scheduler_run(&fixture->sched, 0) == ESP_OK);
+    CHECK(beam_scheduler_on_send_done(&fixture->sched) == ESP_OK);
+    CHECK(beam_scheduler_run(&fixture->sched, 0) == ESP_ERR_NOT_FOUND);
+
+    return 0;
+}
+
+/* A full queue rejects the frame and counts it by queue */
+static int test_queue_full(void)
+{
+    fixture_t *fixture = &s_fixture;
+    esp_err_t err = ESP_OK;
+    size_t queued = 0;
+
+    CHECK(fixture_init(fixture) == 0);
+    while ((err = enqueue(fixture, MSG_CAT_BATTERY, 0, (uint8_t)queued)) == ESP_OK) {
+        queued++;
+        CHECK(queued <= QUEUE_SLOTS);
+    }
+    CHECK(err == ESP_ERR_NO_MEM);
+    CHECK(fixture->sched.stats.dropped_bulk == 1);
+    CHECK(fixture->sched.stats.dropped_priority == 0);
+    CHECK(enqueue(fixture, MSG_CAT_BATTERY, MSG_FLAG_PRIORITY, 0) == ESP_OK);
+
+    return 0;
+}
+
+/* A limited category waits for credit while other traffic keeps flowing */
+static int test_rate_limit(void)
+{
+    fixture_t *fixture = &s_fixture;
+
+    CHECK(fixture_init(fixture) == 0);
+    CHECK(beam_scheduler_set_rate(&fixture->sched, MSG_CAT_TELEMETRY, 10, 1, 0) == ESP_OK);
+    CHECK(enqueue(fixture, MSG_CAT_TELEMETRY, 0, 1) == ESP_OK);
+    CHECK(enqueue(fixture, MSG_CAT_TELEMETRY, 0, 2) == ESP_OK);
+    CHECK(enqueue(fixture, MSG_CAT_BATTERY, MSG_FLAG_PRIORITY, 3) == ESP_OK);
+
+    CHECK(drain(fixture, 0) == 2);
+    CHECK(fixture->sent[0] == 3);
+    CHECK(fixture->sent[1] == 1);
+    CHECK(fixture->sched.stats.throttled > 0);
+
+    CHECK(drain(fixture, 99999) == 0);
+    CHECK(drain(fixture, 100000) == 1);
+    CHECK(fixture->sent[2] == 2);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_priority_first);
+    RUN_TEST(failures, test_one_in_flight);
+    RUN_TEST(failures, test_queue_full);
+    RUN_TEST(failures, test_rate_limit);
+
+    return failures == 0 ? 0 : 1;
+}
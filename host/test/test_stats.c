@@ -0,0 +1,130 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * beam_stats: counters recorded through the internal hooks, read back through the
+ * public snapshot.
+ */
+
+#include "beam_frame_builder.h"
+#include "beam_message_common.h"
+#include "beam_parser.h"
+#include "beam_stats.h"
+#include "beam_stats_internal.h"
+#include "test_util.h"
+#include <string.h>
+
+/* The cycle total is 64 bits wide; the mean must survive it passing UINT32_MAX */
+static int test_cycle_total_wraps(void)
+{
+    beam_stats_t stats;
+
+    beam_stats_reset();
+    beam_stats_counters.frames_parsed = 1;
+    beam_stats_counters.parse_cycles_total = UINT32_MAX - 100;
+
+    stats_record_parse(0, FRAME_MIN_SIZE, stats_parse_begin() - 1000);
+    CHECK(beam_stats_counters.parse_cycles_total > UINT32_MAX);
+
+    CHECK(beam_stats_get(&stats) == ESP_OK);
+    CHECK(stats.frames_parsed == 2);
+    CHECK(stats.parse_cycles_avg >= UINT32_MAX / 2 - 100);
+    CHECK(stats.parse_cycles_min >= 1000);
+
+    beam_stats_reset();
+    CHECK(beam_stats_get(&stats) == ESP_OK);
+    CHECK(stats.frames_parsed == 0);
+    CHECK(stats.parse_cycles_avg == 0);
+
+    return 0;
+}
+
+/* Rejections are counted by error code */
+static int test_errors_counted(void)
+{
+    beam_stats_t stats;
+
+    beam_stats_reset();
+    stats_record_error(ESP_ERR_INVALID_SIZE);
+    stats_record_error(ESP_ERR_INVALID_CRC);
+    stats_record_error(ESP_ERR_INVALID_CRC);
+    stats_record_error(ESP_ERR_INVALID_ARG);
+
+    CHECK(beam_stats_get(&stats) == ESP_OK);
+    CHECK(stats.invalid_size == 1);
+    CHECK(stats.invalid_crc == 2);
+
+    return 0;
+}
+
+/* beam_parse_batch() fills a view per valid packet and counts the whole batch at once */
+static int test_batch_counted(void)
+{
+    uint8_t frames[3][FRAME_MAX_SIZE];
+    size_t sizes[3] = {0};
+    beam_frame_builder_t builder;
+    beam_stats_t stats;
+
+    for (size_t i = 0; i < 3; i++) {
+        beam_msg_category_t category = i == 2 ? MSG_CAT_TELEMETRY : MSG_CAT_BATTERY;
+        CHECK(beam_frame_begin_len(&builder, frames[i], sizeof(frames[i]), category, 0, (uint8_t)i, 2) == ESP_OK);
+        CHECK(beam_frame_put_u16(&builder, (uint16_t)i) == ESP_OK);
+        CHECK(beam_frame_finish(&builder, &sizes[i]) == ESP_OK);
+    }
+    uint8_t bad_crc[FRAME_MAX_SIZE];
+    memcpy(bad_crc, frames[0], sizes[0]);
+    bad_crc[sizes[0] - 1] ^= 0xFF;
+
+    const beam_rx_slice_t in[] = {
+        {frames[0], sizes[0]}, {bad_crc, sizes[0]}, {frames[1], sizes[1]},
+        {frames[2], 2},        {NULL, 0},           {frames[2], sizes[2]},
+    };
+    beam_frame_view_t out[6];
+    esp_err_t status[6];
+
+    beam_stats_reset();
+    CHECK(beam_parse_batch(in, 0, NULL, NULL) == ESP_OK);
+    CHECK(beam_parse_batch(in, 6, out, status) == ESP_FAIL);
+    CHECK(status[0] == ESP_OK && status[2] == ESP_OK && status[5] == ESP_OK);
+    CHECK(status[1] == ESP_ERR_INVALID_CRC);
+    CHECK(status[3] == ESP_ERR_INVALID_SIZE);
+    CHECK(status[4] == ESP_ERR_INVALID_ARG);
+    CHECK(out[0].data == frames[0] && out[0].size == sizes[0]);
+    CHECK(out[5].data == frames[2] && out[5].size == sizes[2]);
+    CHECK(beam_frame_view_seq(&out[2]) == 1);
+
+    CHECK(beam_stats_get(&stats) == ESP_OK);
+    CHECK(stats.frames_parsed == 3);
+    CHECK(stats.bytes_parsed == sizes[0] + sizes[1] + sizes[2]);
+    CHECK(stats.invalid_size == 1);
+    CHECK(stats.invalid_crc == 1);
+    CHECK(stats.per_category[MSG_CAT_BATTERY] == 2);
+    CHECK(stats.per_category[MSG_CAT_TELEMETRY] == 1);
+    CHECK(stats.parse_cycles_min <= stats.parse_cycles_max);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    RUN_TEST(failures, test_cycle_total_wraps);
+    RUN_TEST(failures, test_errors_counted);
+    RUN_TEST(failures, test_batch_counted);
+
+    return failures == 0 ? 0 : 1;
+}
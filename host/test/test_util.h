@@ -0,0 +1,43 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+/*
+ * Minimal test harness for the host tests: each test is a function returning 0 on
+ * success, CHECK() fails it with the location of the first failed condition, and
+ * RUN_TEST() runs one and counts the failures for main() to return.
+ */
+
+#ifndef BEAM_TEST_UTIL_H
+#define BEAM_TEST_UTIL_H
+
+#include <stdio.h>
+
+#define CHECK(condition)                                                                                               \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);                              \
+            return 1;                                                                                                  \
+        }                                                                                                              \
+    } while (0)
+
+#define RUN_TEST(failures, test)                                                                                       \
+    do {                                                                                                               \
+        int result_ = (test)();                                                                                        \
+        printf("%s %s\n", result_ == 0 ? "PASS" : "FAIL", #test);                                                      \
+        (failures) += result_ != 0;                                                                                    \
+    } while (0)
+
+#endif /* BEAM_TEST_UTIL_H */
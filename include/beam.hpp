@@ -0,0 +1,241 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_HPP
+#define BEAM_HPP
+
+#include "beam_frame.h"
+#include "beam_frame_builder.h"
+#include "beam_frame_view.h"
+#include "beam_message_common.h"
+#include "beam_parser.h"
+#include "beam_payload_type.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#if __has_include(<span>)
+#include <span>
+#endif
+
+/*
+ * Header-only C++17 layer over the C API. Payload types are the packed structs of the
+ * payload registry (BEAM_PAYLOADS, built-in and user), so the wire format is the one
+ * the C functions produce and accept:
+ *
+ *   beam::Frame<beam_payload_telemetry_t> frame;
+ *   frame.seq = 7;
+ *   frame.payload = {1.0f, 2.0f, 3.0f};
+ *   auto wire = beam::serialize(frame); // std::array<uint8_t, 18>
+ *
+ *   if (auto view = beam::View::parse({data, len})) {
+ *       beam::visit(*view, [](const beam_payload_telemetry_t &t) { ... });
+ *   }
+ *
+ * Category, payload size and frame size are constexpr per type. Nothing throws and
+ * nothing allocates, so the header works with -fno-exceptions.
+ */
+
+namespace beam {
+
+#if defined(__cpp_lib_span) && __cpp_lib_span >= 202002L
+using bytes = std::span<const std::uint8_t>; ///< Read-only byte range
+#else
+/**
+ * @brief Read-only byte range; std::span<const uint8_t> when the standard library has it.
+ */
+class bytes {
+  public:
+    constexpr bytes() noexcept = default;
+    constexpr bytes(const std::uint8_t *data, std::size_t size) noexcept : data_(data), size_(size) {}
+    template <std::size_t N>
+    constexpr bytes(const std::array<std::uint8_t, N> &array) noexcept : data_(array.data()), size_(N)
+    {
+    }
+
+    constexpr const std::uint8_t *data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr const std::uint8_t *begin() const noexcept { return data_; }
+    constexpr const std::uint8_t *end() const noexcept { return data_ + size_; }
+    constexpr std::uint8_t operator[](std::size_t i) const noexcept { return data_[i]; }
+
+  private:
+    const std::uint8_t *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+#endif
+
+/**
+ * @brief Category of a registered payload type; undefined (a compile error) for other types.
+ */
+template <typename Payload>
+struct payload_traits;
+
+#define BEAM_HPP_PAYLOAD_TRAITS(cat, member, type)                                                                     \
+    template <>                                                                                                        \
+    struct payload_traits<type> {                                                                                      \
+        static constexpr beam_msg_category_t category = (cat);                                                         \
+    };
+
+BEAM_PAYLOADS(BEAM_HPP_PAYLOAD_TRAITS)
+
+#undef BEAM_HPP_PAYLOAD_TRAITS
+
+/** Flags that describe a payload encoding other than the packed struct; cleared by serialize() */
+inline constexpr beam_flags_t encoding_flags = MSG_FLAG_COMPACT | MSG_FLAG_DELTA | MSG_FLAG_COMPRESSED;
+
+/**
+ * @brief A frame carrying one registered payload type, with compile-time sizes.
+ */
+template <typename Payload>
+struct Frame {
+    static_assert(std::is_trivially_copyable_v<Payload>, "payloads are copied byte for byte");
+
+    static constexpr beam_msg_category_t category = payload_traits<Payload>::category; ///< Header msg_category
+    static constexpr std::size_t payload_size = sizeof(Payload);                        ///< Header len
+    static constexpr std::size_t wire_size = FRAME_SIZE(payload_size);                  ///< Bytes on the wire
+
+    static_assert(payload_size <= MAX_PAYLOAD_SIZE, "payload exceeds MAX_PAYLOAD_SIZE");
+
+    beam_flags_t flags = 0; ///< MSG_FLAG_PRIORITY, MSG_FLAG_ACK_REQ; encoding flags and MSG_FLAG_EXT_TS are cleared
+    std::uint8_t seq = 0;   ///< Packet sequence number
+    Payload payload{};      ///< Payload as laid out on the wire
+};
+
+/**
+ * @brief Serializes a frame into an array of exactly Frame<Payload>::wire_size bytes.
+ *
+ * Goes through the C frame builder, so statistics and CRC backend are those of the C API.
+ * The builder cannot fail here: every size is checked at compile time.
+ */
+template <typename Payload>
+std::array<std::uint8_t, Frame<Payload>::wire_size> serialize(const Frame<Payload> &frame) noexcept
+{
+    using frame_type = Frame<Payload>;
+
+    std::array<std::uint8_t, frame_type::wire_size> out{};
+    beam_frame_builder_t builder;
+    std::size_t size = 0;
+    beam_frame_begin_len(&builder,
+                         out.data(),
+                         out.size(),
+                         frame_type::category,
+                         static_cast<beam_flags_t>(frame.flags & ~(encoding_flags | MSG_FLAG_EXT_TS)),
+                         frame.seq,
+                         static_cast<std::uint8_t>(frame_type::payload_size));
+    beam_frame_put_bytes(&builder, &frame.payload, frame_type::payload_size);
+    beam_frame_finish(&builder, &size);
+
+    return out;
+}
+
+/**
+ * @brief Zero-copy view of a validated frame; points into the caller's buffer.
+ */
+class View {
+  public:
+    /**
+     * @brief Validates data as beam_parse_view() does.
+     *
+     * @return The view, or std::nullopt if the length or CRC is invalid.
+     */
+    static std::optional<View> parse(bytes data) noexcept
+    {
+        beam_frame_view_t view;
+        if (beam_parse_view(data.data(), data.size(), &view) != ESP_OK) {
+            return std::nullopt;
+        }
+
+        return View(view);
+    }
+
+    /** Wraps a view filled by the C API (beam_parse_view(), beam_ring_peek(), ...) */
+    explicit View(const beam_frame_view_t &view) noexcept : view_(view) {}
+
+    beam_msg_category_t category() const noexcept { return beam_frame_view_category(&view_); }
+    beam_flags_t flags() const noexcept { return beam_frame_view_flags(&view_); }
+    std::uint8_t seq() const noexcept { return beam_frame_view_seq(&view_); }
+    bytes payload() const noexcept { return {beam_frame_view_payload(&view_), beam_frame_view_payload_len(&view_)}; }
+    bytes wire() const noexcept { return {view_.data, view_.size}; }
+    const beam_frame_view_t &c_view() const noexcept { return view_; }
+
+    /**
+     * @brief True if the frame carries a plain Payload: its category, enough bytes and no encoding flags.
+     */
+    template <typename Payload>
+    bool is() const noexcept
+    {
+        return category() == payload_traits<Payload>::category &&
+               beam_frame_view_payload_len(&view_) >= sizeof(Payload) && (flags() & encoding_flags) == 0;
+    }
+
+    /**
+     * @brief Copies the payload out as Payload, or std::nullopt if is<Payload>() is false.
+     */
+    template <typename Payload>
+    std::optional<Payload> as() const noexcept
+    {
+        if (!is<Payload>()) {
+            return std::nullopt;
+        }
+        Payload payload;
+        std::memcpy(&payload, beam_frame_view_payload(&view_), sizeof(payload));
+
+        return payload;
+    }
+
+  private:
+    beam_frame_view_t view_;
+};
+
+/**
+ * @brief Calls visitor with the typed payload of view, switching over the registry.
+ *
+ * The visitor needs overloads only for the types it handles (e.g. an overload set of
+ * lambdas); registered types it cannot take are skipped at compile time.
+ *
+ * @return true if the visitor was called; false for an unregistered category, an
+ *         encoded or short payload, or a type the visitor does not accept.
+ */
+template <typename Visitor>
+bool visit(const View &view, Visitor &&visitor)
+{
+#define BEAM_HPP_VISIT_CASE(cat, member, type)                                                                         \
+    case (cat):                                                                                                        \
+        if constexpr (std::is_invocable_v<Visitor, const type &>) {                                                    \
+            if (auto payload = view.as<type>()) {                                                                      \
+                std::forward<Visitor>(visitor)(*payload);                                                              \
+                return true;                                                                                           \
+            }                                                                                                          \
+        }                                                                                                              \
+        return false;
+
+    switch (view.category()) {
+        BEAM_PAYLOADS(BEAM_HPP_VISIT_CASE)
+    default:
+        return false;
+    }
+
+#undef BEAM_HPP_VISIT_CASE
+}
+
+} // namespace beam
+
+#endif /* BEAM_HPP */
@@ -0,0 +1,190 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_AGGREGATE_H
+#define BEAM_AGGREGATE_H
+
+#include "beam_frame.h"
+#include "beam_frame_builder.h"
+#include "beam_frame_view.h"
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A MSG_CAT_AGGREGATE frame carries several sub-messages under one header and one CRC.
+ * Its payload is a sequence of [category][len][len payload bytes] entries.
+ */
+
+#define BEAM_AGGREGATE_ITEM_HEADER_SIZE 2u                                               ///< Entry header bytes
+#define BEAM_AGGREGATE_MAX_ITEM_LEN (MAX_PAYLOAD_SIZE - BEAM_AGGREGATE_ITEM_HEADER_SIZE) ///< Largest sub-message
+
+/**
+ * @brief One sub-message inside an aggregate frame. payload points into the frame.
+ */
+typedef struct beam_aggregate_item {
+    beam_msg_category_t category; ///< Sub-message category
+    uint8_t len;                  ///< Sub-message payload length
+    const uint8_t *payload;       ///< Sub-message payload bytes
+} beam_aggregate_item_t;
+
+/**
+ * @brief Receiver-side iterator over an aggregate frame. Treat the fields as private.
+ */
+typedef struct beam_aggregate_iter {
+    const uint8_t *pos; ///< Next sub-message header
+    const uint8_t *end; ///< End of the aggregate payload
+} beam_aggregate_iter_t;
+
+/**
+ * @brief Called with every finished frame, ready to transmit. The buffer is only valid during the call.
+ */
+typedef esp_err_t (*beam_coalescer_flush_cb_t)(const uint8_t *frame, size_t frame_len, void *ctx);
+
+/**
+ * @brief Sender-side coalescer: packs small messages into aggregate frames. Treat the fields as private.
+ *
+ * Pending messages go out when the next one does not fit, or when the oldest has
+ * waited max_delay_us (checked by beam_coalescer_poll()). A lone message is sent as a
+ * plain frame of its own category.
+ */
+typedef struct beam_coalescer {
+    uint8_t buf[FRAME_MAX_SIZE];     ///< Frame under construction
+    beam_frame_builder_t builder;    ///< Builder writing into buf
+    uint8_t count;                   ///< Sub-messages pending in buf
+    uint8_t *seq;                    ///< Caller's sequence counter of the destination, unused with ACK_REQ
+    beam_flags_t flags;              ///< Header flags for emitted frames
+    uint32_t max_delay_us;           ///< Longest time a message may wait
+    int64_t deadline_us;             ///< Flush time for the pending messages
+    beam_coalescer_flush_cb_t flush; ///< Frame sink
+    void *ctx;                       ///< Sink context
+} beam_coalescer_t;
+
+/**
+ * @brief Appends a sub-message to an aggregate frame being built.
+ *
+ * Start the builder with beam_frame_begin(..., MSG_CAT_AGGREGATE, ...).
+ *
+ * @param builder Started builder. Must not be NULL.
+ * @param category Sub-message category.
+ * @param payload Sub-message payload. May be NULL only if len is 0.
+ * @param len Payload length.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if builder or payload is NULL.
+ *         ESP_ERR_INVALID_SIZE if the entry does not fit (see beam_frame_put_bytes()).
+ */
+esp_err_t beam_aggregate_put(beam_frame_builder_t *builder,
+                             beam_msg_category_t category,
+                             const uint8_t *payload,
+                             uint8_t len);
+
+/**
+ * @brief Starts iterating over the sub-messages of a frame.
+ *
+ * @param it Iterator to initialize. Must not be NULL.
+ * @param view Validated frame. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if it or view is NULL, or the frame is not MSG_CAT_AGGREGATE.
+ */
+esp_err_t beam_aggregate_iter_init(beam_aggregate_iter_t *it, const beam_frame_view_t *view);
+
+/**
+ * @brief Returns the next sub-message.
+ *
+ * @param it Initialized iterator. Must not be NULL.
+ * @param[out] out_item Receives the sub-message. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if it or out_item is NULL.
+ *         ESP_ERR_NOT_FOUND if there are no more sub-messages.
+ *         ESP_ERR_INVALID_SIZE if the remaining bytes are a truncated entry.
+ */
+esp_err_t beam_aggregate_next(beam_aggregate_iter_t *it, beam_aggregate_item_t *out_item);
+
+/**
+ * @brief Initializes a coalescer.
+ *
+ * @param coalescer Coalescer to initialize. Must not be NULL.
+ * @param flags Header flags for the frames it emits: MSG_FLAG_PRIORITY and MSG_FLAG_ACK_REQ only,
+ *        since the payload encoding flags do not hold for aggregates.
+ * @param[in,out] seq Sequence counter of the destination, shared with the caller's other
+ *                    frames to it; each emitted frame takes *seq and increments it. Must
+ *                    outlive the coalescer. Unused with MSG_FLAG_ACK_REQ, whose frames must
+ *                    go to beam_arq_send() (which numbers them), and may then be NULL.
+ * @param max_delay_us Longest time a message may wait for companions.
+ * @param flush Frame sink (e.g. a wrapper around esp_now_send). Must not be NULL.
+ * @param ctx User context passed to flush.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if coalescer or flush is NULL, seq is NULL without MSG_FLAG_ACK_REQ,
+ *         or flags has other bits.
+ */
+esp_err_t beam_coalescer_init(beam_coalescer_t *coalescer,
+                              beam_flags_t flags,
+                              uint8_t *seq,
+                              uint32_t max_delay_us,
+                              beam_coalescer_flush_cb_t flush,
+                              void *ctx);
+
+/**
+ * @brief Queues a message, flushing the pending frame first if the message does not fit.
+ *
+ * @param coalescer Initialized coalescer. Must not be NULL.
+ * @param category Message category.
+ * @param payload Message payload. May be NULL only if len is 0.
+ * @param len Payload length, at most BEAM_AGGREGATE_MAX_ITEM_LEN.
+ * @param now_us Current time in microseconds (e.g. esp_timer_get_time()).
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if coalescer or payload is NULL.
+ *         ESP_ERR_INVALID_SIZE if len exceeds BEAM_AGGREGATE_MAX_ITEM_LEN.
+ *         Any error returned by the flush callback.
+ */
+esp_err_t beam_coalescer_add(beam_coalescer_t *coalescer,
+                             beam_msg_category_t category,
+                             const uint8_t *payload,
+                             uint8_t len,
+                             int64_t now_us);
+
+/**
+ * @brief Flushes the pending frame if its deadline has passed. Call periodically.
+ *
+ * @return ESP_OK on success (including when nothing was due).
+ *         ESP_ERR_INVALID_ARG if coalescer is NULL.
+ *         Any error returned by the flush callback.
+ */
+esp_err_t beam_coalescer_poll(beam_coalescer_t *coalescer, int64_t now_us);
+
+/**
+ * @brief Flushes the pending frame now, if any.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if coalescer is NULL.
+ *         Any error returned by the flush callback.
+ */
+esp_err_t beam_coalescer_flush(beam_coalescer_t *coalescer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_AGGREGATE_H */
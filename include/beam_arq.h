@@ -0,0 +1,244 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_ARQ_H
+#define BEAM_ARQ_H
+
+#include "beam_frame.h"
+#include "beam_frame_view.h"
+#include "beam_seq.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Selective-repeat delivery for frames sent with MSG_FLAG_ACK_REQ. The receiver answers
+ * every such frame with a MSG_CAT_ACK frame whose payload is [ack_seq][bitmap u32 LE]:
+ * ack_seq is the newest sequence number received and bit n of the bitmap is set if
+ * (ack_seq - n) was received, so one ACK covers up to 32 frames and survives the loss
+ * of earlier ACKs. The sender keeps each unacknowledged frame in a pool buffer and
+ * retransmits it after an adaptive timeout (RFC 6298, with Karn's rule). Frames without
+ * the flag are passed straight to the send callback.
+ *
+ * Frames with MSG_FLAG_ACK_REQ are numbered by beam_arq_send() in a sequence space of
+ * their own, so best-effort traffic in between cannot push a retransmission out of the
+ * receiver's 32-entry window. The sender keeps every retained frame within 32 of the
+ * newest one, so a retransmission always lands inside the window and its ACK covers it.
+ */
+
+#define BEAM_ARQ_ACK_PAYLOAD_SIZE 5u                                    ///< ack_seq + bitmap
+#define BEAM_ARQ_WINDOW_SIZE CONFIG_BEAM_ARQ_WINDOW_SIZE                ///< Unacknowledged frames per sender
+#define BEAM_ARQ_MAX_RETRIES CONFIG_BEAM_ARQ_MAX_RETRIES                ///< Retransmissions before giving up
+#define BEAM_ARQ_INITIAL_RTO_US (CONFIG_BEAM_ARQ_INITIAL_RTO_MS * 1000) ///< Timeout before the first RTT sample
+#define BEAM_ARQ_MIN_RTO_US (CONFIG_BEAM_ARQ_MIN_RTO_MS * 1000)         ///< Lower bound of the timeout
+#define BEAM_ARQ_MAX_RTO_US (CONFIG_BEAM_ARQ_MAX_RTO_MS * 1000)         ///< Upper bound of the timeout
+#define BEAM_ARQ_RESYNC_STALE CONFIG_BEAM_ARQ_RESYNC_STALE              ///< Stale frames in a row that mean a restart
+
+/**
+ * @brief Transmits one frame (e.g. a wrapper around esp_now_send). The buffer is only valid during the call.
+ */
+typedef esp_err_t (*beam_arq_send_cb_t)(const uint8_t *frame, size_t frame_len, void *ctx);
+
+/**
+ * @brief Called when a frame is dropped after BEAM_ARQ_MAX_RETRIES retransmissions.
+ */
+typedef void (*beam_arq_fail_cb_t)(uint8_t seq, void *ctx);
+
+/**
+ * @brief Sender counters.
+ */
+typedef struct beam_arq_stats {
+    uint32_t sent;        ///< Frames with MSG_FLAG_ACK_REQ sent for the first time
+    uint32_t retransmits; ///< Retransmissions
+    uint32_t acked;       ///< Frames acknowledged
+    uint32_t failed;      ///< Frames given up on
+} beam_arq_stats_t;
+
+/**
+ * @brief One unacknowledged frame.
+ */
+typedef struct beam_arq_entry {
+    beam_frame_buf_t *buf; ///< Pool buffer holding the frame, NULL if the entry is free
+    int64_t sent_us;       ///< Time of the last (re)transmission
+    uint8_t seq;           ///< header.seq of the frame
+    uint8_t retries;       ///< Retransmissions so far
+} beam_arq_entry_t;
+
+/**
+ * @brief Sender state for one destination. Treat the fields as private.
+ *
+ * Not thread-safe: call the beam_arq_* functions of one sender from a single task.
+ */
+typedef struct beam_arq_tx {
+    beam_arq_entry_t window[BEAM_ARQ_WINDOW_SIZE]; ///< Unacknowledged frames
+    uint32_t srtt_us;                              ///< Smoothed round-trip time
+    uint32_t rttvar_us;                            ///< Round-trip time variation
+    uint32_t rto_us;                               ///< Current retransmission timeout
+    bool has_rtt;                                  ///< False until the first RTT sample
+    uint8_t next_seq;                              ///< seq given to the next MSG_FLAG_ACK_REQ frame
+    beam_arq_send_cb_t send;                       ///< Frame sink
+    beam_arq_fail_cb_t on_fail;                    ///< Optional give-up notification
+    void *ctx;                                     ///< User context passed to send and on_fail
+    beam_arq_stats_t stats;                        ///< Counters
+} beam_arq_tx_t;
+
+/**
+ * @brief Receiver counters.
+ */
+typedef struct beam_arq_rx_stats {
+    beam_seq_stats_t seq; ///< Sequence tracking of MSG_FLAG_ACK_REQ frames
+    uint32_t stale;       ///< Frames too far behind to tell a duplicate from a lost frame, dropped
+    uint32_t resyncs;     ///< Times the sender was taken as restarted (see beam_arq_receive())
+} beam_arq_rx_stats_t;
+
+/**
+ * @brief Receiver state for one sender. Treat the fields as private.
+ */
+typedef struct beam_arq_rx {
+    beam_seq_state_t seq; ///< Sequence state of the sender's MSG_FLAG_ACK_REQ frames only
+    uint32_t stale;       ///< See beam_arq_rx_stats_t
+    uint32_t resyncs;     ///< See beam_arq_rx_stats_t
+    uint8_t stale_run;    ///< Stale frames since the last one in the window
+} beam_arq_rx_t;
+
+/**
+ * @brief Initializes a sender.
+ *
+ * @param tx Sender state. Must not be NULL.
+ * @param send Frame sink. Must not be NULL.
+ * @param on_fail Give-up notification. Can be NULL.
+ * @param ctx User context passed to send and on_fail.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tx or send is NULL.
+ */
+esp_err_t beam_arq_tx_init(beam_arq_tx_t *tx, beam_arq_send_cb_t send, beam_arq_fail_cb_t on_fail, void *ctx);
+
+/**
+ * @brief Sends a serialized frame, retaining a copy if it carries MSG_FLAG_ACK_REQ.
+ *
+ * The header.seq of a MSG_FLAG_ACK_REQ frame is replaced with the sender's own counter
+ * (and the CRC recomputed); other frames are sent unchanged. Send every MSG_FLAG_ACK_REQ
+ * frame of one destination through the same sender.
+ *
+ * @param tx Initialized sender. Must not be NULL.
+ * @param frame Valid serialized frame. Must not be NULL.
+ * @param frame_len Frame size in bytes.
+ * @param now_us Current time in microseconds (e.g. esp_timer_get_time()).
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tx or frame is NULL.
+ *         ESP_ERR_INVALID_SIZE if frame_len is outside [FRAME_MIN_SIZE, FRAME_MAX_SIZE].
+ *         ESP_ERR_NO_MEM if the window is full, the oldest retained frame is BEAM_SEQ_WINDOW_SIZE - 1
+ *         frames behind, or the pool is empty; nothing was sent.
+ *         Any error returned by the send callback (the frame stays retained and will be retried).
+ */
+esp_err_t beam_arq_send(beam_arq_tx_t *tx, const uint8_t *frame, size_t frame_len, int64_t now_us);
+
+/**
+ * @brief Releases every retained frame acknowledged by an ACK frame and updates the RTT estimate.
+ *
+ * An ACK whose ack_seq is not one of the last BEAM_SEQ_WINDOW_SIZE frames sent (a stale
+ * ACK from before a wrap of the 8-bit counter) is ignored rather than matched.
+ *
+ * @param tx Initialized sender. Must not be NULL.
+ * @param view Validated MSG_CAT_ACK frame. Must not be NULL.
+ * @param now_us Current time in microseconds.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tx or view is NULL, or the frame is not MSG_CAT_ACK.
+ *         ESP_ERR_INVALID_SIZE if the payload is not BEAM_ARQ_ACK_PAYLOAD_SIZE bytes.
+ */
+esp_err_t beam_arq_handle_ack(beam_arq_tx_t *tx, const beam_frame_view_t *view, int64_t now_us);
+
+/**
+ * @brief Retransmits frames whose timeout expired and drops those out of retries. Call periodically.
+ *
+ * @param tx Initialized sender. Must not be NULL.
+ * @param now_us Current time in microseconds.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tx is NULL.
+ */
+esp_err_t beam_arq_poll(beam_arq_tx_t *tx, int64_t now_us);
+
+/**
+ * @brief Number of frames waiting for acknowledgement.
+ */
+size_t beam_arq_in_flight(const beam_arq_tx_t *tx);
+
+/**
+ * @brief Releases all retained frames, e.g. when the destination goes away. Keeps the RTT estimate.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tx is NULL.
+ */
+esp_err_t beam_arq_tx_reset(beam_arq_tx_t *tx);
+
+/**
+ * @brief Resets a receiver's sequence state and counters.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if rx is NULL.
+ */
+esp_err_t beam_arq_rx_init(beam_arq_rx_t *rx);
+
+/**
+ * @brief Receiver: records a MSG_FLAG_ACK_REQ frame's sequence number and builds the ACK it needs.
+ *
+ * Frames without MSG_FLAG_ACK_REQ, including MSG_CAT_ACK frames, are not part of this
+ * sequence space; they are delivered untracked (track them with beam_seq if needed).
+ * A MSG_FLAG_ACK_REQ frame BEAM_SEQ_WINDOW_SIZE or more behind the newest one cannot be
+ * told apart from a lost one; the sender never retransmits that far back, so it is
+ * dropped without an ACK and counted as stale. BEAM_ARQ_RESYNC_STALE stale frames in a
+ * row mean the sender restarted its counter (e.g. after a reboot): the receiver then
+ * forgets its window and accepts the frame as the first of a new sequence, and the ones
+ * dropped before it are accepted when they are retransmitted.
+ *
+ * @param rx Receiver state of the sender. Must not be NULL.
+ * @param view Validated frame. Must not be NULL.
+ * @param[out] out_deliver Set to false for duplicates (e.g. a retransmission whose ACK was lost)
+ *                         and stale frames; pass the frame on only if true. Must not be NULL.
+ * @param[out] out_ack Receives the ACK frame to send back, or len 0 if there is none to send.
+ *                     Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if any pointer is NULL.
+ */
+esp_err_t beam_arq_receive(beam_arq_rx_t *rx,
+                           const beam_frame_view_t *view,
+                           bool *out_deliver,
+                           beam_frame_buf_t *out_ack);
+
+/**
+ * @brief Copies a receiver's counters.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if rx or out_stats is NULL.
+ */
+esp_err_t beam_arq_rx_get_stats(const beam_arq_rx_t *rx, beam_arq_rx_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_ARQ_H */
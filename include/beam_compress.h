@@ -0,0 +1,105 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_COMPRESS_H
+#define BEAM_COMPRESS_H
+
+#include "beam_frame_view.h"
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Byte-oriented LZ77 codec for payloads sent with MSG_FLAG_COMPRESSED, in the style of
+ * LZ4 block format scaled down to one frame. The stream is a series of sequences:
+ *
+ *   token   high nibble: literal count, low nibble: match length - BEAM_COMPRESS_MIN_MATCH
+ *           (15 in either nibble: add the following bytes, each 255 continues)
+ *   literals
+ *   offset  1 byte, distance back into the output (1 to 255)
+ *
+ * The last sequence carries literals only and ends the stream. Payloads are at most
+ * MAX_PAYLOAD_SIZE bytes, so one offset byte reaches any earlier position and the match
+ * finder needs only a small hash table on the stack: no static state, no heap, safe to
+ * call from several tasks at once.
+ */
+
+#define BEAM_COMPRESS_MIN_MATCH 3u /**< Shortest back-reference worth encoding */
+
+/**
+ * @brief Compresses src into dst.
+ *
+ * Fails without logging when the result would not fit dst_cap, so passing
+ * dst_cap = src_len - 1 both bounds the output and tests whether compression pays off.
+ *
+ * @param src Data to compress.
+ * @param src_len Bytes in src, at most MAX_PAYLOAD_SIZE.
+ * @param[out] dst Output buffer.
+ * @param dst_cap Capacity of dst in bytes.
+ * @param[out] out_len Receives the compressed length. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if src (with src_len > 0), dst or out_len is NULL.
+ *         ESP_ERR_INVALID_SIZE if src_len exceeds MAX_PAYLOAD_SIZE or the output does not fit.
+ */
+esp_err_t beam_compress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap, size_t *out_len);
+
+/**
+ * @brief Decompresses a stream produced by beam_compress().
+ *
+ * Malformed input from the air is rejected without logging.
+ *
+ * @param src Compressed stream.
+ * @param src_len Bytes in src.
+ * @param[out] dst Output buffer.
+ * @param dst_cap Capacity of dst in bytes.
+ * @param[out] out_len Receives the decompressed length. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if src, dst or out_len is NULL.
+ *         ESP_ERR_INVALID_SIZE if the stream is truncated, refers before the start of the
+ *         output or decompresses to more than dst_cap bytes.
+ */
+esp_err_t beam_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap, size_t *out_len);
+
+/**
+ * @brief Copies the payload of a validated frame, decompressing it if the frame carries
+ *        MSG_FLAG_COMPRESSED.
+ *
+ * The zero-copy view path does not decompress; use this where beam_parse_into_frame()
+ * would be used for frames from beam_parse_view() or beam_parse_batch().
+ *
+ * @param view View of a valid frame.
+ * @param[out] dst Output buffer; MAX_PAYLOAD_SIZE bytes always suffice.
+ * @param dst_cap Capacity of dst in bytes.
+ * @param[out] out_len Receives the payload length. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if view, dst or out_len is NULL.
+ *         ESP_ERR_INVALID_SIZE as for beam_decompress(), or if an uncompressed payload
+ *         does not fit dst_cap.
+ */
+esp_err_t beam_decompress_view(const beam_frame_view_t *view, uint8_t *dst, size_t dst_cap, size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_COMPRESS_H */
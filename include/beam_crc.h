@@ -0,0 +1,102 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_CRC_H
+#define BEAM_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BEAM_CRC_INIT UINT16_MAX ///< CRC value to start a frame checksum with (0xFFFF)
+
+/*
+ * All backends compute CRC-16-CCITT (polynomial 0x1021, MSB first) with the same
+ * conventions as esp_rom_crc16_be(): the input crc and the result are bit-inverted, so the
+ * result of one call can be passed as crc to the next to continue over more data.
+ * Outputs are bit-identical across backends.
+ */
+
+/**
+ * @brief CRC-16-CCITT using the backend selected in Kconfig (CONFIG_BEAM_CRC_BACKEND_*).
+ *
+ * This is what the parser and serializer use.
+ *
+ * @param crc BEAM_CRC_INIT for the first block, or the result of the previous call.
+ * @param data Bytes to checksum.
+ * @param len Number of bytes.
+ *
+ * @return Updated CRC.
+ */
+uint16_t beam_crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief CRC-16-CCITT computed by the ROM routine (esp_rom_crc16_be).
+ */
+uint16_t beam_crc16_rom(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief CRC-16-CCITT using one 256-entry lookup table (512 bytes), one byte per step.
+ */
+uint16_t beam_crc16_table(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief CRC-16-CCITT using four 256-entry lookup tables (2 KiB), four bytes per step.
+ */
+uint16_t beam_crc16_slice4(uint16_t crc, const uint8_t *data, size_t len);
+
+/**
+ * @brief Incremental CRC state for data that arrives or is produced in pieces.
+ *
+ * Feeding a frame through beam_crc_update() in any split gives the same result as one
+ * beam_crc16() call over the whole frame.
+ */
+typedef struct beam_crc_ctx {
+    uint16_t crc; ///< Running CRC value
+} beam_crc_ctx_t;
+
+/**
+ * @brief Starts a new checksum.
+ */
+static inline void beam_crc_init(beam_crc_ctx_t *ctx)
+{
+    ctx->crc = BEAM_CRC_INIT;
+}
+
+/**
+ * @brief Adds len bytes to the checksum using the configured backend.
+ */
+static inline void beam_crc_update(beam_crc_ctx_t *ctx, const uint8_t *data, size_t len)
+{
+    ctx->crc = beam_crc16(ctx->crc, data, len);
+}
+
+/**
+ * @brief CRC of all bytes fed so far. The context may continue to be updated.
+ */
+static inline uint16_t beam_crc_final(const beam_crc_ctx_t *ctx)
+{
+    return ctx->crc;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_CRC_H */
@@ -0,0 +1,125 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_DISPATCHER_H
+#define BEAM_DISPATCHER_H
+
+#include "beam_frame_view.h"
+#include "beam_message_common.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BEAM_DISPATCH_MAX_SUBSCRIBERS CONFIG_BEAM_DISPATCH_MAX_SUBSCRIBERS ///< Handler slots per dispatcher
+
+/**
+ * @brief Frame handler. The view is only valid during the call.
+ */
+typedef void (*beam_frame_handler_t)(const beam_frame_view_t *view, void *ctx);
+
+/**
+ * @brief One registered handler, chained per category by index.
+ */
+typedef struct beam_subscriber {
+    beam_frame_handler_t handler; ///< NULL if the slot is free
+    void *ctx;                    ///< User context passed to handler
+    uint8_t next;                 ///< Next subscriber of the same category, or UINT8_MAX
+} beam_subscriber_t;
+
+/**
+ * @brief Routes frames to handlers by msg_category. Treat the fields as private.
+ *
+ * Lookup is a direct index into a 256-entry table, so reaching the first handler
+ * takes a bounded number of steps regardless of how many categories are in use.
+ * Subscribing and unsubscribing must not run concurrently with beam_dispatch().
+ */
+typedef struct beam_dispatcher {
+    uint8_t head[256];                                            ///< First subscriber per category
+    beam_subscriber_t subscribers[BEAM_DISPATCH_MAX_SUBSCRIBERS]; ///< Subscriber slots
+    beam_frame_handler_t fallback;                                ///< Handler for categories nobody subscribed to
+    void *fallback_ctx;                                           ///< User context passed to fallback
+} beam_dispatcher_t;
+
+/**
+ * @brief Initializes a dispatcher with no subscribers and no fallback.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if dispatcher is NULL.
+ */
+esp_err_t beam_dispatcher_init(beam_dispatcher_t *dispatcher);
+
+/**
+ * @brief Registers handler for frames of category. Handlers of one category run in subscription order.
+ *
+ * @param dispatcher Initialized dispatcher. Must not be NULL.
+ * @param category Message category to subscribe to.
+ * @param handler Handler to call. Must not be NULL.
+ * @param ctx User context passed to handler.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if dispatcher or handler is NULL.
+ *         ESP_ERR_NO_MEM if all BEAM_DISPATCH_MAX_SUBSCRIBERS slots are taken.
+ */
+esp_err_t beam_subscribe(beam_dispatcher_t *dispatcher,
+                         beam_msg_category_t category,
+                         beam_frame_handler_t handler,
+                         void *ctx);
+
+/**
+ * @brief Removes a handler registered with beam_subscribe() (same category, handler and ctx).
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if dispatcher or handler is NULL.
+ *         ESP_ERR_NOT_FOUND if no such subscription exists.
+ */
+esp_err_t beam_unsubscribe(beam_dispatcher_t *dispatcher,
+                           beam_msg_category_t category,
+                           beam_frame_handler_t handler,
+                           void *ctx);
+
+/**
+ * @brief Sets the raw/unknown handler, called for frames whose category has no subscribers.
+ *
+ * @param dispatcher Initialized dispatcher. Must not be NULL.
+ * @param handler Fallback handler, or NULL to drop such frames.
+ * @param ctx User context passed to handler.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if dispatcher is NULL.
+ */
+esp_err_t beam_dispatcher_set_fallback(beam_dispatcher_t *dispatcher, beam_frame_handler_t handler, void *ctx);
+
+/**
+ * @brief Calls every handler subscribed to the frame's category, or the fallback.
+ *
+ * @param dispatcher Initialized dispatcher. Must not be NULL.
+ * @param view Validated frame (e.g. from beam_parse_view()). Must not be NULL.
+ *
+ * @return ESP_OK if at least one handler ran.
+ *         ESP_ERR_INVALID_ARG if dispatcher or view is NULL.
+ *         ESP_ERR_NOT_FOUND if there was no subscriber and no fallback.
+ */
+esp_err_t beam_dispatch(const beam_dispatcher_t *dispatcher, const beam_frame_view_t *view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_DISPATCHER_H */
@@ -0,0 +1,214 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_FRAG_H
+#define BEAM_FRAG_H
+
+#include "beam_arq.h"
+#include "beam_frame.h"
+#include "beam_frame_view.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Messages longer than MAX_PAYLOAD_SIZE travel as MSG_CAT_FRAGMENT frames whose payload
+ * is [category][msg_id][index][count] followed by up to BEAM_FRAG_DATA_SIZE message
+ * bytes. The sender hands all fragments of a message to the ARQ sender (beam_arq.h)
+ * back to back with MSG_FLAG_ACK_REQ, so they are pipelined up to BEAM_ARQ_WINDOW_SIZE
+ * deep and the selective ACK bitmap retransmits only the lost ones. The receiver keeps
+ * each fragment in a frame pool buffer until the message is complete, with at most
+ * BEAM_FRAG_MAX_REASSEMBLIES messages in progress and a timeout for abandoned ones.
+ *
+ * One beam_frag_tx_t / beam_frag_rx_t per peer and direction, used from a single task.
+ */
+
+#define BEAM_FRAG_HEADER_SIZE 4u                                                   ///< category, msg_id, index, count
+#define BEAM_FRAG_DATA_SIZE (MAX_PAYLOAD_SIZE - BEAM_FRAG_HEADER_SIZE)             ///< Message bytes per fragment
+#define BEAM_FRAG_MAX_FRAGMENTS CONFIG_BEAM_FRAG_MAX_FRAGMENTS                     ///< Fragments per message
+#define BEAM_FRAG_MAX_MESSAGE_SIZE (BEAM_FRAG_MAX_FRAGMENTS * BEAM_FRAG_DATA_SIZE) ///< Largest message
+#define BEAM_FRAG_MAX_REASSEMBLIES CONFIG_BEAM_FRAG_MAX_REASSEMBLIES               ///< Reassemblies per receiver
+#define BEAM_FRAG_TIMEOUT_US (CONFIG_BEAM_FRAG_TIMEOUT_MS * 1000)                  ///< Idle reassembly lifetime
+
+/**
+ * @brief Sender state for one message at a time. Treat the fields as private.
+ */
+typedef struct beam_frag_tx {
+    const uint8_t *data;          ///< Message being sent; must stay valid until beam_frag_tx_pump() returns ESP_OK
+    size_t len;                   ///< Message length in bytes
+    beam_msg_category_t category; ///< Category delivered to the receiver
+    uint8_t msg_id;               ///< Identifier of the current message
+    uint8_t next_index;           ///< Next fragment to hand to the ARQ sender
+    uint8_t count;                ///< Fragments in the current message, 0 when idle
+} beam_frag_tx_t;
+
+/**
+ * @brief A completed message, valid for the duration of the delivery callback.
+ */
+typedef struct beam_frag_message {
+    beam_msg_category_t category;       ///< Category given to beam_frag_tx_start()
+    uint8_t msg_id;                     ///< Sender's message identifier
+    uint8_t count;                      ///< Number of fragments
+    size_t len;                         ///< Total message length in bytes
+    beam_frame_buf_t *const *fragments; ///< count fragment frames in message order
+} beam_frag_message_t;
+
+/**
+ * @brief Receives each completed message. Copy it out with beam_frag_message_copy();
+ *        its buffers return to the pool when the callback returns.
+ */
+typedef void (*beam_frag_deliver_cb_t)(const beam_frag_message_t *message, void *ctx);
+
+/**
+ * @brief Receiver counters.
+ */
+typedef struct beam_frag_stats {
+    uint32_t completed; ///< Messages delivered
+    uint32_t timeouts;  ///< Reassemblies dropped by BEAM_FRAG_TIMEOUT_US
+    uint32_t dropped;   ///< Reassemblies dropped for lack of a slot or pool buffer
+    uint32_t malformed; ///< Fragments with an inconsistent header
+} beam_frag_stats_t;
+
+/**
+ * @brief One message being reassembled.
+ */
+typedef struct beam_frag_slot {
+    beam_frame_buf_t *fragments[BEAM_FRAG_MAX_FRAGMENTS]; ///< Received fragments by index, NULL if missing
+    int64_t last_us;                                      ///< Time of the last new fragment
+    beam_msg_category_t category;                         ///< Category of the message
+    uint8_t msg_id;                                       ///< Sender's message identifier
+    uint8_t count;                                        ///< Fragments expected, 0 if the slot is free
+    uint8_t received;                                     ///< Fragments stored so far
+} beam_frag_slot_t;
+
+/**
+ * @brief Receiver state for one sender. Treat the fields as private.
+ */
+typedef struct beam_frag_rx {
+    beam_frag_slot_t slots[BEAM_FRAG_MAX_REASSEMBLIES]; ///< Messages in progress
+    beam_frag_deliver_cb_t deliver;                     ///< Completed message sink
+    void *ctx;                                          ///< User context passed to deliver
+    beam_frag_stats_t stats;                            ///< Counters
+} beam_frag_rx_t;
+
+/**
+ * @brief Initializes a sender.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tx is NULL.
+ */
+esp_err_t beam_frag_tx_init(beam_frag_tx_t *tx);
+
+/**
+ * @brief Starts sending a message. Nothing is transmitted until beam_frag_tx_pump().
+ *
+ * @param tx Initialized sender. Must not be NULL.
+ * @param category Category the receiver sees for the reassembled message.
+ * @param data Message bytes. Must stay valid until beam_frag_tx_pump() returns ESP_OK.
+ * @param len Message length, 1 to BEAM_FRAG_MAX_MESSAGE_SIZE bytes.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tx or data is NULL.
+ *         ESP_ERR_INVALID_SIZE if len is 0 or exceeds BEAM_FRAG_MAX_MESSAGE_SIZE.
+ *         ESP_ERR_INVALID_STATE if the previous message has not been fully pumped.
+ */
+esp_err_t beam_frag_tx_start(beam_frag_tx_t *tx, beam_msg_category_t category, const uint8_t *data, size_t len);
+
+/**
+ * @brief Hands as many pending fragments to the ARQ sender as its window and the pool allow.
+ *
+ * Call after beam_frag_tx_start() and again whenever ACKs free window space, e.g. next
+ * to beam_arq_poll(). A fragment whose first transmission fails stays retained by the
+ * ARQ sender and is retried by it, so it counts as handed over.
+ *
+ * @param tx Sender. Must not be NULL.
+ * @param arq ARQ sender of the destination, which numbers the fragments. Must not be NULL.
+ * @param now_us Current time in microseconds.
+ *
+ * @return ESP_OK once every fragment has been handed over (and when idle).
+ *         ESP_ERR_NOT_FINISHED if fragments remain; call again later.
+ *         ESP_ERR_INVALID_ARG if any pointer is NULL.
+ */
+esp_err_t beam_frag_tx_pump(beam_frag_tx_t *tx, beam_arq_tx_t *arq, int64_t now_us);
+
+/**
+ * @brief Initializes a receiver.
+ *
+ * @param rx Receiver state. Must not be NULL.
+ * @param deliver Completed message sink. Must not be NULL.
+ * @param ctx User context passed to deliver.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if rx or deliver is NULL.
+ */
+esp_err_t beam_frag_rx_init(beam_frag_rx_t *rx, beam_frag_deliver_cb_t deliver, void *ctx);
+
+/**
+ * @brief Stores one fragment and delivers its message once complete.
+ *
+ * Pass only frames beam_arq_receive() said to deliver, so retransmitted duplicates are
+ * filtered out. Errors concern fragments from the air and are not logged.
+ *
+ * @param rx Initialized receiver. Must not be NULL.
+ * @param view Validated MSG_CAT_FRAGMENT frame. Must not be NULL.
+ * @param now_us Current time in microseconds.
+ *
+ * @return ESP_OK if the fragment was stored (or was a duplicate).
+ *         ESP_ERR_INVALID_ARG if rx or view is NULL, or the frame is not MSG_CAT_FRAGMENT.
+ *         ESP_ERR_INVALID_SIZE if the fragment header is inconsistent.
+ *         ESP_ERR_NO_MEM if no reassembly slot or pool buffer was free; the message is dropped.
+ */
+esp_err_t beam_frag_rx_handle(beam_frag_rx_t *rx, const beam_frame_view_t *view, int64_t now_us);
+
+/**
+ * @brief Drops reassemblies that received nothing for BEAM_FRAG_TIMEOUT_US. Call periodically.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if rx is NULL.
+ */
+esp_err_t beam_frag_rx_poll(beam_frag_rx_t *rx, int64_t now_us);
+
+/**
+ * @brief Drops all reassemblies and returns their buffers to the pool.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if rx is NULL.
+ */
+esp_err_t beam_frag_rx_reset(beam_frag_rx_t *rx);
+
+/**
+ * @brief Copies a completed message into a contiguous buffer.
+ *
+ * @param message Message passed to the delivery callback. Must not be NULL.
+ * @param[out] dst Destination. Must not be NULL.
+ * @param dst_cap Capacity of dst; at least message->len.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if message or dst is NULL.
+ *         ESP_ERR_INVALID_SIZE if dst_cap is less than message->len.
+ */
+esp_err_t beam_frag_message_copy(const beam_frag_message_t *message, uint8_t *dst, size_t dst_cap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_FRAG_H */
@@ -19,6 +19,8 @@
 
 #include "beam_message_common.h"
 #include "beam_payload_type.h"
+#include "sdkconfig.h"
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -27,9 +29,33 @@ extern "C" {
 
 /* Total frame size for given payload length */
 #define FRAME_SIZE(len) ((size_t)FRAME_HEADER_SIZE + (size_t)(len) + (size_t)FRAME_CRC_SIZE)
-#define FRAME_MIN_SIZE FRAME_SIZE(0u) ///< Minimum frame size in bytes (header 4 + payload 0 + CRC 2).
-#define FRAME_HEADER_SIZE 4u          ///< Header bytes: msg_category + flags + seq + len
-#define FRAME_CRC_SIZE 2u             ///< CRC size in bytes
+#define FRAME_MIN_SIZE FRAME_SIZE(0u)               ///< Minimum frame size in bytes (header 4 + payload 0 + CRC 2).
+#define FRAME_MAX_SIZE FRAME_SIZE(MAX_PAYLOAD_SIZE) ///< Maximum frame size in bytes (header + MAX_PAYLOAD_SIZE + CRC).
+#define FRAME_HEADER_SIZE 4u                        ///< Header bytes: msg_category + flags + seq + len
+#define FRAME_CRC_SIZE 2u                           ///< CRC size in bytes
+#define FRAME_EXT_TS_SIZE 4u                        ///< MSG_FLAG_EXT_TS timestamp bytes, counted in the wire len
+
+/*
+ * With MSG_FLAG_EXT_TS the first FRAME_EXT_TS_SIZE bytes after the header are the
+ * sender's microsecond clock (low 32 bits, little-endian) and the payload follows them.
+ * The wire len counts the timestamp, so framing, CRC and FRAME_SIZE() do not change;
+ * only the payload moves. Views, beam_frame_header_t and beam_frame_t report the payload
+ * without it; beam_parse_into_frame_ts() and beam_serialize_frame_ts() carry the timestamp.
+ */
+#define FRAME_EXT_SIZE(flags) (((flags) & MSG_FLAG_EXT_TS) ? FRAME_EXT_TS_SIZE : 0u) ///< Bytes before the payload
+
+/* Byte offsets of the header fields on the wire */
+#define FRAME_OFFSET_CATEGORY 0u ///< Offset of msg_category
+#define FRAME_OFFSET_FLAGS 1u    ///< Offset of flags
+#define FRAME_OFFSET_SEQ 2u      ///< Offset of seq
+#define FRAME_OFFSET_LEN 3u      ///< Offset of len
+#define FRAME_OFFSET_TS 4u       ///< Offset of the MSG_FLAG_EXT_TS timestamp
+
+#if CONFIG_BEAM_COPY_PIE
+#define FRAME_BUF_ALIGN 16u ///< beam_frame_buf_t alignment: one PIE q register
+#else
+#define FRAME_BUF_ALIGN 4u ///< beam_frame_buf_t alignment: one word
+#endif
 
 /**
  * @brief BEAM frame header (4 bytes on wire: msg_category, flags, seq, len).
@@ -38,7 +64,7 @@ typedef struct __attribute__((packed)) beam_frame_header {
     beam_msg_category_t msg_category; ///< Message category (e.g. MSG_CAT_TELEMETRY, MSG_CAT_BATTERY, etc.)
     beam_flags_t flags;               ///< Bit mask (priority, requires ACK, etc.)
     uint8_t seq;                      ///< Packet sequence number for loss tracking
-    uint8_t len;                      ///< Length of the payload array (0 to MAX_PAYLOAD_SIZE)
+    uint8_t len;                      ///< Length of the payload array (0 to MAX_PAYLOAD_SIZE), without the timestamp
 } beam_frame_header_t;
 
 /**
@@ -53,6 +79,17 @@ typedef struct __attribute__((packed)) beam_frame {
     uint16_t crc;               ///< CRC-16-CCITT checksum for error detection
 } beam_frame_t;
 
+/**
+ * @brief Storage for one serialized frame.
+ *
+ * Aligned to FRAME_BUF_ALIGN so slots and pool buffers can be copied efficiently
+ * (with CONFIG_BEAM_COPY_PIE, by 16-byte vector moves).
+ */
+typedef struct beam_frame_buf {
+    uint8_t data[FRAME_MAX_SIZE] __attribute__((aligned(FRAME_BUF_ALIGN))); ///< Header, payload and CRC
+    uint16_t len;                                                           ///< Bytes used in data
+} beam_frame_buf_t;
+
 #ifdef __cplusplus
 }
 #endif
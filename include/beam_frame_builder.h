@@ -0,0 +1,170 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_FRAME_BUILDER_H
+#define BEAM_FRAME_BUILDER_H
+
+#include "beam_crc.h"
+#include "beam_frame.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief In-place frame builder state.
+ *
+ * Writes header and payload directly into the transmit buffer, so no intermediate
+ * beam_frame_t is needed. Multi-byte values are written little-endian, matching the
+ * packed payload structures. Treat the fields as private.
+ */
+typedef struct beam_frame_builder {
+    uint8_t *buf;         ///< Destination buffer (header starts at buf[0])
+    size_t cap;           ///< Capacity of buf in bytes
+    uint8_t len;          ///< Payload bytes written so far
+    uint8_t declared_len; ///< Payload length announced by beam_frame_begin_len()
+    bool streaming;       ///< CRC is updated as bytes are written (length known up front)
+    bool has_timestamp;   ///< beam_frame_put_timestamp() wrote the first payload bytes
+    beam_crc_ctx_t crc;   ///< Running CRC when streaming
+} beam_frame_builder_t;
+
+/**
+ * @brief Starts a frame: writes the header into buf with a zero payload length.
+ *
+ * @param builder Builder state to initialize. Must not be NULL.
+ * @param buf Transmit buffer. Must not be NULL.
+ * @param cap Capacity of buf in bytes. Must be at least FRAME_MIN_SIZE.
+ * @param category Message category (e.g. MSG_CAT_TELEMETRY).
+ * @param flags Header flags bit mask: MSG_FLAG_PRIORITY, MSG_FLAG_ACK_REQ, MSG_FLAG_EXT_TS.
+ *        The builder writes the payload bytes as given, so the encoding flags MSG_FLAG_COMPACT,
+ *        MSG_FLAG_DELTA and MSG_FLAG_COMPRESSED are rejected; send such payloads with
+ *        beam_serialize_frame().
+ * @param seq Packet sequence number.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if builder or buf is NULL, or flags has an encoding flag.
+ *         ESP_ERR_INVALID_SIZE if cap is less than FRAME_MIN_SIZE.
+ */
+esp_err_t beam_frame_begin(beam_frame_builder_t *builder,
+                           uint8_t *buf,
+                           size_t cap,
+                           beam_msg_category_t category,
+                           beam_flags_t flags,
+                           uint8_t seq);
+
+/**
+ * @brief Starts a frame whose payload length is known up front.
+ *
+ * The header is written complete, so the CRC is computed incrementally as each
+ * beam_frame_put_*() call writes its bytes (e.g. while sampling a sensor) and
+ * beam_frame_finish() only appends it.
+ *
+ * @param payload_len Exact number of payload bytes that will be written, including
+ *        FRAME_EXT_TS_SIZE for the timestamp of a MSG_FLAG_EXT_TS frame.
+ *
+ * Other parameters as for beam_frame_begin().
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if builder or buf is NULL, or flags has an encoding flag.
+ *         ESP_ERR_INVALID_SIZE if payload_len exceeds MAX_PAYLOAD_SIZE or FRAME_SIZE(payload_len) exceeds cap.
+ */
+esp_err_t beam_frame_begin_len(beam_frame_builder_t *builder,
+                               uint8_t *buf,
+                               size_t cap,
+                               beam_msg_category_t category,
+                               beam_flags_t flags,
+                               uint8_t seq,
+                               uint8_t payload_len);
+
+/**
+ * @brief Appends raw bytes to the payload.
+ *
+ * @param builder Builder started with beam_frame_begin(). Must not be NULL.
+ * @param data Bytes to append. May be NULL only if len is 0.
+ * @param len Number of bytes to append.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if builder or data is NULL.
+ *         ESP_ERR_INVALID_SIZE if the payload would exceed MAX_PAYLOAD_SIZE, the buffer capacity
+ *         or the length given to beam_frame_begin_len().
+ */
+esp_err_t beam_frame_put_bytes(beam_frame_builder_t *builder, const void *data, size_t len);
+
+/**
+ * @brief Appends one byte to the payload. Errors as for beam_frame_put_bytes().
+ */
+esp_err_t beam_frame_put_u8(beam_frame_builder_t *builder, uint8_t value);
+
+/**
+ * @brief Appends a 16-bit value (little-endian). Errors as for beam_frame_put_bytes().
+ */
+esp_err_t beam_frame_put_u16(beam_frame_builder_t *builder, uint16_t value);
+
+/**
+ * @brief Appends a 32-bit value (little-endian). Errors as for beam_frame_put_bytes().
+ */
+esp_err_t beam_frame_put_u32(beam_frame_builder_t *builder, uint32_t value);
+
+/**
+ * @brief Writes the MSG_FLAG_EXT_TS sender timestamp. Must come before any other put.
+ *
+ * @param builder Builder started with MSG_FLAG_EXT_TS in flags. Must not be NULL.
+ * @param timestamp_us Sender clock in microseconds, e.g. (uint32_t)esp_timer_get_time().
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if builder is NULL.
+ *         ESP_ERR_INVALID_STATE if the flag is not set or payload bytes were already written.
+ *         ESP_ERR_INVALID_SIZE as for beam_frame_put_bytes().
+ */
+esp_err_t beam_frame_put_timestamp(beam_frame_builder_t *builder, uint32_t timestamp_us);
+
+/**
+ * @brief Appends an IEEE-754 float (little-endian). Errors as for beam_frame_put_bytes().
+ */
+esp_err_t beam_frame_put_float(beam_frame_builder_t *builder, float value);
+
+/**
+ * @brief Appends a telemetry payload (roll, pitch, yaw). Errors as for beam_frame_put_bytes().
+ */
+esp_err_t beam_frame_put_telemetry(beam_frame_builder_t *builder, const beam_payload_telemetry_t *telemetry);
+
+/**
+ * @brief Appends a battery payload (voltage, current, percent). Errors as for beam_frame_put_bytes().
+ */
+esp_err_t beam_frame_put_battery(beam_frame_builder_t *builder, const beam_payload_battery_t *battery);
+
+/**
+ * @brief Completes the frame: patches header.len and appends the CRC.
+ *
+ * @param builder Builder started with beam_frame_begin(). Must not be NULL.
+ * @param[out] out_size Optional pointer to receive the total frame size in bytes. Can be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if builder is NULL.
+ *         ESP_ERR_INVALID_STATE if fewer bytes were written than announced to beam_frame_begin_len(),
+ *         or a MSG_FLAG_EXT_TS frame has no timestamp.
+ */
+esp_err_t beam_frame_finish(beam_frame_builder_t *builder, size_t *out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_FRAME_BUILDER_H */
@@ -0,0 +1,125 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_FRAME_VIEW_H
+#define BEAM_FRAME_VIEW_H
+
+#include "beam_frame.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Read-only view of a validated frame inside the caller's buffer.
+ *
+ * Filled by beam_parse_view(). Nothing is copied: the view stays valid only as long
+ * as the underlying buffer is alive and unchanged.
+ */
+typedef struct beam_frame_view {
+    const uint8_t *data; ///< First header byte of the frame in the caller's buffer
+    size_t size;         ///< Total frame size in bytes: FRAME_SIZE(header len)
+} beam_frame_view_t;
+
+/**
+ * @brief Frame header as laid out on the wire (byte-aligned, safe to dereference).
+ *
+ * This is the raw wire header: with MSG_FLAG_EXT_TS its len also counts the timestamp.
+ * Use beam_frame_view_payload_len() for the payload length.
+ */
+static inline const beam_frame_header_t *beam_frame_view_header(const beam_frame_view_t *view)
+{
+    return (const beam_frame_header_t *)view->data;
+}
+
+/**
+ * @brief Message category (e.g. MSG_CAT_TELEMETRY).
+ */
+static inline beam_msg_category_t beam_frame_view_category(const beam_frame_view_t *view)
+{
+    return view->data[FRAME_OFFSET_CATEGORY];
+}
+
+/**
+ * @brief Header flags bit mask (MSG_FLAG_*).
+ */
+static inline beam_flags_t beam_frame_view_flags(const beam_frame_view_t *view)
+{
+    return view->data[FRAME_OFFSET_FLAGS];
+}
+
+/**
+ * @brief Packet sequence number.
+ */
+static inline uint8_t beam_frame_view_seq(const beam_frame_view_t *view)
+{
+    return view->data[FRAME_OFFSET_SEQ];
+}
+
+/**
+ * @brief Payload length in bytes (0 to MAX_PAYLOAD_SIZE), without the MSG_FLAG_EXT_TS timestamp.
+ */
+static inline uint8_t beam_frame_view_payload_len(const beam_frame_view_t *view)
+{
+    return (uint8_t)(view->data[FRAME_OFFSET_LEN] - FRAME_EXT_SIZE(view->data[FRAME_OFFSET_FLAGS]));
+}
+
+/**
+ * @brief Pointer to the first payload byte. Interpret according to the category.
+ */
+static inline const uint8_t *beam_frame_view_payload(const beam_frame_view_t *view)
+{
+    return view->data + FRAME_HEADER_SIZE + FRAME_EXT_SIZE(view->data[FRAME_OFFSET_FLAGS]);
+}
+
+/**
+ * @brief True if the frame carries a sender timestamp (MSG_FLAG_EXT_TS).
+ */
+static inline bool beam_frame_view_has_timestamp(const beam_frame_view_t *view)
+{
+    return (view->data[FRAME_OFFSET_FLAGS] & MSG_FLAG_EXT_TS) != 0;
+}
+
+/**
+ * @brief Sender timestamp in microseconds (low 32 bits of its clock), or 0 without MSG_FLAG_EXT_TS.
+ */
+static inline uint32_t beam_frame_view_timestamp(const beam_frame_view_t *view)
+{
+    if (!beam_frame_view_has_timestamp(view)) {
+        return 0;
+    }
+    const uint8_t *ts = view->data + FRAME_OFFSET_TS;
+
+    return (uint32_t)ts[0] | ((uint32_t)ts[1] << 8) | ((uint32_t)ts[2] << 16) | ((uint32_t)ts[3] << 24);
+}
+
+/**
+ * @brief CRC as received (LSB first on the wire).
+ */
+static inline uint16_t beam_frame_view_crc(const beam_frame_view_t *view)
+{
+    const uint8_t *crc = view->data + view->size - FRAME_CRC_SIZE;
+    return (uint16_t)crc[0] | ((uint16_t)crc[1] << 8);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_FRAME_VIEW_H */
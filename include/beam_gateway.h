@@ -0,0 +1,190 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_GATEWAY_H
+#define BEAM_GATEWAY_H
+
+#include "beam_frame.h"
+#include "beam_frame_view.h"
+#include "beam_ring.h"
+#include "beam_seq.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Ground-station fan-in. beam_gateway_receive() runs in esp_now_recv_cb with the sender
+ * MAC: it finds the peer in an open-addressing hash table (linear probing over 8-byte
+ * entries, at most half full), drops duplicates by sequence number and queues the frame
+ * in that peer's own SPSC ring. beam_gateway_process() runs in an application task and
+ * serves the peer queues round-robin, one frame per peer per turn, so a chatty peer
+ * fills only its own queue and cannot delay the others.
+ *
+ * beam_gateway_receive() must be called from one task (the producer) and
+ * beam_gateway_process() from one task (the consumer). New peers are added by the
+ * producer and published to the consumer atomically; beam_gateway_remove_peer() must not
+ * run concurrently with either.
+ */
+
+#define BEAM_GATEWAY_MAX_PEERS CONFIG_BEAM_GATEWAY_MAX_PEERS     ///< Peers per gateway
+#define BEAM_GATEWAY_QUEUE_DEPTH CONFIG_BEAM_GATEWAY_QUEUE_DEPTH ///< Frames queued per peer (power of two)
+
+/** Smallest power of two >= n, for n in [1, 256] */
+#define BEAM_GATEWAY_POW2(n)                                                                                           \
+    ((((n) - 1) | ((n) - 1) >> 1 | ((n) - 1) >> 2 | ((n) - 1) >> 4 | ((n) - 1) >> 8) + 1)
+
+#define BEAM_GATEWAY_TABLE_SIZE BEAM_GATEWAY_POW2(2 * BEAM_GATEWAY_MAX_PEERS) ///< Hash slots, load factor <= 1/2
+
+/**
+ * @brief Per-peer counters.
+ */
+typedef struct beam_gateway_peer_stats {
+    beam_seq_stats_t seq; ///< Sequence tracking of best-effort frames (received, duplicates, reordered, lost)
+    uint32_t queued;      ///< Frames queued for processing
+    uint32_t queue_full;  ///< Frames dropped because the peer's queue was full
+    int64_t last_seen_us; ///< Time of the last valid frame
+} beam_gateway_peer_stats_t;
+
+/**
+ * @brief State of one peer. Treat the fields as private.
+ */
+typedef struct beam_gateway_peer {
+    beam_ring_t queue;         ///< Frames waiting for beam_gateway_process()
+    beam_seq_state_t seq;      ///< Sequence state of best-effort frames
+    uint32_t queued;           ///< See beam_gateway_peer_stats_t
+    uint32_t queue_full;       ///< See beam_gateway_peer_stats_t
+    int64_t last_seen_us;      ///< See beam_gateway_peer_stats_t
+    uint8_t mac[BEAM_MAC_LEN]; ///< Peer address
+    bool active;               ///< Entry in use; published with release semantics
+} beam_gateway_peer_t;
+
+/**
+ * @brief Hash table entry: the MAC inline so probing touches only this array.
+ */
+typedef struct beam_gateway_slot {
+    uint8_t mac[BEAM_MAC_LEN]; ///< Peer address
+    uint8_t peer;              ///< Index into peers[]
+    uint8_t state;             ///< Empty or used
+} beam_gateway_slot_t;
+
+/**
+ * @brief Gateway state; several KiB, so give it static storage. Treat the fields as private.
+ */
+typedef struct beam_gateway {
+    beam_gateway_slot_t table[BEAM_GATEWAY_TABLE_SIZE];                             ///< MAC -> peer index
+    beam_gateway_peer_t peers[BEAM_GATEWAY_MAX_PEERS];                              ///< Peer states
+    beam_frame_buf_t queue_slots[BEAM_GATEWAY_MAX_PEERS][BEAM_GATEWAY_QUEUE_DEPTH]; ///< Per-peer ring storage
+    uint8_t next_peer;                                                              ///< Round-robin cursor (consumer)
+    uint32_t table_full;                                                            ///< New peers rejected, table full
+} beam_gateway_t;
+
+/**
+ * @brief Handles one frame of a peer, called from beam_gateway_process().
+ *
+ * The view is valid only during the call.
+ */
+typedef void (*beam_gateway_handler_t)(const uint8_t *mac, const beam_frame_view_t *view, void *ctx);
+
+/**
+ * @brief Initializes an empty gateway.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if gw is NULL.
+ */
+esp_err_t beam_gateway_init(beam_gateway_t *gw);
+
+/**
+ * @brief Producer: validates a received frame and queues it for its peer.
+ *
+ * Unknown peers are added on their first valid frame. Duplicates (see beam_seq.h) are
+ * dropped without being queued. MSG_FLAG_ACK_REQ and MSG_CAT_ACK frames have their own
+ * sequence space (see beam_arq.h), so they are queued untracked: pass them to
+ * beam_arq_receive(), which must see retransmitted duplicates to ACK them again.
+ *
+ * @param gw Initialized gateway. Must not be NULL.
+ * @param mac Sender address from esp_now_recv_cb, BEAM_MAC_LEN bytes. Must not be NULL.
+ * @param data Raw frame bytes. Must not be NULL.
+ * @param data_len Length of data.
+ * @param now_us Current time in microseconds, stored as the peer's last-seen time.
+ *
+ * @return ESP_OK if the frame was queued.
+ *         ESP_ERR_INVALID_ARG if gw, mac or data is NULL.
+ *         ESP_ERR_INVALID_SIZE / ESP_ERR_INVALID_CRC as for beam_parse_view().
+ *         ESP_ERR_INVALID_STATE if the frame is a duplicate.
+ *         ESP_ERR_NO_MEM if the peer's queue is full or the peer is new and the table is full.
+ */
+esp_err_t beam_gateway_receive(beam_gateway_t *gw,
+                               const uint8_t *mac,
+                               const uint8_t *data,
+                               size_t data_len,
+                               int64_t now_us);
+
+/**
+ * @brief Consumer: hands queued frames to handler, one per peer in turn.
+ *
+ * Each turn starts after the peer served last by the previous call, so every peer with
+ * queued frames is served before any peer gets a second frame.
+ *
+ * @param gw Initialized gateway. Must not be NULL.
+ * @param handler Frame handler. Must not be NULL.
+ * @param ctx User context passed to handler.
+ * @param max_frames Upper bound on frames handled by this call.
+ * @param[out] out_handled Optional; receives the number of frames handled. Can be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if gw or handler is NULL.
+ */
+esp_err_t beam_gateway_process(beam_gateway_t *gw,
+                               beam_gateway_handler_t handler,
+                               void *ctx,
+                               size_t max_frames,
+                               size_t *out_handled);
+
+/**
+ * @brief Copies the counters of one peer.
+ *
+ * Counters are written by the producer; read from another task they may be one frame behind.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if any pointer is NULL.
+ *         ESP_ERR_NOT_FOUND if the peer is unknown.
+ */
+esp_err_t beam_gateway_get_peer_stats(const beam_gateway_t *gw,
+                                      const uint8_t *mac,
+                                      beam_gateway_peer_stats_t *out_stats);
+
+/**
+ * @brief Forgets a peer and discards its queued frames, e.g. after a long silence.
+ *
+ * Must not run concurrently with beam_gateway_receive() or beam_gateway_process().
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if gw or mac is NULL.
+ *         ESP_ERR_NOT_FOUND if the peer is unknown.
+ */
+esp_err_t beam_gateway_remove_peer(beam_gateway_t *gw, const uint8_t *mac);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_GATEWAY_H */
@@ -0,0 +1,134 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_LATENCY_H
+#define BEAM_LATENCY_H
+
+#include "beam_frame_view.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Per-stage latency histograms (CONFIG_BEAM_LATENCY_TRACE). A sender that sets
+ * MSG_FLAG_EXT_TS puts its microsecond clock in the frame (beam_frame_put_timestamp());
+ * each receive stage then records how long after that timestamp it saw the frame, so the
+ * p50 of successive stages shows where the end-to-end budget goes. beam_pipeline marks
+ * all four stages by itself; other receive paths call beam_latency_mark().
+ *
+ * Absolute values need sender and receiver on a shared timebase (e.g. both synchronised
+ * to a beacon); without one the RX figure carries the clock offset, but the differences
+ * between stages stay exact. Samples of a receiver clock behind the sender count as 0.
+ *
+ * Buckets are log-linear: exact below 8 us, then four per power of two up to about 1 s,
+ * so a reported percentile is the upper edge of its bucket, at most 25 % above the true
+ * value and never above max_us. Recording is a few relaxed atomic adds, safe from any
+ * task or ISR.
+ */
+
+#if CONFIG_BEAM_LATENCY_TRACE
+#define BEAM_LATENCY_MAX_CATEGORIES CONFIG_BEAM_LATENCY_MAX_CATEGORIES ///< Categories with histograms
+#else
+#define BEAM_LATENCY_MAX_CATEGORIES 0u ///< Tracing disabled
+#endif
+
+/**
+ * @brief Receive stages, in the order a frame passes them.
+ */
+typedef enum beam_latency_stage {
+    BEAM_LATENCY_STAGE_RX,       ///< Handed to the receiver (e.g. beam_pipeline_submit())
+    BEAM_LATENCY_STAGE_VALIDATE, ///< Passed length and CRC checks
+    BEAM_LATENCY_STAGE_ENQUEUE,  ///< Queued for dispatch
+    BEAM_LATENCY_STAGE_DISPATCH, ///< Handed to the subscribers
+    BEAM_LATENCY_STAGE_COUNT,    ///< Number of stages
+} beam_latency_stage_t;
+
+/**
+ * @brief Latency distribution of one category at one stage.
+ */
+typedef struct beam_latency_summary {
+    uint32_t count;  ///< Samples recorded
+    uint32_t p50_us; ///< Median; 0 if no samples
+    uint32_t p99_us; ///< 99th percentile; 0 if no samples
+    uint32_t max_us; ///< Largest sample
+} beam_latency_summary_t;
+
+/**
+ * @brief Records one latency sample.
+ *
+ * The first BEAM_LATENCY_MAX_CATEGORIES categories seen get histograms; samples of
+ * further categories are not recorded.
+ *
+ * @param category Message category of the frame.
+ * @param stage Stage the sample belongs to.
+ * @param latency_us Time since the sender timestamp.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if stage is out of range.
+ *         ESP_ERR_NOT_FOUND if every histogram is taken by other categories.
+ *         ESP_ERR_NOT_SUPPORTED if CONFIG_BEAM_LATENCY_TRACE is disabled.
+ */
+esp_err_t beam_latency_record(beam_msg_category_t category, beam_latency_stage_t stage, uint32_t latency_us);
+
+/**
+ * @brief Records now_us minus the sender timestamp of a validated frame.
+ *
+ * @param view Validated frame. Must not be NULL.
+ * @param stage Stage the frame has reached.
+ * @param now_us Receiver clock, e.g. esp_timer_get_time(); only the low 32 bits are used.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if view is NULL or stage is out of range.
+ *         ESP_ERR_NOT_FOUND if the frame has no MSG_FLAG_EXT_TS, or as for beam_latency_record().
+ *         ESP_ERR_NOT_SUPPORTED if CONFIG_BEAM_LATENCY_TRACE is disabled.
+ */
+esp_err_t beam_latency_mark(const beam_frame_view_t *view, beam_latency_stage_t stage, int64_t now_us);
+
+/**
+ * @brief Reads the distribution of one category at one stage.
+ *
+ * Buckets are read one by one without stopping recorders, so a sample recorded
+ * meanwhile may be missing from count and the percentiles.
+ *
+ * @param category Message category.
+ * @param stage Stage to read.
+ * @param[out] out_summary Receives the distribution. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if out_summary is NULL or stage is out of range.
+ *         ESP_ERR_NOT_FOUND if no sample of category was recorded.
+ *         ESP_ERR_NOT_SUPPORTED if CONFIG_BEAM_LATENCY_TRACE is disabled.
+ */
+esp_err_t beam_latency_get(beam_msg_category_t category,
+                           beam_latency_stage_t stage,
+                           beam_latency_summary_t *out_summary);
+
+/**
+ * @brief Clears all histograms and frees them for new categories.
+ *
+ * Samples recorded while the reset runs may be lost or kept.
+ */
+void beam_latency_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_LATENCY_H */
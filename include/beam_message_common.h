@@ -31,11 +31,18 @@ typedef uint8_t beam_flags_t;
 
 #define MSG_FLAG_PRIORITY BEAM_BIT(0)
 #define MSG_FLAG_ACK_REQ BEAM_BIT(1)
+#define MSG_FLAG_COMPACT BEAM_BIT(2)    ///< Fixed-point payload encoding (see beam_telemetry.h)
+#define MSG_FLAG_DELTA BEAM_BIT(3)      ///< With MSG_FLAG_COMPACT: delta against a keyframe
+#define MSG_FLAG_COMPRESSED BEAM_BIT(4) ///< LZ-compressed payload (see beam_compress.h)
+#define MSG_FLAG_EXT_TS BEAM_BIT(5)     ///< Sender timestamp after the header (see beam_latency.h)
 
 typedef uint8_t beam_msg_category_t;
 typedef enum beam_message_category {
-    MSG_CAT_TELEMETRY, ///< Orientation data
-    MSG_CAT_BATTERY,   ///< Battery data
+    MSG_CAT_TELEMETRY,        ///< Orientation data
+    MSG_CAT_BATTERY,          ///< Battery data
+    MSG_CAT_FRAGMENT = 0xFC,  ///< Part of a message longer than MAX_PAYLOAD_SIZE (see beam_frag.h)
+    MSG_CAT_AGGREGATE = 0xFD, ///< Several sub-messages in one frame (see beam_aggregate.h)
+    MSG_CAT_ACK = 0xFE,       ///< Selective acknowledgement (see beam_arq.h)
 } beam_message_category_t;
 
 #endif /* BEAM_MESSAGE_COMMON_H */
\ No newline at end of file
@@ -18,6 +18,8 @@
 #define BEAM_PARSER_H
 
 #include "beam_frame.h"
+#include "beam_frame_view.h"
+#include "beam_telemetry.h"
 #include "esp_err.h"
 #include <stdbool.h>
 #include <stddef.h>
@@ -27,6 +29,14 @@
 extern "C" {
 #endif
 
+/**
+ * @brief One received packet for beam_parse_batch().
+ */
+typedef struct beam_rx_slice {
+    const uint8_t *data; ///< Raw packet bytes
+    size_t len;          ///< Packet length in bytes
+} beam_rx_slice_t;
+
 /**
  * @brief Parses a raw buffer into frame.
  *
@@ -40,24 +50,163 @@ extern "C" {
  *         ESP_ERR_INVALID_CRC if the CRC does not match.
  *
  * @note Use FRAME_MIN_SIZE for minimum buffer length.
+ * @note Compact telemetry keyframes (MSG_FLAG_COMPACT) arrive as the float payload, with header.len
+ *       and header.flags describing it. Delta frames need the sender's keyframe and are copied as
+ *       received; parse with beam_parse_into_frame_telemetry() to expand them too.
+ * @note Compressed payloads (MSG_FLAG_COMPRESSED) are decompressed the same way; a malformed
+ *       stream fails with ESP_ERR_INVALID_SIZE.
  */
 esp_err_t beam_parse_into_frame(const uint8_t *data, size_t data_len, beam_frame_t *out_frame);
 
+/**
+ * @brief Parses a raw buffer into frame and returns its MSG_FLAG_EXT_TS sender timestamp.
+ *
+ * Same as beam_parse_into_frame(); the timestamp is returned separately so that
+ * beam_frame_t keeps the wire layout. header.len does not count it.
+ *
+ * @param data Raw byte array from esp_now_recv_cb.
+ * @param data_len Length of the received data.
+ * @param out_frame Pointer to the frame to fill if valid.
+ * @param[out] out_timestamp_us Sender clock in microseconds, 0 without MSG_FLAG_EXT_TS.
+ *
+ * @return See beam_parse_into_frame(); ESP_ERR_INVALID_ARG also if out_timestamp_us is NULL.
+ */
+esp_err_t beam_parse_into_frame_ts(const uint8_t *data,
+                                   size_t data_len,
+                                   beam_frame_t *out_frame,
+                                   uint32_t *out_timestamp_us);
+
+/**
+ * @brief Parses a raw buffer into frame, expanding compact telemetry deltas as well as keyframes.
+ *
+ * Same as beam_parse_into_frame(), but every MSG_FLAG_COMPACT telemetry frame, delta or keyframe,
+ * is decoded with decoder and arrives as the float payload with MSG_FLAG_COMPACT and MSG_FLAG_DELTA
+ * cleared. Keyframes update decoder; keep one decoder per sender.
+ *
+ * @param data Raw byte array from esp_now_recv_cb.
+ * @param data_len Length of the received data.
+ * @param out_frame Pointer to the frame to fill if valid.
+ * @param decoder Initialized decoder of the sender (see beam_telemetry.h). Must not be NULL.
+ *
+ * @return See beam_parse_into_frame(); ESP_ERR_INVALID_ARG also if decoder is NULL.
+ *         ESP_ERR_INVALID_SIZE also for a compact payload whose length does not match its encoding.
+ *         ESP_ERR_NOT_FOUND if a delta refers to a keyframe decoder has not seen (not counted in beam_stats).
+ */
+esp_err_t beam_parse_into_frame_telemetry(const uint8_t *data,
+                                          size_t data_len,
+                                          beam_frame_t *out_frame,
+                                          beam_telemetry_decoder_t *decoder);
+
+/**
+ * @brief Validates a raw buffer and returns a zero-copy view of the frame.
+ *
+ * Performs the same length and CRC checks as beam_parse_into_frame() but copies nothing:
+ * out_view points into data, so data must outlive the view. Compressed payloads are left
+ * as received; read them with beam_decompress_view().
+ *
+ * @param data Raw byte array from esp_now_recv_cb.
+ * @param data_len Length of the received data.
+ * @param[out] out_view View to fill if the frame is valid.
+ *
+ * @return ESP_OK if the frame is valid.
+ *         ESP_ERR_INVALID_ARG if data or out_view is NULL.
+ *         ESP_ERR_INVALID_SIZE if data_len is too short or payload length is invalid.
+ *         ESP_ERR_INVALID_CRC if the CRC does not match.
+ */
+esp_err_t beam_parse_view(const uint8_t *data, size_t data_len, beam_frame_view_t *out_view);
+
+/**
+ * @brief Validates a raw buffer and decodes its header, for use where flash is unavailable.
+ *
+ * Performs the same length and CRC checks as beam_parse_view(). The result is not counted
+ * in beam_stats and argument errors are never logged. With CONFIG_BEAM_PARSER_IN_IRAM the
+ * whole call runs from IRAM and internal RAM without logging or stack buffers, so it may be
+ * used in esp_now_recv_cb or an ISR while the flash cache is disabled (NVS writes, OTA).
+ *
+ * Worst case is a maximum-size frame with a valid CRC: a few tens of cycles of bounds
+ * checks and header decode plus the CRC over FRAME_HEADER_SIZE + MAX_PAYLOAD_SIZE bytes,
+ * roughly 1500 cycles with the table backend and 900 with slice-by-4 on Xtensa cores
+ * (about 6 and 4 us at 240 MHz). Rejected frames return earlier; measure the target with
+ * the perf_benchmark example.
+ *
+ * @param data Raw byte array from esp_now_recv_cb.
+ * @param data_len Length of the received data.
+ * @param[out] out_header Header of the frame, filled if the frame is valid.
+ *
+ * @return ESP_OK if the frame is valid.
+ *         ESP_ERR_INVALID_ARG if data or out_header is NULL.
+ *         ESP_ERR_INVALID_SIZE if data_len is too short or payload length is invalid.
+ *         ESP_ERR_INVALID_CRC if the CRC does not match.
+ *
+ * @note As in beam_frame_t, out_header.len does not count a MSG_FLAG_EXT_TS timestamp;
+ *       the frame occupies FRAME_SIZE(len + FRAME_EXT_SIZE(flags)) bytes.
+ */
+esp_err_t beam_validate_frame(const uint8_t *data, size_t data_len, beam_frame_header_t *out_header);
+
+/**
+ * @brief Validates an array of packets in one call, producing a view per packet.
+ *
+ * Argument checks are done once for the whole batch. Validation is staged: the bounds and
+ * CRC checks of beam_parse_view() run over every packet back to back, then the views are
+ * filled and beam_stats is updated once for the whole batch, its accepted frames
+ * contributing their mean cycle cost to parse_cycles_min and parse_cycles_max.
+ * out[i] is only meaningful when status[i] == ESP_OK.
+ *
+ * @param in Array of n received packets.
+ * @param n Number of packets.
+ * @param[out] out Array of n views to fill.
+ * @param[out] status Array of n per-packet results (see beam_parse_view(); ESP_ERR_INVALID_ARG
+ *             if in[i].data is NULL).
+ *
+ * @return ESP_OK if every packet is valid.
+ *         ESP_FAIL if at least one packet failed validation (see status).
+ *         ESP_ERR_INVALID_ARG if in, out or status is NULL while n > 0.
+ */
+esp_err_t beam_parse_batch(const beam_rx_slice_t *in, size_t n, beam_frame_view_t *out, esp_err_t *status);
+
 /**
  * @brief Serializes a frame into raw buffer (header + payload + CRC).
  *
+ * Set MSG_FLAG_COMPRESSED in header.flags to offer the payload for compression. It is
+ * compressed only if that makes it shorter; otherwise it goes out as is and the flag is
+ * cleared in the output. buffer_size must fit the uncompressed frame either way.
+ *
  * @param frame Pointer to the frame to serialize. Must not be NULL.
  * @param out_buffer Buffer to write serialized frame. Must not be NULL.
  * @param buffer_size Size of out_buffer in bytes.
  * @param[out] out_size Optional pointer to receive the number of bytes written. Can be NULL.
  *
  * @return ESP_OK on success.
- *         ESP_ERR_INVALID_ARG if frame or out_buffer is NULL.
+ *         ESP_ERR_INVALID_ARG if frame or out_buffer is NULL, or header.flags has
+ *         MSG_FLAG_EXT_TS (use beam_serialize_frame_ts()).
  *         ESP_ERR_INVALID_SIZE if buffer_size is too small for the frame.
  *         ESP_ERR_INVALID_STATE if frame.header.len exceeds MAX_PAYLOAD_SIZE.
  */
 esp_err_t beam_serialize_frame(const beam_frame_t *frame, uint8_t *out_buffer, size_t buffer_size, size_t *out_size);
 
+/**
+ * @brief Serializes a MSG_FLAG_EXT_TS frame, writing timestamp_us before the payload.
+ *
+ * Same as beam_serialize_frame() otherwise. The timestamp is counted in the wire len, so
+ * header.len + FRAME_EXT_TS_SIZE must fit MAX_PAYLOAD_SIZE.
+ *
+ * @param frame Pointer to the frame to serialize; header.flags must have MSG_FLAG_EXT_TS.
+ * @param timestamp_us Sender clock in microseconds, e.g. (uint32_t)esp_timer_get_time().
+ * @param out_buffer Buffer to write serialized frame. Must not be NULL.
+ * @param buffer_size Size of out_buffer in bytes.
+ * @param[out] out_size Optional pointer to receive the number of bytes written. Can be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if frame or out_buffer is NULL, or MSG_FLAG_EXT_TS is not set.
+ *         ESP_ERR_INVALID_SIZE if buffer_size is too small for the frame.
+ *         ESP_ERR_INVALID_STATE if header.len plus the timestamp exceeds MAX_PAYLOAD_SIZE.
+ */
+esp_err_t beam_serialize_frame_ts(const beam_frame_t *frame,
+                                  uint32_t timestamp_us,
+                                  uint8_t *out_buffer,
+                                  size_t buffer_size,
+                                  size_t *out_size);
+
 #ifdef __cplusplus
 }
 #endif
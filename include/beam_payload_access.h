@@ -0,0 +1,134 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_PAYLOAD_ACCESS_H
+#define BEAM_PAYLOAD_ACCESS_H
+
+#include "beam_frame_view.h"
+#include "beam_message_common.h"
+#include "beam_payload_type.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Field accessors that decode typed payloads straight from a frame view. Reading
+ * .roll through the packed beam_payload_telemetry_t costs byte loads and a copy into
+ * a beam_frame_t; beam_telemetry_get_roll(view) assembles the little-endian value from
+ * the wire bytes instead, which is also correct on a big-endian host. The *_native_t
+ * structs hold the same fields with natural alignment for handlers that want a struct.
+ *
+ * Accessors do not check the frame: test it once with beam_payload_view_is_plain().
+ */
+
+/** Single byte at p, so every field type has a beam_le_* reader */
+static inline uint8_t beam_le_u8(const uint8_t *p)
+{
+    return p[0];
+}
+
+/** Little-endian unsigned 16-bit value at p (any alignment) */
+static inline uint16_t beam_le_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/** Little-endian unsigned 32-bit value at p (any alignment) */
+static inline uint32_t beam_le_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/** Little-endian IEEE-754 single at p (any alignment) */
+static inline float beam_le_f32(const uint8_t *p)
+{
+    uint32_t bits = beam_le_u32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+/**
+ * @brief Field list of each built-in payload: X(payload, packed type, field, native type, reader)
+ *        per field, named BEAM_PAYLOAD_FIELDS_<member> after its BEAM_PAYLOAD_REGISTRY entry.
+ *
+ * Offsets come from offsetof() on the packed type, so the accessors follow the wire
+ * layout defined in beam_payload_type.h. A registry entry without a list does not
+ * compile, and beam_payload_registry.c checks that each list covers its packed struct.
+ */
+#define BEAM_PAYLOAD_FIELDS_telemetry(X)                      \
+    X(telemetry, beam_payload_telemetry_t, roll, float, f32)  \
+    X(telemetry, beam_payload_telemetry_t, pitch, float, f32) \
+    X(telemetry, beam_payload_telemetry_t, yaw, float, f32)
+
+#define BEAM_PAYLOAD_FIELDS_battery(X)                         \
+    X(battery, beam_payload_battery_t, voltage, uint16_t, u16) \
+    X(battery, beam_payload_battery_t, current, uint16_t, u16) \
+    X(battery, beam_payload_battery_t, percent, uint8_t, u8)
+
+#define BEAM_ACCESS_GETTER(payload, packed, field, type, reader)                                                       \
+    static inline type beam_##payload##_get_##field(const beam_frame_view_t *view)                                     \
+    {                                                                                                                  \
+        return beam_le_##reader(beam_frame_view_payload(view) + offsetof(packed, field));                              \
+    }
+
+#define BEAM_ACCESS_NATIVE_MEMBER(payload, packed, field, type, reader) type field;
+
+#define BEAM_ACCESS_NATIVE_FILL(payload, packed, field, type, reader) out->field = beam_##payload##_get_##field(view);
+
+/*
+ * Per registry entry, e.g. telemetry: beam_telemetry_get_roll() and the other field
+ * getters, beam_telemetry_native_t with the fields of beam_payload_telemetry_t in
+ * natural alignment, and beam_telemetry_get_native(view, out) that fills it from a
+ * plain payload (see beam_payload_view_is_plain()).
+ */
+#define BEAM_ACCESS_PAYLOAD(category, member, type)                                                                    \
+    BEAM_PAYLOAD_FIELDS_##member(BEAM_ACCESS_GETTER)                                                                   \
+                                                                                                                       \
+    typedef struct beam_##member##_native {                                                                            \
+        BEAM_PAYLOAD_FIELDS_##member(BEAM_ACCESS_NATIVE_MEMBER)                                                        \
+    } beam_##member##_native_t;                                                                                        \
+                                                                                                                       \
+    static inline void beam_##member##_get_native(const beam_frame_view_t *view, beam_##member##_native_t *out)        \
+    {                                                                                                                  \
+        BEAM_PAYLOAD_FIELDS_##member(BEAM_ACCESS_NATIVE_FILL)                                                          \
+    }
+
+/**
+ * @brief True if the payload can be read with the typed accessors: the category has a
+ *        registered type, the payload holds all of it and it is neither compact nor compressed.
+ */
+static inline bool beam_payload_view_is_plain(const beam_frame_view_t *view)
+{
+    uint8_t typed_size = beam_payload_size(beam_frame_view_category(view));
+
+    return typed_size != 0 && beam_frame_view_payload_len(view) >= typed_size &&
+           (beam_frame_view_flags(view) & (MSG_FLAG_COMPACT | MSG_FLAG_COMPRESSED)) == 0;
+}
+
+BEAM_PAYLOAD_REGISTRY(BEAM_ACCESS_PAYLOAD)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_PAYLOAD_ACCESS_H */
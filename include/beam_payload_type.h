@@ -17,6 +17,7 @@
 #ifndef BEAM_PAYLOAD_TYPE_H
 #define BEAM_PAYLOAD_TYPE_H
 
+#include "beam_message_common.h"
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -44,14 +45,53 @@ typedef struct __attribute__((packed)) beam_payload_battery {
 } beam_payload_battery_t;
 
 /**
- * @brief Frame payload union: use .telemetry, .battery or .raw[] according to header.msg_category (MSG_ID_*).
+ * @brief Payload registry: X(category, member, type) for every typed payload.
+ *
+ * Everything category-specific (union members, size table, C++ traits) is generated
+ * from this list. To add payload types without forking the component, define
+ * BEAM_PAYLOAD_USER_HEADER (e.g. -DBEAM_PAYLOAD_USER_HEADER='"my_payloads.h"') naming a
+ * header that declares the packed structs, their categories and
+ * BEAM_PAYLOAD_USER_REGISTRY(X) in the same form. Each category may appear only once.
+ */
+#define BEAM_PAYLOAD_REGISTRY(X)                              \
+    X(MSG_CAT_TELEMETRY, telemetry, beam_payload_telemetry_t) \
+    X(MSG_CAT_BATTERY, battery, beam_payload_battery_t)
+
+#ifdef BEAM_PAYLOAD_USER_HEADER
+#include BEAM_PAYLOAD_USER_HEADER
+#endif
+
+#ifndef BEAM_PAYLOAD_USER_REGISTRY
+#define BEAM_PAYLOAD_USER_REGISTRY(X)
+#endif
+
+/* Built-in and user payloads together */
+#define BEAM_PAYLOADS(X) BEAM_PAYLOAD_REGISTRY(X) BEAM_PAYLOAD_USER_REGISTRY(X)
+
+#define BEAM_PAYLOAD_UNION_MEMBER(category, member, type) type member;
+
+/**
+ * @brief Frame payload union: use the registry member (.telemetry, .battery, ...) or .raw[]
+ * according to header.msg_category (MSG_CAT_*).
  */
 typedef union beam_payload {
-    beam_payload_telemetry_t telemetry; ///< When msg_category == MSG_CAT_TELEMETRY
-    beam_payload_battery_t battery;     ///< When msg_category == MSG_CAT_BATTERY
-    uint8_t raw[MAX_PAYLOAD_SIZE];      ///< Raw bytes; or use typed member above
+    BEAM_PAYLOADS(BEAM_PAYLOAD_UNION_MEMBER)
+    uint8_t raw[MAX_PAYLOAD_SIZE]; ///< Raw bytes; or use typed member above
 } beam_payload_t;
 
+/**
+ * @brief Size of the typed payload registered for each category, 0 if none.
+ */
+extern const uint8_t beam_payload_size_table[256];
+
+/**
+ * @brief Size of the typed payload for category, or 0 if the category has no registered type.
+ */
+static inline uint8_t beam_payload_size(uint8_t category)
+{
+    return beam_payload_size_table[category];
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,138 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_PIPELINE_H
+#define BEAM_PIPELINE_H
+
+#include "beam_dispatcher.h"
+#include "beam_frame.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Two-stage receive pipeline for dual-core targets. beam_pipeline_submit() runs in
+ * esp_now_recv_cb and only copies the raw bytes into a ring slot, so the Wi-Fi task
+ * is released at once. The RX task (CONFIG_BEAM_PIPELINE_RX_CORE) validates each frame
+ * in its slot; the dispatch task (CONFIG_BEAM_PIPELINE_DISPATCH_CORE) runs the
+ * dispatcher's subscribers on the same slot, so a frame is copied once per pipeline.
+ * The ring has one index per stage and each stage consumes what the previous one
+ * published. When subscribers fall behind the ring fills up, so overload shows up as
+ * ESP_ERR_NO_MEM from beam_pipeline_submit().
+ *
+ * On single-core targets both tasks run on core 0 and the pipeline only decouples the
+ * Wi-Fi task from the subscribers.
+ *
+ * With CONFIG_BEAM_LATENCY_TRACE, frames carrying MSG_FLAG_EXT_TS are traced through
+ * all four stages of beam_latency.h: submit, validation, enqueue and dispatch.
+ */
+
+#define BEAM_PIPELINE_QUEUE_DEPTH CONFIG_BEAM_PIPELINE_QUEUE_DEPTH ///< Frames in flight (power of two)
+
+/**
+ * @brief Pipeline counters. Each is written by one stage; read from another task they may lag by a frame.
+ */
+typedef struct beam_pipeline_stats {
+    uint32_t submitted;  ///< Frames accepted by beam_pipeline_submit()
+    uint32_t dropped;    ///< Frames rejected by beam_pipeline_submit() because the ring was full
+    uint32_t invalid;    ///< Frames that failed validation in the RX task
+    uint32_t dispatched; ///< Frames handed to beam_dispatch()
+} beam_pipeline_stats_t;
+
+/**
+ * @brief Pipeline state; several KiB, so give it static storage. Treat the fields as private.
+ */
+typedef struct beam_pipeline {
+    beam_frame_buf_t slots[BEAM_PIPELINE_QUEUE_DEPTH]; ///< Frames in flight; len 0 marks a frame that failed validation
+    uint32_t head;                                     ///< Frames submitted; written by beam_pipeline_submit() only
+    uint32_t validated;                                ///< Frames validated; written by the RX task only
+    uint32_t tail;                                     ///< Frames dispatched; written by the dispatch task only
+#if CONFIG_BEAM_LATENCY_TRACE
+    uint32_t rx_time_us[BEAM_PIPELINE_QUEUE_DEPTH];    ///< Submit time per slot (BEAM_LATENCY_STAGE_RX)
+#endif
+    const beam_dispatcher_t *dispatcher;               ///< Subscribers run by the dispatch task
+    TaskHandle_t rx_task;                              ///< Validation stage
+    TaskHandle_t dispatch_task;                        ///< Dispatch stage
+    beam_pipeline_stats_t stats;                       ///< Counters
+    bool running;                                      ///< Cleared by beam_pipeline_stop()
+    uint8_t parked;                                    ///< Tasks that saw running cleared
+} beam_pipeline_t;
+
+/**
+ * @brief Creates the RX and dispatch tasks with the priorities, cores and stack sizes from Kconfig.
+ *
+ * Subscribe handlers before starting: the dispatcher must not change while the pipeline runs.
+ * Register the receive callback only after this returns.
+ *
+ * @param pipeline Pipeline state, not running. Must not be NULL.
+ * @param dispatcher Subscribers to run; must outlive the pipeline. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if pipeline or dispatcher is NULL.
+ *         ESP_ERR_INVALID_STATE if the pipeline is already running.
+ *         ESP_ERR_NO_MEM if a task could not be created.
+ */
+esp_err_t beam_pipeline_start(beam_pipeline_t *pipeline, const beam_dispatcher_t *dispatcher);
+
+/**
+ * @brief Queues a received frame for validation. Call from esp_now_recv_cb (task context).
+ *
+ * Only one task may submit. Frames are not inspected here; errors are not logged.
+ *
+ * @param pipeline Running pipeline. Must not be NULL.
+ * @param data Raw frame bytes. Must not be NULL.
+ * @param data_len Length of data.
+ *
+ * @return ESP_OK if the frame was queued.
+ *         ESP_ERR_INVALID_ARG if pipeline or data is NULL.
+ *         ESP_ERR_INVALID_STATE if the pipeline is not running.
+ *         ESP_ERR_INVALID_SIZE if data_len exceeds FRAME_MAX_SIZE.
+ *         ESP_ERR_NO_MEM if the ring is full (counted in stats.dropped).
+ */
+esp_err_t beam_pipeline_submit(beam_pipeline_t *pipeline, const uint8_t *data, size_t data_len);
+
+/**
+ * @brief Stops both tasks and discards queued frames. Blocks until the tasks are gone.
+ *
+ * Unregister the receive callback first: beam_pipeline_submit() must not run concurrently.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if pipeline is NULL.
+ *         ESP_ERR_INVALID_STATE if the pipeline is not running.
+ */
+esp_err_t beam_pipeline_stop(beam_pipeline_t *pipeline);
+
+/**
+ * @brief Copies the pipeline counters.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if pipeline or out_stats is NULL.
+ */
+esp_err_t beam_pipeline_get_stats(const beam_pipeline_t *pipeline, beam_pipeline_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_PIPELINE_H */
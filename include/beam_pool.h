@@ -0,0 +1,86 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_POOL_H
+#define BEAM_POOL_H
+
+#include "beam_frame.h"
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Static pool of CONFIG_BEAM_POOL_BUFFER_COUNT frame buffers shared by transmit and
+ * receive paths. Acquire and release are O(1) and may be called from tasks and ISRs on
+ * either core. A buffer can be handed to beam_frame_begin() as
+ * (buf->data, sizeof(buf->data)).
+ */
+
+/**
+ * @brief Pool usage counters.
+ */
+typedef struct beam_pool_stats {
+    uint16_t capacity;       ///< Number of buffers (CONFIG_BEAM_POOL_BUFFER_COUNT)
+    uint16_t in_use;         ///< Buffers currently acquired
+    uint16_t high_water;     ///< Largest in_use since start or the last beam_pool_reset_stats()
+    uint32_t alloc_failures; ///< Acquire attempts that found the pool empty
+} beam_pool_stats_t;
+
+/**
+ * @brief Takes a buffer from the pool. Contents are undefined; len is 0.
+ *
+ * @param[out] out_buf Receives the buffer. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if out_buf is NULL.
+ *         ESP_ERR_NO_MEM if all buffers are in use.
+ */
+esp_err_t beam_pool_acquire(beam_frame_buf_t **out_buf);
+
+/**
+ * @brief Returns a buffer obtained from beam_pool_acquire().
+ *
+ * @param buf Buffer to return.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if buf is NULL or does not belong to the pool.
+ *         ESP_ERR_INVALID_STATE if buf is not currently acquired (e.g. released twice); the pool is unchanged.
+ */
+esp_err_t beam_pool_release(beam_frame_buf_t *buf);
+
+/**
+ * @brief Copies the current counters.
+ *
+ * @param[out] out_stats Receives the snapshot. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if out_stats is NULL.
+ */
+esp_err_t beam_pool_get_stats(beam_pool_stats_t *out_stats);
+
+/**
+ * @brief Clears alloc_failures and restarts high_water from the current in_use.
+ */
+void beam_pool_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_POOL_H */
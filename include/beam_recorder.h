@@ -0,0 +1,308 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_RECORDER_H
+#define BEAM_RECORDER_H
+
+#include "beam_dispatcher.h"
+#include "beam_frame.h"
+#include "beam_seq.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#if CONFIG_BEAM_RECORDER_PARTITION
+#include "esp_partition.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Traffic recorder and replayer. beam_recorder_record() runs in esp_now_recv_cb and
+ * appends the raw bytes, arrival time, RSSI and sender of every received frame, valid or
+ * not, to one of two RAM batch buffers; nothing touches storage on the Wi-Fi task.
+ * beam_recorder_flush(), called from a low-priority task, writes each full batch to the
+ * storage in one piece (one erase and one write per flash sector), so the cache-disabled
+ * window of a flash write happens once per batch instead of once per frame.
+ *
+ * The storage is an append-only ring of batches: when it is full the oldest batch is
+ * overwritten. Each batch carries a sequence number and a CRC, so the replayer finds the
+ * oldest one after a wrap or a reboot and skips torn writes.
+ *
+ * Storage layout, little-endian, BEAM_RECORDER_BATCH_SIZE bytes per batch:
+ *
+ *   batch:  magic u32 | seq u32 | used u16 | crc u16 | records (used bytes) | unused
+ *   record: time_us u32 | mac[6] | rssi i8 | len u8 | frame bytes (len)
+ *
+ * time_us is the low 32 bits of the arrival time; only differences matter, and records
+ * of one session are never 71 minutes apart without traffic in between.
+ */
+
+#define BEAM_RECORDER_BATCH_SIZE CONFIG_BEAM_RECORDER_BATCH_SIZE ///< Bytes per batch buffer and storage slot
+#define BEAM_RECORDER_MAGIC 0x43455242u                          ///< "BREC", first word of every batch
+#define BEAM_RECORDER_BATCH_HEADER_SIZE 12u                      ///< magic, seq, used, crc
+#define BEAM_RECORDER_RECORD_HEADER_SIZE 12u                     ///< time_us, mac, rssi, len
+
+/**
+ * @brief Where batches are kept: a PSRAM buffer, a flash partition or anything with the same
+ *        three operations. Offsets are batch aligned; every call covers one batch or one header.
+ */
+typedef struct beam_recorder_storage {
+    esp_err_t (*erase)(void *ctx, size_t offset, size_t len);                   ///< Prepare a slot for writing, or NULL
+    esp_err_t (*write)(void *ctx, size_t offset, const void *data, size_t len); ///< Write bytes
+    esp_err_t (*read)(void *ctx, size_t offset, void *data, size_t len);        ///< Read bytes
+    void *ctx;                                                                  ///< Passed to the operations
+    size_t size;                                                                ///< Usable bytes, whole batches
+} beam_recorder_storage_t;
+
+/**
+ * @brief Recorder counters. recorded and dropped are written by the recording task, the
+ *        others by the flushing task; read from another task they may lag by a frame.
+ */
+typedef struct beam_recorder_stats {
+    uint32_t recorded;     ///< Frames stored in a batch buffer
+    uint32_t dropped;      ///< Frames lost because both batch buffers were full
+    uint32_t batches;      ///< Batches written to storage
+    uint32_t write_errors; ///< Batches the storage failed to erase or write (their frames are lost)
+} beam_recorder_stats_t;
+
+/**
+ * @brief Recorder state; holds two batch buffers, so give it static storage. Treat the fields as private.
+ */
+typedef struct beam_recorder {
+    const beam_recorder_storage_t *storage;       ///< Destination of full batches
+    uint8_t buffers[2][BEAM_RECORDER_BATCH_SIZE]; ///< Batch buffers, each with its header space
+    size_t fill[2];                               ///< Bytes used in each buffer, header included
+    uint8_t active;                               ///< Buffer the recording task appends to
+    bool pending;                                 ///< The other buffer is full and waits for a flush
+    size_t write_offset;                          ///< Storage offset of the next batch
+    uint32_t seq;                                 ///< Sequence number of the next batch
+    beam_recorder_stats_t stats;                  ///< Counters
+} beam_recorder_t;
+
+/**
+ * @brief Fills storage with operations on a RAM buffer, e.g. one allocated in PSRAM with
+ *        heap_caps_malloc(size, MALLOC_CAP_SPIRAM).
+ *
+ * @param[out] storage Storage to fill. Must not be NULL.
+ * @param buffer Buffer that outlives the recorder. Must not be NULL.
+ * @param size Size of buffer; the part beyond the last whole batch is not used.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if storage or buffer is NULL.
+ *         ESP_ERR_INVALID_SIZE if size holds fewer than two batches.
+ */
+esp_err_t beam_recorder_storage_init_memory(beam_recorder_storage_t *storage, uint8_t *buffer, size_t size);
+
+#if CONFIG_BEAM_RECORDER_PARTITION
+/**
+ * @brief Fills storage with operations on a data partition (e.g. found with esp_partition_find_first()).
+ *
+ * @param[out] storage Storage to fill. Must not be NULL.
+ * @param partition Partition used for the log only. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if storage or partition is NULL.
+ *         ESP_ERR_INVALID_SIZE if BEAM_RECORDER_BATCH_SIZE is not a multiple of the partition's
+ *         erase size or the partition holds fewer than two batches.
+ */
+esp_err_t beam_recorder_storage_init_partition(beam_recorder_storage_t *storage, const esp_partition_t *partition);
+#endif
+
+/**
+ * @brief Opens the log in storage and continues it after its newest batch.
+ *
+ * Reads every batch header once; erase the storage beforehand to start an empty log.
+ *
+ * @param recorder Recorder state. Must not be NULL.
+ * @param storage Filled storage that outlives the recorder. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if recorder or storage is NULL.
+ *         ESP_ERR_INVALID_SIZE if storage holds fewer than two batches.
+ *         Errors of storage->read.
+ */
+esp_err_t beam_recorder_init(beam_recorder_t *recorder, const beam_recorder_storage_t *storage);
+
+/**
+ * @brief Appends one received frame. Call from esp_now_recv_cb (task context), from one task only.
+ *
+ * The bytes are recorded as received, without validation. Errors are not logged.
+ *
+ * @param recorder Initialized recorder. Must not be NULL.
+ * @param mac Sender address, BEAM_MAC_LEN bytes. Must not be NULL.
+ * @param rssi Received signal strength (recv_info->rx_ctrl->rssi).
+ * @param data Received bytes. Must not be NULL.
+ * @param data_len Length of data.
+ * @param now_us Arrival time, e.g. esp_timer_get_time().
+ *
+ * @return ESP_OK if the frame was recorded.
+ *         ESP_ERR_INVALID_ARG if recorder, mac or data is NULL.
+ *         ESP_ERR_INVALID_SIZE if data_len exceeds FRAME_MAX_SIZE.
+ *         ESP_ERR_NO_MEM if both batch buffers are full (counted in stats.dropped).
+ */
+esp_err_t beam_recorder_record(beam_recorder_t *recorder,
+                               const uint8_t *mac,
+                               int8_t rssi,
+                               const uint8_t *data,
+                               size_t data_len,
+                               int64_t now_us);
+
+/**
+ * @brief Writes the full batch, if any, to storage. Call regularly from one task other than
+ *        the recording one; flash writes block this task for the duration of the erase.
+ *
+ * @return ESP_OK if nothing was pending or the batch was written.
+ *         ESP_ERR_INVALID_ARG if recorder is NULL.
+ *         Errors of storage->erase or storage->write; the batch is discarded (stats.write_errors)
+ *         and the next one is written to the same slot with the same sequence number, so the
+ *         log stays contiguous.
+ */
+esp_err_t beam_recorder_flush(beam_recorder_t *recorder);
+
+/**
+ * @brief Writes the full batch and the partly filled one, so the log holds every recorded frame.
+ *
+ * Stop recording first: beam_recorder_record() must not run concurrently. Recording may
+ * resume afterwards and starts a new batch.
+ *
+ * @return As for beam_recorder_flush().
+ */
+esp_err_t beam_recorder_finish(beam_recorder_t *recorder);
+
+/**
+ * @brief Copies the recorder counters.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if recorder or out_stats is NULL.
+ */
+esp_err_t beam_recorder_get_stats(const beam_recorder_t *recorder, beam_recorder_stats_t *out_stats);
+
+/**
+ * @brief Replay pacing.
+ */
+typedef enum beam_replay_speed {
+    BEAM_REPLAY_ORIGINAL, ///< Deliver each frame when as much time has passed as when it was recorded
+    BEAM_REPLAY_MAX,      ///< Deliver frames as fast as beam_replay_poll() is called
+} beam_replay_speed_t;
+
+/**
+ * @brief One recorded frame. data points into the replayer and is valid during the callback only.
+ */
+typedef struct beam_replay_record {
+    uint32_t time_us;          ///< Low 32 bits of the arrival time
+    uint8_t mac[BEAM_MAC_LEN]; ///< Sender address
+    int8_t rssi;               ///< Received signal strength
+    uint8_t len;               ///< Bytes in data
+    const uint8_t *data;       ///< Frame bytes as received
+} beam_replay_record_t;
+
+/**
+ * @brief Called for every replayed record before it is dispatched, e.g. to feed
+ *        beam_gateway_receive() or beam_pipeline_submit() instead.
+ */
+typedef void (*beam_replay_cb_t)(const beam_replay_record_t *record, void *ctx);
+
+/**
+ * @brief Replay counters.
+ */
+typedef struct beam_replay_stats {
+    uint32_t records;         ///< Records delivered
+    uint32_t dispatched;      ///< Records that validated and were passed to beam_dispatch()
+    uint32_t invalid;         ///< Records that failed beam_parse_view() (recorded as received)
+    uint32_t corrupt_batches; ///< Batches skipped for a bad CRC or size
+} beam_replay_stats_t;
+
+/**
+ * @brief Replayer state; holds one batch buffer. Treat the fields as private.
+ */
+typedef struct beam_replay {
+    const beam_recorder_storage_t *storage;  ///< Log being replayed
+    const beam_dispatcher_t *dispatcher;     ///< Receives valid frames, or NULL
+    beam_replay_cb_t on_record;              ///< Receives every record, or NULL
+    void *ctx;                               ///< Passed to on_record
+    beam_replay_speed_t speed;               ///< Pacing
+    uint8_t batch[BEAM_RECORDER_BATCH_SIZE]; ///< Batch being replayed
+    size_t batch_pos;                        ///< Offset of the next record in batch
+    size_t batch_end;                        ///< End of the records in batch
+    size_t slot;                             ///< Storage slot of batch
+    size_t slots_left;                       ///< Slots not read yet
+    uint32_t seq;                            ///< Sequence number expected in the next slot
+    bool started;                            ///< start_us and last_time_us are set
+    int64_t start_us;                        ///< now_us of the first beam_replay_poll()
+    int64_t elapsed_us;                      ///< Recorded time of the next record since the first
+    uint32_t last_time_us;                   ///< time_us of the previous record
+    beam_replay_stats_t stats;               ///< Counters
+} beam_replay_t;
+
+/**
+ * @brief Finds the oldest batch of the log and prepares to replay from it.
+ *
+ * @param replay Replayer state. Must not be NULL.
+ * @param storage Log written by a recorder; must not be written while replaying. Must not be NULL.
+ * @param speed Pacing.
+ * @param dispatcher Valid frames are parsed with beam_parse_view() and dispatched here. Can be NULL.
+ * @param on_record Called for every record first. Can be NULL.
+ * @param ctx User context passed to on_record.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if replay or storage is NULL, or speed is unknown.
+ *         ESP_ERR_INVALID_SIZE if storage holds fewer than two batches.
+ *         Errors of storage->read.
+ */
+esp_err_t beam_replay_init(beam_replay_t *replay,
+                           const beam_recorder_storage_t *storage,
+                           beam_replay_speed_t speed,
+                           const beam_dispatcher_t *dispatcher,
+                           beam_replay_cb_t on_record,
+                           void *ctx);
+
+/**
+ * @brief Delivers the records that are due at now_us, at most max_records.
+ *
+ * With BEAM_REPLAY_ORIGINAL the first call fixes the start: a record recorded t µs after
+ * the first one is due at start + t, so calling this every millisecond reproduces the
+ * recorded timing to within a millisecond. Gaps where the clock went backwards (a reboot
+ * between sessions) count as zero.
+ *
+ * @param replay Initialized replayer. Must not be NULL.
+ * @param now_us Current time, e.g. esp_timer_get_time(); ignored with BEAM_REPLAY_MAX.
+ * @param max_records Upper bound of records delivered by this call.
+ * @param[out] out_delivered Optional pointer to receive the number of records delivered. Can be NULL.
+ *
+ * @return ESP_OK if records remain.
+ *         ESP_ERR_INVALID_ARG if replay is NULL.
+ *         ESP_ERR_NOT_FOUND once the whole log has been delivered.
+ *         Errors of storage->read, which end the replay.
+ */
+esp_err_t beam_replay_poll(beam_replay_t *replay, int64_t now_us, size_t max_records, size_t *out_delivered);
+
+/**
+ * @brief Copies the replay counters.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if replay or out_stats is NULL.
+ */
+esp_err_t beam_replay_get_stats(const beam_replay_t *replay, beam_replay_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_RECORDER_H */
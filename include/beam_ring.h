@@ -0,0 +1,129 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_RING_H
+#define BEAM_RING_H
+
+#include "beam_frame.h"
+#include "beam_frame_view.h"
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of frame slots.
+ *
+ * One task (e.g. the Wi-Fi task in esp_now_recv_cb) produces and one task consumes;
+ * no locks or critical sections are taken. Each slot holds a whole frame, so the
+ * consumer reads it in place through a beam_frame_view_t. Treat the fields as private.
+ */
+typedef struct beam_ring {
+    beam_frame_buf_t *slots; ///< Caller-provided slot storage
+    uint32_t mask;           ///< Slot count - 1 (count is a power of two)
+    uint32_t head;           ///< Next slot to write; written by the producer only
+    uint32_t tail;           ///< Next slot to read; written by the consumer only
+    uint32_t dropped;        ///< Frames rejected by beam_ring_push_frame() because the ring was full
+} beam_ring_t;
+
+/**
+ * @brief Initializes an empty ring over caller-provided slots.
+ *
+ * @param ring Ring to initialize. Must not be NULL.
+ * @param slots Slot storage; must outlive the ring. Must not be NULL.
+ * @param count Number of slots: a power of two, at least 2.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if ring or slots is NULL, or count is not a power of two >= 2.
+ */
+esp_err_t beam_ring_init(beam_ring_t *ring, beam_frame_buf_t *slots, size_t count);
+
+/**
+ * @brief Producer: gets the next free slot to write a frame into.
+ *
+ * Fill slot->data with a valid frame and slot->len with its size, then call beam_ring_commit().
+ * Calling again before commit returns the same slot.
+ *
+ * @param ring Ring. Must not be NULL.
+ * @param[out] out_slot Receives the free slot. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if ring or out_slot is NULL.
+ *         ESP_ERR_NO_MEM if the ring is full.
+ */
+esp_err_t beam_ring_reserve(beam_ring_t *ring, beam_frame_buf_t **out_slot);
+
+/**
+ * @brief Producer: publishes the slot obtained from beam_ring_reserve() to the consumer.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if ring is NULL.
+ *         ESP_ERR_INVALID_STATE if the ring is full (nothing was reserved).
+ */
+esp_err_t beam_ring_commit(beam_ring_t *ring);
+
+/**
+ * @brief Producer: validates a raw frame and copies it into the next slot.
+ *
+ * Validation is the same as beam_parse_view(); invalid frames are not queued.
+ *
+ * @param ring Ring. Must not be NULL.
+ * @param data Raw frame bytes (e.g. from esp_now_recv_cb). Must not be NULL.
+ * @param data_len Length of data.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if ring or data is NULL.
+ *         ESP_ERR_INVALID_SIZE / ESP_ERR_INVALID_CRC as for beam_parse_view().
+ *         ESP_ERR_NO_MEM if the ring is full (counted in ring->dropped).
+ */
+esp_err_t beam_ring_push_frame(beam_ring_t *ring, const uint8_t *data, size_t data_len);
+
+/**
+ * @brief Consumer: views the oldest frame without removing it.
+ *
+ * The view points into the slot and stays valid until beam_ring_release().
+ *
+ * @param ring Ring. Must not be NULL.
+ * @param[out] out_view Receives the frame view. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if ring or out_view is NULL.
+ *         ESP_ERR_NOT_FOUND if the ring is empty.
+ */
+esp_err_t beam_ring_peek(beam_ring_t *ring, beam_frame_view_t *out_view);
+
+/**
+ * @brief Consumer: frees the oldest slot, returning it to the producer.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if ring is NULL.
+ *         ESP_ERR_NOT_FOUND if the ring is empty.
+ */
+esp_err_t beam_ring_release(beam_ring_t *ring);
+
+/**
+ * @brief Number of committed frames not yet released. Safe to call from either side.
+ */
+size_t beam_ring_count(const beam_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_RING_H */
@@ -0,0 +1,173 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_SCHEDULER_H
+#define BEAM_SCHEDULER_H
+
+#include "beam_frame.h"
+#include "beam_message_common.h"
+#include "beam_ring.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Transmit scheduler. Frames with MSG_FLAG_PRIORITY go to the priority queue, all others
+ * to the bulk queue; both are lock-free SPSC rings. beam_scheduler_run() hands at most one
+ * frame at a time to the send callback and waits for beam_scheduler_on_send_done()
+ * before the next, so the radio queue never holds more than one bulk frame ahead of a
+ * command. The priority queue is always drained first.
+ */
+
+#define BEAM_SCHED_MAX_RATE_LIMITS CONFIG_BEAM_SCHED_MAX_RATE_LIMITS ///< Rate-limited categories per scheduler
+
+/**
+ * @brief Transmits one frame (e.g. a wrapper around esp_now_send). The buffer is only valid during the call.
+ */
+typedef esp_err_t (*beam_sched_send_cb_t)(const uint8_t *frame, size_t frame_len, void *ctx);
+
+/**
+ * @brief Token bucket limiting one category. Credit is kept in frame-microseconds.
+ */
+typedef struct beam_rate_limit {
+    uint64_t credit;              ///< Accumulated credit; one frame costs 1000000
+    int64_t last_us;              ///< Time of the last refill
+    uint16_t frames_per_sec;      ///< Sustained rate, 0 if the entry is free
+    uint8_t burst;                ///< Frames that may be sent back to back
+    beam_msg_category_t category; ///< Limited category
+} beam_rate_limit_t;
+
+/**
+ * @brief Scheduler counters.
+ */
+typedef struct beam_sched_stats {
+    uint32_t sent;             ///< Frames accepted by the send callback
+    uint32_t send_errors;      ///< Send callback failures (the frame stays queued)
+    uint32_t throttled;        ///< Runs that skipped a queue head because of its rate limit
+    uint32_t dropped_priority; ///< Priority frames rejected because the queue was full
+    uint32_t dropped_bulk;     ///< Bulk frames rejected because the queue was full
+} beam_sched_stats_t;
+
+/**
+ * @brief Scheduler state. Treat the fields as private.
+ *
+ * Each queue has one producer (the task calling beam_scheduler_enqueue() for that class
+ * of frames); beam_scheduler_run() and the rate-limit setters belong to one consumer task.
+ */
+typedef struct beam_scheduler {
+    beam_ring_t priority;                                 ///< MSG_FLAG_PRIORITY frames
+    beam_ring_t bulk;                                     ///< Everything else
+    uint32_t in_flight;                                   ///< Non-zero while the radio holds a frame
+    beam_rate_limit_t limits[BEAM_SCHED_MAX_RATE_LIMITS]; ///< Per-category token buckets
+    beam_sched_send_cb_t send;                            ///< Frame sink
+    void *ctx;                                            ///< User context passed to send
+    beam_sched_stats_t stats;                             ///< Counters
+} beam_scheduler_t;
+
+/**
+ * @brief Initializes a scheduler over caller-provided queue slots.
+ *
+ * @param sched Scheduler to initialize. Must not be NULL.
+ * @param priority_slots Priority queue storage; must outlive the scheduler. Must not be NULL.
+ * @param priority_count Priority queue slots: a power of two, at least 2.
+ * @param bulk_slots Bulk queue storage; must outlive the scheduler. Must not be NULL.
+ * @param bulk_count Bulk queue slots: a power of two, at least 2.
+ * @param send Frame sink. Must not be NULL.
+ * @param ctx User context passed to send.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if a pointer is NULL or a count is invalid (see beam_ring_init()).
+ */
+esp_err_t beam_scheduler_init(beam_scheduler_t *sched,
+                              beam_frame_buf_t *priority_slots,
+                              size_t priority_count,
+                              beam_frame_buf_t *bulk_slots,
+                              size_t bulk_count,
+                              beam_sched_send_cb_t send,
+                              void *ctx);
+
+/**
+ * @brief Producer: queues a serialized frame by its MSG_FLAG_PRIORITY bit. The frame is copied.
+ *
+ * The frame is not validated again; pass frames from beam_frame_finish() or beam_serialize_frame().
+ *
+ * @param sched Initialized scheduler. Must not be NULL.
+ * @param frame Serialized frame. Must not be NULL.
+ * @param frame_len Frame size in bytes.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if sched or frame is NULL.
+ *         ESP_ERR_INVALID_SIZE if frame_len is outside [FRAME_MIN_SIZE, FRAME_MAX_SIZE].
+ *         ESP_ERR_NO_MEM if the queue is full (counted in the stats).
+ */
+esp_err_t beam_scheduler_enqueue(beam_scheduler_t *sched, const uint8_t *frame, size_t frame_len);
+
+/**
+ * @brief Consumer: limits a category to frames_per_sec with bursts of up to burst frames.
+ *
+ * A rate-limited frame at the head of its queue waits there; the other queue is still served.
+ *
+ * @param sched Initialized scheduler. Must not be NULL.
+ * @param category Category to limit.
+ * @param frames_per_sec Sustained rate, or 0 to remove the limit.
+ * @param burst Bucket depth in frames, at least 1 when frames_per_sec is non-zero.
+ * @param now_us Current time in microseconds; the bucket starts full.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if sched is NULL or burst is 0 with a non-zero rate.
+ *         ESP_ERR_NO_MEM if BEAM_SCHED_MAX_RATE_LIMITS categories are already limited.
+ */
+esp_err_t beam_scheduler_set_rate(beam_scheduler_t *sched,
+                                  beam_msg_category_t category,
+                                  uint16_t frames_per_sec,
+                                  uint8_t burst,
+                                  int64_t now_us);
+
+/**
+ * @brief Consumer: sends the next eligible frame if the radio is idle.
+ *
+ * Call from the scheduler task whenever a frame was enqueued or a send completed.
+ *
+ * @param sched Initialized scheduler. Must not be NULL.
+ * @param now_us Current time in microseconds (e.g. esp_timer_get_time()).
+ *
+ * @return ESP_OK if a frame was handed to the send callback.
+ *         ESP_ERR_INVALID_ARG if sched is NULL.
+ *         ESP_ERR_INVALID_STATE if a frame is still in flight.
+ *         ESP_ERR_NOT_FOUND if both queues are empty or their heads are rate limited.
+ *         Any error returned by the send callback (the frame stays queued).
+ */
+esp_err_t beam_scheduler_run(beam_scheduler_t *sched, int64_t now_us);
+
+/**
+ * @brief Marks the radio idle. Call from the send-complete callback (e.g. esp_now_send_cb).
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if sched is NULL.
+ */
+esp_err_t beam_scheduler_on_send_done(beam_scheduler_t *sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_SCHEDULER_H */
@@ -0,0 +1,172 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_SEQ_H
+#define BEAM_SEQ_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Receive-side tracking of header.seq. Sequence numbers are compared modulo 256: a
+ * frame up to 127 ahead of the newest one seen is new, anything else is old. The last
+ * BEAM_SEQ_WINDOW_SIZE numbers are remembered in a bitmap, so duplicates and late
+ * arrivals are told apart in O(1) without allocation.
+ */
+
+#define BEAM_SEQ_WINDOW_SIZE 32u                     ///< Sequence numbers remembered behind the newest
+#define BEAM_SEQ_MAX_PEERS CONFIG_BEAM_SEQ_MAX_PEERS ///< Peers per beam_seq_tracker_t
+#define BEAM_MAC_LEN 6u                              ///< Peer address length (ESP-NOW MAC)
+
+/**
+ * @brief Classification of one received sequence number.
+ */
+typedef enum beam_seq_result {
+    BEAM_SEQ_NEW,          ///< Next in order
+    BEAM_SEQ_GAP,          ///< Ahead of the next expected; the skipped ones are counted lost
+    BEAM_SEQ_OUT_OF_ORDER, ///< Older than the newest but not seen before (a frame counted lost arrived late)
+    BEAM_SEQ_DUPLICATE,    ///< Already seen, or too old to tell
+} beam_seq_result_t;
+
+/**
+ * @brief Per-peer counters. lost is net of frames that later arrived out of order.
+ */
+typedef struct beam_seq_stats {
+    uint32_t received;   ///< Frames passed to beam_seq_update(), duplicates included
+    uint32_t duplicates; ///< BEAM_SEQ_DUPLICATE results
+    uint32_t reordered;  ///< BEAM_SEQ_OUT_OF_ORDER results
+    uint32_t lost;       ///< Sequence numbers skipped and not (yet) received
+} beam_seq_stats_t;
+
+/**
+ * @brief Sequence state of one peer. Treat the fields as private.
+ */
+typedef struct beam_seq_state {
+    uint32_t window;        ///< Bit n set: seq (newest - n) was received
+    uint8_t newest;         ///< Highest sequence number seen
+    bool started;           ///< False until the first frame
+    beam_seq_stats_t stats; ///< Counters
+} beam_seq_state_t;
+
+/**
+ * @brief Sequence tracker entry for one peer.
+ */
+typedef struct beam_seq_peer {
+    uint8_t mac[BEAM_MAC_LEN]; ///< Peer address
+    beam_seq_state_t state;    ///< Peer sequence state
+} beam_seq_peer_t;
+
+/**
+ * @brief Sequence states for up to BEAM_SEQ_MAX_PEERS peers, keyed by MAC. Treat the fields as private.
+ */
+typedef struct beam_seq_tracker {
+    beam_seq_peer_t peers[BEAM_SEQ_MAX_PEERS]; ///< Known peers, [0, count) in use
+    uint8_t count;                             ///< Number of known peers
+    uint32_t rejected;                         ///< Frames from new peers refused because all entries were taken
+} beam_seq_tracker_t;
+
+/**
+ * @brief Resets a peer's sequence state and counters.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if state is NULL.
+ */
+esp_err_t beam_seq_init(beam_seq_state_t *state);
+
+/**
+ * @brief Records a received sequence number and classifies it.
+ *
+ * The first frame after beam_seq_init() is always BEAM_SEQ_NEW. Numbers older than
+ * BEAM_SEQ_WINDOW_SIZE cannot be checked and are reported as duplicates.
+ *
+ * @param state Initialized state. Must not be NULL.
+ * @param seq header.seq of the received frame.
+ * @param[out] out_result Receives the classification. Must not be NULL.
+ * @param[out] out_gap Optional; receives the number of skipped sequence numbers for BEAM_SEQ_GAP,
+ *                     otherwise 0. Can be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if state or out_result is NULL.
+ */
+esp_err_t beam_seq_update(beam_seq_state_t *state, uint8_t seq, beam_seq_result_t *out_result, uint8_t *out_gap);
+
+/**
+ * @brief Initializes a tracker with no peers.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tracker is NULL.
+ */
+esp_err_t beam_seq_tracker_init(beam_seq_tracker_t *tracker);
+
+/**
+ * @brief Looks up (or adds) the peer and calls beam_seq_update() on its state.
+ *
+ * @param tracker Initialized tracker. Must not be NULL.
+ * @param mac Sender address, BEAM_MAC_LEN bytes. Must not be NULL.
+ * @param seq header.seq of the received frame.
+ * @param[out] out_result Receives the classification. Must not be NULL.
+ * @param[out] out_gap Optional, as for beam_seq_update(). Can be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tracker, mac or out_result is NULL.
+ *         ESP_ERR_NO_MEM if the peer is new and all BEAM_SEQ_MAX_PEERS entries are taken. Not logged,
+ *         since it repeats for every frame of that peer; counted by beam_seq_tracker_get_rejected().
+ */
+esp_err_t beam_seq_tracker_update(beam_seq_tracker_t *tracker,
+                                  const uint8_t *mac,
+                                  uint8_t seq,
+                                  beam_seq_result_t *out_result,
+                                  uint8_t *out_gap);
+
+/**
+ * @brief Copies the counters of one peer.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if any pointer is NULL.
+ *         ESP_ERR_NOT_FOUND if the peer is not tracked.
+ */
+esp_err_t beam_seq_tracker_get_stats(const beam_seq_tracker_t *tracker,
+                                     const uint8_t *mac,
+                                     beam_seq_stats_t *out_stats);
+
+/**
+ * @brief Reads the number of frames refused with ESP_ERR_NO_MEM since beam_seq_tracker_init().
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if any pointer is NULL.
+ */
+esp_err_t beam_seq_tracker_get_rejected(const beam_seq_tracker_t *tracker, uint32_t *out_rejected);
+
+/**
+ * @brief Stops tracking a peer, freeing its entry.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if tracker or mac is NULL.
+ *         ESP_ERR_NOT_FOUND if the peer is not tracked.
+ */
+esp_err_t beam_seq_tracker_remove(beam_seq_tracker_t *tracker, const uint8_t *mac);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_SEQ_H */
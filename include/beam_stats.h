@@ -0,0 +1,95 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_STATS_H
+#define BEAM_STATS_H
+
+#include "beam_frame_builder.h"
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Component-wide parser and serializer counters (CONFIG_BEAM_STATS). They are updated
+ * with relaxed atomics from any task or ISR, so reading them never blocks the data
+ * path. Each field of a snapshot is read atomically, but fields are not captured at
+ * one instant: a frame finishing during beam_stats_get() may be counted in some fields
+ * and not yet in others.
+ */
+
+#define BEAM_STATS_CATEGORY_COUNT 256u /**< One per msg_category value */
+#define BEAM_STATS_SUMMARY_SIZE 36u    /**< Bytes beam_stats_put_summary() appends */
+
+/**
+ * @brief Snapshot of the counters since start or the last beam_stats_reset().
+ *
+ * Parse cycles are CPU cycles spent in validation and decoding of each accepted frame
+ * (nanoseconds on the host build).
+ */
+typedef struct beam_stats {
+    uint32_t frames_parsed;                           ///< Frames accepted by the parse and view paths
+    uint32_t bytes_parsed;                            ///< Wire bytes of the accepted frames
+    uint32_t frames_serialized;                       ///< Frames written by beam_serialize_frame() and the builder
+    uint32_t bytes_serialized;                        ///< Wire bytes of the written frames
+    uint32_t invalid_size;                            ///< Frames rejected with ESP_ERR_INVALID_SIZE
+    uint32_t invalid_crc;                             ///< Frames rejected with ESP_ERR_INVALID_CRC
+    uint32_t parse_cycles_min;                        ///< Fastest accepted frame; 0 if none
+    uint32_t parse_cycles_avg;                        ///< Mean over accepted frames; 0 if none
+    uint32_t parse_cycles_max;                        ///< Slowest accepted frame
+    uint32_t per_category[BEAM_STATS_CATEGORY_COUNT]; ///< Accepted frames by msg_category
+} beam_stats_t;
+
+/**
+ * @brief Copies the current counters.
+ *
+ * @param[out] out_stats Receives the snapshot. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if out_stats is NULL.
+ *         ESP_ERR_NOT_SUPPORTED if CONFIG_BEAM_STATS is disabled.
+ */
+esp_err_t beam_stats_get(beam_stats_t *out_stats);
+
+/**
+ * @brief Clears all counters.
+ */
+void beam_stats_reset(void);
+
+/**
+ * @brief Appends the scalar counters of stats to a frame being built, for sending them
+ *        to a ground station.
+ *
+ * Writes BEAM_STATS_SUMMARY_SIZE bytes: the nine uint32 fields from frames_parsed to
+ * parse_cycles_max in declaration order, little-endian. per_category does not fit in a
+ * frame; append the categories of interest with beam_frame_put_u32().
+ *
+ * @param builder Builder from beam_frame_begin().
+ * @param stats Snapshot from beam_stats_get().
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if builder or stats is NULL.
+ *         Otherwise the error from beam_frame_put_bytes().
+ */
+esp_err_t beam_stats_put_summary(beam_frame_builder_t *builder, const beam_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_STATS_H */
@@ -0,0 +1,146 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_STREAM_H
+#define BEAM_STREAM_H
+
+#include "beam_crc.h"
+#include "beam_frame.h"
+#include "beam_frame_view.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BEAM_STREAM_SYNC_BYTE 0xA5u      ///< Byte preceding every frame in BEAM_STREAM_MODE_SYNC
+#define BEAM_STREAM_COBS_DELIMITER 0x00u ///< Byte terminating every frame in BEAM_STREAM_MODE_COBS
+
+/* Worst-case COBS encoding of a frame: one overhead byte per 254 bytes, plus the delimiter */
+#define BEAM_STREAM_COBS_SIZE(frame_len) ((size_t)(frame_len) + (size_t)(frame_len) / 254u + 2u)
+#define BEAM_STREAM_MAX_ENCODED_SIZE BEAM_STREAM_COBS_SIZE(FRAME_MAX_SIZE) ///< Largest encoded frame
+
+/**
+ * @brief Wire framing used on byte-stream transports (UART, SPI bridges).
+ */
+typedef enum beam_stream_mode {
+    BEAM_STREAM_MODE_SYNC, ///< BEAM_STREAM_SYNC_BYTE, then the frame as is; boundaries come from header.len
+    BEAM_STREAM_MODE_COBS, ///< COBS-stuffed frame terminated by BEAM_STREAM_COBS_DELIMITER
+} beam_stream_mode_t;
+
+/**
+ * @brief Called for every valid frame found in the stream.
+ *
+ * The view points into the decoder's buffer and is only valid during the call.
+ */
+typedef void (*beam_stream_frame_cb_t)(const beam_frame_view_t *view, void *ctx);
+
+/**
+ * @brief Decoder counters.
+ */
+typedef struct beam_stream_stats {
+    uint32_t frames;          ///< Valid frames emitted
+    uint32_t crc_errors;      ///< Candidate frames rejected for CRC mismatch
+    uint32_t size_errors;     ///< Candidate frames rejected for length (or COBS structure)
+    uint32_t discarded_bytes; ///< Bytes skipped while hunting for a frame boundary
+} beam_stream_stats_t;
+
+/**
+ * @brief Stateful byte-stream decoder. Treat the fields as private.
+ *
+ * Holds at most one frame in a fixed internal buffer; nothing is allocated.
+ */
+typedef struct beam_stream_decoder {
+    beam_stream_mode_t mode;                   ///< Wire framing
+    beam_stream_frame_cb_t on_frame;           ///< Frame callback
+    void *ctx;                                 ///< Callback context
+    uint8_t buf[BEAM_STREAM_MAX_ENCODED_SIZE]; ///< Candidate frame bytes (sync) or encoded bytes (COBS)
+    size_t fill;                               ///< Bytes held in buf
+    bool synced;                               ///< Sync mode: a sync byte was seen and buf holds frame bytes
+    bool overflow;                             ///< COBS mode: discarding until the next delimiter
+    size_t crc_pos;                            ///< Sync mode: bytes of buf already fed to crc
+    beam_crc_ctx_t crc;                        ///< Sync mode: running CRC of the candidate frame
+    beam_stream_stats_t stats;                 ///< Counters
+} beam_stream_decoder_t;
+
+/**
+ * @brief Initializes a decoder.
+ *
+ * @param decoder Decoder to initialize. Must not be NULL.
+ * @param mode Wire framing.
+ * @param on_frame Callback for valid frames. Must not be NULL.
+ * @param ctx User context passed to on_frame.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if decoder or on_frame is NULL, or mode is unknown.
+ */
+esp_err_t beam_stream_decoder_init(beam_stream_decoder_t *decoder,
+                                   beam_stream_mode_t mode,
+                                   beam_stream_frame_cb_t on_frame,
+                                   void *ctx);
+
+/**
+ * @brief Feeds an arbitrary chunk of received bytes.
+ *
+ * Frames may span any number of calls. Corrupted or truncated frames are dropped and the
+ * decoder resynchronizes on the next frame boundary, including one already buffered.
+ *
+ * @param decoder Initialized decoder. Must not be NULL.
+ * @param data Received bytes. May be NULL only if len is 0.
+ * @param len Number of bytes.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if decoder or data is NULL.
+ */
+esp_err_t beam_stream_decoder_feed(beam_stream_decoder_t *decoder, const uint8_t *data, size_t len);
+
+/**
+ * @brief Drops any partially received frame. Counters are kept.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if decoder is NULL.
+ */
+esp_err_t beam_stream_decoder_reset(beam_stream_decoder_t *decoder);
+
+/**
+ * @brief Wraps a serialized frame for a byte-stream transport.
+ *
+ * @param mode Wire framing.
+ * @param frame Serialized frame (e.g. from beam_serialize_frame()). Must not be NULL.
+ * @param frame_len Frame length in bytes.
+ * @param out_buffer Buffer to write the encoded bytes. Must not be NULL.
+ * @param buffer_size Size of out_buffer: at least frame_len + 1 (sync) or BEAM_STREAM_COBS_SIZE(frame_len) (COBS).
+ * @param[out] out_size Optional pointer to receive the number of bytes written. Can be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if frame or out_buffer is NULL, or mode is unknown.
+ *         ESP_ERR_INVALID_SIZE if frame_len is outside FRAME_MIN_SIZE..FRAME_MAX_SIZE or buffer_size is too small.
+ */
+esp_err_t beam_stream_encode(beam_stream_mode_t mode,
+                             const uint8_t *frame,
+                             size_t frame_len,
+                             uint8_t *out_buffer,
+                             size_t buffer_size,
+                             size_t *out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_STREAM_H */
@@ -0,0 +1,159 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_TELEMETRY_H
+#define BEAM_TELEMETRY_H
+
+#include "beam_frame_view.h"
+#include "beam_message_common.h"
+#include "beam_payload_type.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Compact MSG_CAT_TELEMETRY encodings, selected by header flags:
+ *   MSG_FLAG_COMPACT                  keyframe: [key id] + roll, pitch, yaw as int16 LE, angle * scale (7 bytes)
+ *   MSG_FLAG_COMPACT | MSG_FLAG_DELTA delta: [key id] + three int8 steps from that keyframe (4 bytes)
+ * Deltas refer to the keyframe, not to the previous frame, so losing a delta frame costs nothing.
+ * The key id is the encoder's own keyframe counter rather than the header seq, so layers that
+ * renumber frames (beam_arq_send() for MSG_FLAG_ACK_REQ) do not break the reference.
+ */
+
+#define BEAM_TELEMETRY_COMPACT_SCALE CONFIG_BEAM_TELEMETRY_COMPACT_SCALE         ///< Fixed-point steps per angle unit
+#define BEAM_TELEMETRY_KEYFRAME_INTERVAL CONFIG_BEAM_TELEMETRY_KEYFRAME_INTERVAL ///< Frames per keyframe
+#define BEAM_TELEMETRY_KEYFRAME_SIZE 7u                                          ///< Compact keyframe payload bytes
+#define BEAM_TELEMETRY_DELTA_SIZE 4u                                             ///< Delta payload bytes
+#define BEAM_TELEMETRY_COMPACT_MAX_SIZE BEAM_TELEMETRY_KEYFRAME_SIZE             ///< Largest compact payload
+
+/**
+ * @brief Sender state: the last keyframe deltas are taken against. Treat the fields as private.
+ */
+typedef struct beam_telemetry_encoder {
+    int16_t key[3];    ///< Keyframe angles in fixed point
+    uint8_t key_id;    ///< Id of the current keyframe, incremented per keyframe
+    uint8_t since_key; ///< Frames sent since the keyframe
+    bool has_key;      ///< False until the first keyframe
+} beam_telemetry_encoder_t;
+
+/**
+ * @brief Receiver state: the last keyframe received. Treat the fields as private.
+ */
+typedef struct beam_telemetry_decoder {
+    int16_t key[3]; ///< Keyframe angles in fixed point
+    uint8_t key_id; ///< Id of the keyframe
+    bool has_key;   ///< False until the first keyframe
+} beam_telemetry_decoder_t;
+
+/**
+ * @brief Resets an encoder so its next frame is a keyframe.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if encoder is NULL.
+ */
+esp_err_t beam_telemetry_encoder_init(beam_telemetry_encoder_t *encoder);
+
+/**
+ * @brief Encodes a sample as a compact keyframe or delta payload.
+ *
+ * A keyframe is emitted for the first sample, every BEAM_TELEMETRY_KEYFRAME_INTERVAL frames,
+ * and whenever a step from the keyframe does not fit in int8. Angles outside the int16 range
+ * saturate. Send the payload in a MSG_CAT_TELEMETRY frame with out_flags ORed into the header
+ * flags, serialized with beam_serialize_frame() (the frame builder rejects encoding flags);
+ * the header seq is free for the transport to assign.
+ *
+ * @param encoder Initialized encoder. Must not be NULL.
+ * @param telemetry Sample to encode. Must not be NULL.
+ * @param[out] out_payload Buffer of at least BEAM_TELEMETRY_COMPACT_MAX_SIZE bytes. Must not be NULL.
+ * @param[out] out_len Receives the payload length. Must not be NULL.
+ * @param[out] out_flags Receives MSG_FLAG_COMPACT, plus MSG_FLAG_DELTA for deltas. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if any pointer is NULL.
+ */
+esp_err_t beam_telemetry_encode(beam_telemetry_encoder_t *encoder,
+                                const beam_payload_telemetry_t *telemetry,
+                                uint8_t *out_payload,
+                                uint8_t *out_len,
+                                beam_flags_t *out_flags);
+
+/**
+ * @brief Resets a decoder to wait for the next keyframe.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if decoder is NULL.
+ */
+esp_err_t beam_telemetry_decoder_init(beam_telemetry_decoder_t *decoder);
+
+/**
+ * @brief Reconstructs the float sample from a MSG_CAT_TELEMETRY frame in any encoding.
+ *
+ * Plain and keyframe payloads decode on their own (keyframes also update decoder);
+ * deltas need the keyframe they refer to.
+ *
+ * @param decoder Initialized decoder, one per sender. Must not be NULL.
+ * @param view Validated MSG_CAT_TELEMETRY frame. Must not be NULL.
+ * @param[out] out_telemetry Receives the sample. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if any pointer is NULL or the frame is not MSG_CAT_TELEMETRY.
+ *         ESP_ERR_INVALID_SIZE if the payload length does not match its encoding.
+ *         ESP_ERR_NOT_FOUND if a delta refers to a keyframe that was not received.
+ */
+esp_err_t beam_telemetry_decode(beam_telemetry_decoder_t *decoder,
+                                const beam_frame_view_t *view,
+                                beam_payload_telemetry_t *out_telemetry);
+
+/**
+ * @brief Same as beam_telemetry_decode() for a payload taken out of its frame, e.g. after decompression.
+ *
+ * Payload errors are returned but not logged, so this may run for every received frame.
+ *
+ * @param decoder Initialized decoder, one per sender. Must not be NULL.
+ * @param flags Header flags of the frame (MSG_FLAG_COMPACT, MSG_FLAG_DELTA).
+ * @param payload Payload bytes. Must not be NULL.
+ * @param len Number of payload bytes.
+ * @param[out] out_telemetry Receives the sample. Must not be NULL.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_ARG if any pointer is NULL.
+ *         ESP_ERR_INVALID_SIZE if len does not match the encoding.
+ *         ESP_ERR_NOT_FOUND if a delta refers to a keyframe that was not received.
+ */
+esp_err_t beam_telemetry_decode_payload(beam_telemetry_decoder_t *decoder,
+                                        beam_flags_t flags,
+                                        const uint8_t *payload,
+                                        uint8_t len,
+                                        beam_payload_telemetry_t *out_telemetry);
+
+/**
+ * @brief Converts a compact keyframe payload to floats. Needs no state.
+ *
+ * @param payload BEAM_TELEMETRY_KEYFRAME_SIZE payload bytes. Must not be NULL.
+ * @param[out] out_telemetry Receives the sample. Must not be NULL.
+ */
+void beam_telemetry_from_keyframe(const uint8_t *payload, beam_payload_telemetry_t *out_telemetry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BEAM_TELEMETRY_H */
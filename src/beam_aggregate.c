@@ -0,0 +1,210 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_aggregate.h"
+#include "beam_frame_internal.h"
+#include "esp_check.h"
+#include <string.h>
+
+static const char *TAG = "[BEAM_aggregate]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define AGGREGATE_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+#define COALESCER_FLAGS (MSG_FLAG_PRIORITY | MSG_FLAG_ACK_REQ) /**< Flags that hold for any payload */
+
+/**
+ * @brief Hand the pending frame to the sink and start over.
+ *
+ * A single pending message is unwrapped into a plain frame of its own category, which
+ * saves the sub-message header and lets receivers skip the iterator; a lone
+ * MSG_CAT_AGGREGATE sub-message stays wrapped, or it would be read as an aggregate.
+ * The frame takes the caller's sequence number now, so it is in order with the frames
+ * sent while it was pending; MSG_FLAG_ACK_REQ frames are numbered by beam_arq_send()
+ * instead. It is discarded even if the sink fails.
+ */
+static esp_err_t flush_pending(beam_coalescer_t *coalescer)
+{
+    if (coalescer->count == 0) {
+        return ESP_OK;
+    }
+
+    uint8_t *buf = coalescer->buf;
+    size_t frame_len = 0;
+
+    if (!(coalescer->flags & MSG_FLAG_ACK_REQ)) {
+        buf[FRAME_OFFSET_SEQ] = (*coalescer->seq)++;
+    }
+    if (coalescer->count == 1 && buf[FRAME_HEADER_SIZE] != MSG_CAT_AGGREGATE) {
+        uint8_t category = buf[FRAME_HEADER_SIZE];
+        uint8_t len = buf[FRAME_HEADER_SIZE + 1];
+        memmove(buf + FRAME_HEADER_SIZE, buf + FRAME_HEADER_SIZE + BEAM_AGGREGATE_ITEM_HEADER_SIZE, len);
+        buf[FRAME_OFFSET_CATEGORY] = category;
+        buf[FRAME_OFFSET_LEN] = len;
+        frame_write_crc(buf + FRAME_HEADER_SIZE + len, frame_crc(buf, FRAME_HEADER_SIZE + len));
+        frame_len = FRAME_SIZE(len);
+    }
+    else {
+        beam_frame_finish(&coalescer->builder, &frame_len);
+    }
+
+    coalescer->count = 0;
+
+    return coalescer->flush(buf, frame_len, coalescer->ctx);
+}
+
+esp_err_t beam_aggregate_put(beam_frame_builder_t *builder,
+                             beam_msg_category_t category,
+                             const uint8_t *payload,
+                             uint8_t len)
+{
+    AGGREGATE_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE(payload != NULL || len == 0, "payload pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE((size_t)builder->len + BEAM_AGGREGATE_ITEM_HEADER_SIZE + len <= MAX_PAYLOAD_SIZE &&
+                                  FRAME_SIZE((size_t)builder->len + BEAM_AGGREGATE_ITEM_HEADER_SIZE + len) <=
+                                      builder->cap,
+                              "no room for sub-message",
+                              ESP_ERR_INVALID_SIZE);
+
+    uint8_t item_header[BEAM_AGGREGATE_ITEM_HEADER_SIZE] = {category, len};
+    beam_frame_put_bytes(builder, item_header, sizeof(item_header));
+
+    return beam_frame_put_bytes(builder, payload, len);
+}
+
+esp_err_t beam_aggregate_iter_init(beam_aggregate_iter_t *it, const beam_frame_view_t *view)
+{
+    AGGREGATE_RETURN_ON_FALSE(it != NULL, "it pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE(beam_frame_view_category(view) == MSG_CAT_AGGREGATE,
+                              "frame is not MSG_CAT_AGGREGATE",
+                              ESP_ERR_INVALID_ARG);
+
+    it->pos = beam_frame_view_payload(view);
+    it->end = it->pos + beam_frame_view_payload_len(view);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_aggregate_next(beam_aggregate_iter_t *it, beam_aggregate_item_t *out_item)
+{
+    AGGREGATE_RETURN_ON_FALSE(it != NULL, "it pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE(out_item != NULL, "out_item pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    size_t remaining = (size_t)(it->end - it->pos);
+    if (remaining == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    AGGREGATE_RETURN_ON_FALSE(remaining >= BEAM_AGGREGATE_ITEM_HEADER_SIZE &&
+                                  remaining - BEAM_AGGREGATE_ITEM_HEADER_SIZE >= it->pos[1],
+                              "truncated sub-message",
+                              ESP_ERR_INVALID_SIZE);
+
+    out_item->category = it->pos[0];
+    out_item->len = it->pos[1];
+    out_item->payload = it->pos + BEAM_AGGREGATE_ITEM_HEADER_SIZE;
+    it->pos += BEAM_AGGREGATE_ITEM_HEADER_SIZE + out_item->len;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_coalescer_init(beam_coalescer_t *coalescer,
+                              beam_flags_t flags,
+                              uint8_t *seq,
+                              uint32_t max_delay_us,
+                              beam_coalescer_flush_cb_t flush,
+                              void *ctx)
+{
+    AGGREGATE_RETURN_ON_FALSE(coalescer != NULL, "coalescer pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE(seq != NULL || (flags & MSG_FLAG_ACK_REQ), "seq pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE(flush != NULL, "flush pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE((flags & ~COALESCER_FLAGS) == 0,
+                              "only MSG_FLAG_PRIORITY and MSG_FLAG_ACK_REQ are supported",
+                              ESP_ERR_INVALID_ARG);
+
+    coalescer->count = 0;
+    coalescer->seq = seq;
+    coalescer->flags = flags;
+    coalescer->max_delay_us = max_delay_us;
+    coalescer->deadline_us = 0;
+    coalescer->flush = flush;
+    coalescer->ctx = ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_coalescer_add(beam_coalescer_t *coalescer,
+                             beam_msg_category_t category,
+                             const uint8_t *payload,
+                             uint8_t len,
+                             int64_t now_us)
+{
+    AGGREGATE_RETURN_ON_FALSE(coalescer != NULL, "coalescer pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE(payload != NULL || len == 0, "payload pointer is NULL", ESP_ERR_INVALID_ARG);
+    AGGREGATE_RETURN_ON_FALSE(len <= BEAM_AGGREGATE_MAX_ITEM_LEN,
+                              "len exceeds BEAM_AGGREGATE_MAX_ITEM_LEN",
+                              ESP_ERR_INVALID_SIZE);
+
+    esp_err_t err = ESP_OK;
+    if (coalescer->count > 0 &&
+        (size_t)coalescer->builder.len + BEAM_AGGREGATE_ITEM_HEADER_SIZE + len > MAX_PAYLOAD_SIZE) {
+        err = flush_pending(coalescer);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    if (coalescer->count == 0) {
+        beam_frame_begin(&coalescer->builder,
+                         coalescer->buf,
+                         sizeof(coalescer->buf),
+                         MSG_CAT_AGGREGATE,
+                         coalescer->flags,
+                         0);
+        coalescer->deadline_us = now_us + coalescer->max_delay_us;
+    }
+
+    beam_aggregate_put(&coalescer->builder, category, payload, len);
+    coalescer->count++;
+
+    // Nothing else can fit: no reason to wait for the deadline
+    if (coalescer->builder.len + BEAM_AGGREGATE_ITEM_HEADER_SIZE >= MAX_PAYLOAD_SIZE) {
+        err = flush_pending(coalescer);
+    }
+
+    return err;
+}
+
+esp_err_t beam_coalescer_poll(beam_coalescer_t *coalescer, int64_t now_us)
+{
+    AGGREGATE_RETURN_ON_FALSE(coalescer != NULL, "coalescer pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    if (coalescer->count == 0 || now_us < coalescer->deadline_us) {
+        return ESP_OK;
+    }
+
+    return flush_pending(coalescer);
+}
+
+esp_err_t beam_coalescer_flush(beam_coalescer_t *coalescer)
+{
+    AGGREGATE_RETURN_ON_FALSE(coalescer != NULL, "coalescer pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    return flush_pending(coalescer);
+}
@@ -0,0 +1,326 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_arq.h"
+#include "beam_frame_builder.h"
+#include "beam_frame_internal.h"
+#include "beam_message_common.h"
+#include "beam_pool.h"
+#include "esp_check.h"
+#include <string.h>
+
+static const char *TAG = "[BEAM_arq]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define ARQ_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/**
+ * @brief Clamp a timeout to [BEAM_ARQ_MIN_RTO_US, BEAM_ARQ_MAX_RTO_US].
+ */
+static uint32_t clamp_rto(uint64_t rto_us)
+{
+    if (rto_us < BEAM_ARQ_MIN_RTO_US) {
+        return BEAM_ARQ_MIN_RTO_US;
+    }
+    if (rto_us > BEAM_ARQ_MAX_RTO_US) {
+        return BEAM_ARQ_MAX_RTO_US;
+    }
+
+    return (uint32_t)rto_us;
+}
+
+/**
+ * @brief Feed one round-trip sample into the RFC 6298 estimator and recompute the timeout.
+ */
+static void update_rtt(beam_arq_tx_t *tx, uint32_t rtt_us)
+{
+    if (!tx->has_rtt) {
+        tx->srtt_us = rtt_us;
+        tx->rttvar_us = rtt_us / 2;
+        tx->has_rtt = true;
+    }
+    else {
+        uint32_t err_us = tx->srtt_us > rtt_us ? tx->srtt_us - rtt_us : rtt_us - tx->srtt_us;
+        tx->rttvar_us = tx->rttvar_us - tx->rttvar_us / 4 + err_us / 4;
+        tx->srtt_us = tx->srtt_us - tx->srtt_us / 8 + rtt_us / 8;
+    }
+
+    tx->rto_us = clamp_rto((uint64_t)tx->srtt_us + 4u * (uint64_t)tx->rttvar_us);
+}
+
+/**
+ * @brief Return an entry's buffer to the pool and mark the entry free.
+ */
+static void release_entry(beam_arq_entry_t *entry)
+{
+    beam_pool_release(entry->buf);
+    entry->buf = NULL;
+}
+
+/**
+ * @brief Write the ACK for state into out as a complete MSG_CAT_ACK frame.
+ */
+static void build_ack(const beam_seq_state_t *state, beam_frame_buf_t *out)
+{
+    beam_frame_builder_t builder;
+    size_t size = 0;
+
+    beam_frame_begin_len(&builder,
+                         out->data,
+                         sizeof(out->data),
+                         MSG_CAT_ACK,
+                         0,
+                         state->newest,
+                         BEAM_ARQ_ACK_PAYLOAD_SIZE);
+    beam_frame_put_u8(&builder, state->newest);
+    beam_frame_put_u32(&builder, state->window);
+    beam_frame_finish(&builder, &size);
+
+    out->len = (uint16_t)size;
+}
+
+/**
+ * @brief Whether the next frame keeps every retained one within the receiver's window of it.
+ */
+static bool seq_span_allows(const beam_arq_tx_t *tx)
+{
+    for (size_t i = 0; i < BEAM_ARQ_WINDOW_SIZE; i++) {
+        const beam_arq_entry_t *entry = &tx->window[i];
+        if (entry->buf != NULL && (uint8_t)(tx->next_seq - entry->seq) >= BEAM_SEQ_WINDOW_SIZE) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+esp_err_t beam_arq_tx_init(beam_arq_tx_t *tx, beam_arq_send_cb_t send, beam_arq_fail_cb_t on_fail, void *ctx)
+{
+    ARQ_RETURN_ON_FALSE(tx != NULL, "tx pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(send != NULL, "send pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(tx, 0, sizeof(*tx));
+    tx->rto_us = BEAM_ARQ_INITIAL_RTO_US;
+    tx->send = send;
+    tx->on_fail = on_fail;
+    tx->ctx = ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_arq_send(beam_arq_tx_t *tx, const uint8_t *frame, size_t frame_len, int64_t now_us)
+{
+    ARQ_RETURN_ON_FALSE(tx != NULL, "tx pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(frame != NULL, "frame pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(frame_len >= FRAME_MIN_SIZE && frame_len <= FRAME_MAX_SIZE,
+                        "frame_len outside [FRAME_MIN_SIZE, FRAME_MAX_SIZE]",
+                        ESP_ERR_INVALID_SIZE);
+
+    // Best-effort frames skip the window entirely
+    if (!(frame[FRAME_OFFSET_FLAGS] & MSG_FLAG_ACK_REQ)) {
+        return tx->send(frame, frame_len, tx->ctx);
+    }
+
+    beam_arq_entry_t *entry = NULL;
+    for (size_t i = 0; i < BEAM_ARQ_WINDOW_SIZE && entry == NULL; i++) {
+        if (tx->window[i].buf == NULL) {
+            entry = &tx->window[i];
+        }
+    }
+    if (entry == NULL || !seq_span_allows(tx) || beam_pool_acquire(&entry->buf) != ESP_OK) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint8_t *data = entry->buf->data;
+    memcpy(data, frame, frame_len);
+    data[FRAME_OFFSET_SEQ] = tx->next_seq;
+    frame_write_crc(data + frame_len - FRAME_CRC_SIZE, frame_crc(data, frame_len - FRAME_CRC_SIZE));
+    entry->buf->len = (uint16_t)frame_len;
+    entry->seq = tx->next_seq++;
+    entry->retries = 0;
+    entry->sent_us = now_us;
+    tx->stats.sent++;
+
+    return tx->send(entry->buf->data, frame_len, tx->ctx);
+}
+
+esp_err_t beam_arq_handle_ack(beam_arq_tx_t *tx, const beam_frame_view_t *view, int64_t now_us)
+{
+    ARQ_RETURN_ON_FALSE(tx != NULL, "tx pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(beam_frame_view_category(view) == MSG_CAT_ACK,
+                        "frame is not MSG_CAT_ACK",
+                        ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(beam_frame_view_payload_len(view) == BEAM_ARQ_ACK_PAYLOAD_SIZE,
+                        "ACK payload size mismatch",
+                        ESP_ERR_INVALID_SIZE);
+
+    const uint8_t *payload = beam_frame_view_payload(view);
+    uint8_t ack_seq = payload[0];
+    uint32_t bitmap = (uint32_t)payload[1] | ((uint32_t)payload[2] << 8) | ((uint32_t)payload[3] << 16) |
+                      ((uint32_t)payload[4] << 24);
+
+    // Only the last BEAM_SEQ_WINDOW_SIZE seq values sent can be acknowledged; anything else aliases
+    if ((uint8_t)(tx->next_seq - 1u - ack_seq) >= BEAM_SEQ_WINDOW_SIZE) {
+        return ESP_OK;
+    }
+
+    for (size_t i = 0; i < BEAM_ARQ_WINDOW_SIZE; i++) {
+        beam_arq_entry_t *entry = &tx->window[i];
+        uint8_t age = (uint8_t)(ack_seq - entry->seq);
+        if (entry->buf == NULL || age >= BEAM_SEQ_WINDOW_SIZE || !(bitmap & (1u << age))) {
+            continue;
+        }
+
+        // Karn's rule: the RTT of a retransmitted frame is ambiguous
+        if (entry->retries == 0) {
+            update_rtt(tx, (uint32_t)(now_us - entry->sent_us));
+        }
+        release_entry(entry);
+        tx->stats.acked++;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_arq_poll(beam_arq_tx_t *tx, int64_t now_us)
+{
+    ARQ_RETURN_ON_FALSE(tx != NULL, "tx pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    bool expired = false;
+    for (size_t i = 0; i < BEAM_ARQ_WINDOW_SIZE; i++) {
+        beam_arq_entry_t *entry = &tx->window[i];
+        if (entry->buf == NULL || now_us - entry->sent_us < (int64_t)tx->rto_us) {
+            continue;
+        }
+
+        expired = true;
+        if (entry->retries >= BEAM_ARQ_MAX_RETRIES) {
+            uint8_t seq = entry->seq;
+            release_entry(entry);
+            tx->stats.failed++;
+            if (tx->on_fail != NULL) {
+                tx->on_fail(seq, tx->ctx);
+            }
+            continue;
+        }
+
+        entry->retries++;
+        entry->sent_us = now_us;
+        tx->stats.retransmits++;
+        tx->send(entry->buf->data, entry->buf->len, tx->ctx);
+    }
+
+    // Back off once per expiry round, as RFC 6298 5.5 does per timer expiry
+    if (expired) {
+        tx->rto_us = clamp_rto(2u * (uint64_t)tx->rto_us);
+    }
+
+    return ESP_OK;
+}
+
+size_t beam_arq_in_flight(const beam_arq_tx_t *tx)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < BEAM_ARQ_WINDOW_SIZE; i++) {
+        count += tx->window[i].buf != NULL;
+    }
+
+    return count;
+}
+
+esp_err_t beam_arq_tx_reset(beam_arq_tx_t *tx)
+{
+    ARQ_RETURN_ON_FALSE(tx != NULL, "tx pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    for (size_t i = 0; i < BEAM_ARQ_WINDOW_SIZE; i++) {
+        if (tx->window[i].buf != NULL) {
+            release_entry(&tx->window[i]);
+        }
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_arq_rx_init(beam_arq_rx_t *rx)
+{
+    ARQ_RETURN_ON_FALSE(rx != NULL, "rx pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(rx, 0, sizeof(*rx));
+
+    return ESP_OK;
+}
+
+esp_err_t beam_arq_receive(beam_arq_rx_t *rx,
+                           const beam_frame_view_t *view,
+                           bool *out_deliver,
+                           beam_frame_buf_t *out_ack)
+{
+    ARQ_RETURN_ON_FALSE(rx != NULL, "rx pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(out_deliver != NULL, "out_deliver pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(out_ack != NULL, "out_ack pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    out_ack->len = 0;
+    *out_deliver = true;
+
+    // Best-effort frames and ACKs live outside the sequence space of reliable frames
+    if (!(beam_frame_view_flags(view) & MSG_FLAG_ACK_REQ)) {
+        return ESP_OK;
+    }
+
+    // Too far behind to tell a duplicate from a lost frame; the sender never retransmits that old
+    uint8_t seq = beam_frame_view_seq(view);
+    uint8_t age = (uint8_t)(rx->seq.newest - seq);
+    if (rx->seq.started && age >= BEAM_SEQ_WINDOW_SIZE && age <= INT8_MAX + 1) {
+        if (++rx->stale_run < BEAM_ARQ_RESYNC_STALE) {
+            rx->stale++;
+            *out_deliver = false;
+            return ESP_OK;
+        }
+
+        // A run of them means the sender restarted from 0: start a new sequence here
+        beam_seq_stats_t stats = rx->seq.stats;
+        beam_seq_init(&rx->seq);
+        rx->seq.stats = stats;
+        rx->resyncs++;
+    }
+    rx->stale_run = 0;
+
+    beam_seq_result_t result = BEAM_SEQ_NEW;
+    beam_seq_update(&rx->seq, seq, &result, NULL);
+    *out_deliver = result != BEAM_SEQ_DUPLICATE;
+
+    // Duplicates are ACKed again: the previous ACK was probably lost
+    build_ack(&rx->seq, out_ack);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_arq_rx_get_stats(const beam_arq_rx_t *rx, beam_arq_rx_stats_t *out_stats)
+{
+    ARQ_RETURN_ON_FALSE(rx != NULL, "rx pointer is NULL", ESP_ERR_INVALID_ARG);
+    ARQ_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    out_stats->seq = rx->seq.stats;
+    out_stats->stale = rx->stale;
+    out_stats->resyncs = rx->resyncs;
+
+    return ESP_OK;
+}
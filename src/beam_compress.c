@@ -0,0 +1,240 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_compress.h"
+#include "beam_message_common.h"
+#include "esp_check.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define NIBBLE_MAX 15u /**< Nibble value announcing extension bytes */
+#define HASH_BITS 7u   /**< Match finder table of 1 << HASH_BITS entries */
+#define HASH_EMPTY 0u  /**< Table slot without a position (positions are stored + 1) */
+
+static const char *TAG = "[BEAM_compress]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define COMPRESS_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/**
+ * @brief Table slot for the BEAM_COMPRESS_MIN_MATCH bytes at p (multiplicative hash).
+ */
+static uint8_t hash3(const uint8_t *p)
+{
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+
+    return (uint8_t)((v * 2654435761u) >> (32 - HASH_BITS));
+}
+
+/**
+ * @brief Output cursor; ok drops to false once a write would pass end.
+ */
+typedef struct writer {
+    uint8_t *pos;
+    uint8_t *end;
+    bool ok;
+} writer_t;
+
+static void put_byte(writer_t *w, uint8_t value)
+{
+    if (w->pos >= w->end) {
+        w->ok = false;
+        return;
+    }
+    *w->pos++ = value;
+}
+
+/**
+ * @brief Write the extension bytes of a length whose nibble was NIBBLE_MAX.
+ */
+static void put_length(writer_t *w, size_t n)
+{
+    for (; n >= UINT8_MAX; n -= UINT8_MAX) {
+        put_byte(w, UINT8_MAX);
+    }
+    put_byte(w, (uint8_t)n);
+}
+
+/**
+ * @brief Write one sequence: literals, then a match unless match_len is 0 (last sequence).
+ */
+static void put_sequence(writer_t *w, const uint8_t *literals, size_t lit_len, uint8_t offset, size_t match_len)
+{
+    size_t match_code = match_len == 0 ? 0 : match_len - BEAM_COMPRESS_MIN_MATCH;
+    uint8_t lit_nibble = lit_len < NIBBLE_MAX ? (uint8_t)lit_len : NIBBLE_MAX;
+    uint8_t match_nibble = match_code < NIBBLE_MAX ? (uint8_t)match_code : NIBBLE_MAX;
+
+    put_byte(w, (uint8_t)(lit_nibble << 4 | match_nibble));
+    if (lit_nibble == NIBBLE_MAX) {
+        put_length(w, lit_len - NIBBLE_MAX);
+    }
+    if (!w->ok || (size_t)(w->end - w->pos) < lit_len) {
+        w->ok = false;
+        return;
+    }
+    memcpy(w->pos, literals, lit_len);
+    w->pos += lit_len;
+
+    if (match_len == 0) {
+        return;
+    }
+    put_byte(w, offset);
+    if (match_nibble == NIBBLE_MAX) {
+        put_length(w, match_code - NIBBLE_MAX);
+    }
+}
+
+/**
+ * @brief Read a nibble-coded length, adding extension bytes when nibble is NIBBLE_MAX.
+ *
+ * @return false if the stream ends inside the extension.
+ */
+static bool get_length(const uint8_t **pos, const uint8_t *end, uint8_t nibble, size_t *out)
+{
+    size_t n = nibble;
+    if (nibble == NIBBLE_MAX) {
+        uint8_t b = UINT8_MAX;
+        while (b == UINT8_MAX) {
+            if (*pos >= end) {
+                return false;
+            }
+            b = *(*pos)++;
+            n += b;
+        }
+    }
+    *out = n;
+
+    return true;
+}
+
+esp_err_t beam_compress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap, size_t *out_len)
+{
+    COMPRESS_RETURN_ON_FALSE(src != NULL || src_len == 0, "src pointer is NULL", ESP_ERR_INVALID_ARG);
+    COMPRESS_RETURN_ON_FALSE(dst != NULL, "dst pointer is NULL", ESP_ERR_INVALID_ARG);
+    COMPRESS_RETURN_ON_FALSE(out_len != NULL, "out_len pointer is NULL", ESP_ERR_INVALID_ARG);
+    COMPRESS_RETURN_ON_FALSE(src_len <= MAX_PAYLOAD_SIZE, "src_len exceeds MAX_PAYLOAD_SIZE", ESP_ERR_INVALID_SIZE);
+
+    uint8_t table[1u << HASH_BITS];
+    memset(table, HASH_EMPTY, sizeof(table));
+
+    writer_t w = {.pos = dst, .end = dst + dst_cap, .ok = true};
+    size_t anchor = 0;
+    size_t i = 0;
+
+    // Greedy parse: take the most recent earlier position with the same hash if it matches
+    while (w.ok && i + BEAM_COMPRESS_MIN_MATCH <= src_len) {
+        uint8_t slot = hash3(src + i);
+        size_t candidate = table[slot];
+        table[slot] = (uint8_t)(i + 1);
+
+        if (candidate == HASH_EMPTY || memcmp(src + candidate - 1, src + i, BEAM_COMPRESS_MIN_MATCH) != 0) {
+            i++;
+            continue;
+        }
+        candidate--;
+
+        size_t match_len = BEAM_COMPRESS_MIN_MATCH;
+        while (i + match_len < src_len && src[candidate + match_len] == src[i + match_len]) {
+            match_len++;
+        }
+
+        put_sequence(&w, src + anchor, i - anchor, (uint8_t)(i - candidate), match_len);
+        i += match_len;
+        anchor = i;
+    }
+    if (w.ok) {
+        put_sequence(&w, src + anchor, src_len - anchor, 0, 0);
+    }
+
+    if (!w.ok) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    *out_len = (size_t)(w.pos - dst);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap, size_t *out_len)
+{
+    COMPRESS_RETURN_ON_FALSE(src != NULL, "src pointer is NULL", ESP_ERR_INVALID_ARG);
+    COMPRESS_RETURN_ON_FALSE(dst != NULL, "dst pointer is NULL", ESP_ERR_INVALID_ARG);
+    COMPRESS_RETURN_ON_FALSE(out_len != NULL, "out_len pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    const uint8_t *in = src;
+    const uint8_t *in_end = src + src_len;
+    size_t out = 0;
+
+    while (in < in_end) {
+        uint8_t token = *in++;
+
+        size_t lit_len = 0;
+        if (!get_length(&in, in_end, token >> 4, &lit_len) || lit_len > (size_t)(in_end - in) ||
+            lit_len > dst_cap - out) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(dst + out, in, lit_len);
+        in += lit_len;
+        out += lit_len;
+
+        if (in == in_end) {
+            break; // Last sequence: literals only
+        }
+
+        uint8_t offset = *in++;
+        size_t match_len = 0;
+        if (offset == 0 || offset > out || !get_length(&in, in_end, token & NIBBLE_MAX, &match_len)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        match_len += BEAM_COMPRESS_MIN_MATCH;
+        if (match_len > dst_cap - out) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        // Byte by byte: a match may overlap the bytes it produces (runs)
+        for (size_t k = 0; k < match_len; k++, out++) {
+            dst[out] = dst[out - offset];
+        }
+    }
+
+    *out_len = out;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_decompress_view(const beam_frame_view_t *view, uint8_t *dst, size_t dst_cap, size_t *out_len)
+{
+    COMPRESS_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+    COMPRESS_RETURN_ON_FALSE(dst != NULL, "dst pointer is NULL", ESP_ERR_INVALID_ARG);
+    COMPRESS_RETURN_ON_FALSE(out_len != NULL, "out_len pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    const uint8_t *payload = beam_frame_view_payload(view);
+    uint8_t len = beam_frame_view_payload_len(view);
+
+    if (beam_frame_view_flags(view) & MSG_FLAG_COMPRESSED) {
+        return beam_decompress(payload, len, dst, dst_cap, out_len);
+    }
+
+    if (len > dst_cap) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, payload, len);
+    *out_len = len;
+
+    return ESP_OK;
+}
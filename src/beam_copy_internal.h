@@ -0,0 +1,69 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_COPY_INTERNAL_H
+#define BEAM_COPY_INTERNAL_H
+
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Bulk copy for payloads and frame buffers. With CONFIG_BEAM_COPY_PIE (ESP32-S3) the
+ * 16-byte-aligned middle of a copy whose source and destination share the same offset
+ * within 16 bytes goes through the PIE vector load/store (beam_copy_pie.S); everything
+ * else, and every other target, uses memcpy. The bytes written are the same either way.
+ */
+
+#if CONFIG_BEAM_COPY_PIE
+
+#define COPY_PIE_ALIGN 16u   /**< Width of one q register */
+#define COPY_PIE_MIN_LEN 64u /**< Below this the head/tail split costs more than it saves */
+
+/**
+ * @brief Copy blocks * 16 bytes between 16-byte-aligned buffers (beam_copy_pie.S).
+ */
+void beam_copy_pie(uint8_t *dst, const uint8_t *src, size_t blocks);
+
+static inline void beam_copy(void *dst, const void *src, size_t len)
+{
+    uint8_t *d = dst;
+    const uint8_t *s = src;
+    size_t head = (size_t)(-(uintptr_t)d & (COPY_PIE_ALIGN - 1u));
+
+    if (len < COPY_PIE_MIN_LEN || (((uintptr_t)d ^ (uintptr_t)s) & (COPY_PIE_ALIGN - 1u)) != 0) {
+        memcpy(d, s, len);
+        return;
+    }
+
+    size_t blocks = (len - head) / COPY_PIE_ALIGN;
+    size_t body = blocks * COPY_PIE_ALIGN;
+    memcpy(d, s, head);
+    beam_copy_pie(d + head, s + head, blocks);
+    memcpy(d + head + body, s + head + body, len - head - body);
+}
+
+#else
+
+static inline void beam_copy(void *dst, const void *src, size_t len)
+{
+    memcpy(dst, src, len);
+}
+
+#endif /* CONFIG_BEAM_COPY_PIE */
+
+#endif /* BEAM_COPY_INTERNAL_H */
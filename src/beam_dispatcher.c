@@ -0,0 +1,126 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_dispatcher.h"
+#include "esp_check.h"
+#include <string.h>
+
+#define SUBSCRIBER_NONE UINT8_MAX /**< End of a category's subscriber chain */
+
+static const char *TAG = "[BEAM_dispatcher]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define DISPATCHER_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+esp_err_t beam_dispatcher_init(beam_dispatcher_t *dispatcher)
+{
+    DISPATCHER_RETURN_ON_FALSE(dispatcher != NULL, "dispatcher pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(dispatcher->head, SUBSCRIBER_NONE, sizeof(dispatcher->head));
+    memset(dispatcher->subscribers, 0, sizeof(dispatcher->subscribers));
+    dispatcher->fallback = NULL;
+    dispatcher->fallback_ctx = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_subscribe(beam_dispatcher_t *dispatcher,
+                         beam_msg_category_t category,
+                         beam_frame_handler_t handler,
+                         void *ctx)
+{
+    DISPATCHER_RETURN_ON_FALSE(dispatcher != NULL, "dispatcher pointer is NULL", ESP_ERR_INVALID_ARG);
+    DISPATCHER_RETURN_ON_FALSE(handler != NULL, "handler pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t slot = 0;
+    while (slot < BEAM_DISPATCH_MAX_SUBSCRIBERS && dispatcher->subscribers[slot].handler != NULL) {
+        slot++;
+    }
+    DISPATCHER_RETURN_ON_FALSE(slot < BEAM_DISPATCH_MAX_SUBSCRIBERS, "no free subscriber slot", ESP_ERR_NO_MEM);
+
+    beam_subscriber_t *subscriber = &dispatcher->subscribers[slot];
+    subscriber->handler = handler;
+    subscriber->ctx = ctx;
+    subscriber->next = SUBSCRIBER_NONE;
+
+    // Append, so handlers run in subscription order
+    uint8_t *link = &dispatcher->head[category];
+    while (*link != SUBSCRIBER_NONE) {
+        link = &dispatcher->subscribers[*link].next;
+    }
+    *link = slot;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_unsubscribe(beam_dispatcher_t *dispatcher,
+                           beam_msg_category_t category,
+                           beam_frame_handler_t handler,
+                           void *ctx)
+{
+    DISPATCHER_RETURN_ON_FALSE(dispatcher != NULL, "dispatcher pointer is NULL", ESP_ERR_INVALID_ARG);
+    DISPATCHER_RETURN_ON_FALSE(handler != NULL, "handler pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t *link = &dispatcher->head[category];
+    while (*link != SUBSCRIBER_NONE) {
+        beam_subscriber_t *subscriber = &dispatcher->subscribers[*link];
+        if (subscriber->handler == handler && subscriber->ctx == ctx) {
+            *link = subscriber->next;
+            subscriber->handler = NULL;
+            subscriber->ctx = NULL;
+            return ESP_OK;
+        }
+        link = &subscriber->next;
+    }
+
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t beam_dispatcher_set_fallback(beam_dispatcher_t *dispatcher, beam_frame_handler_t handler, void *ctx)
+{
+    DISPATCHER_RETURN_ON_FALSE(dispatcher != NULL, "dispatcher pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    dispatcher->fallback = handler;
+    dispatcher->fallback_ctx = ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_dispatch(const beam_dispatcher_t *dispatcher, const beam_frame_view_t *view)
+{
+    DISPATCHER_RETURN_ON_FALSE(dispatcher != NULL, "dispatcher pointer is NULL", ESP_ERR_INVALID_ARG);
+    DISPATCHER_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t slot = dispatcher->head[beam_frame_view_category(view)];
+    if (slot == SUBSCRIBER_NONE) {
+        if (dispatcher->fallback == NULL) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        dispatcher->fallback(view, dispatcher->fallback_ctx);
+        return ESP_OK;
+    }
+
+    do {
+        const beam_subscriber_t *subscriber = &dispatcher->subscribers[slot];
+        subscriber->handler(view, subscriber->ctx);
+        slot = subscriber->next;
+    } while (slot != SUBSCRIBER_NONE);
+
+    return ESP_OK;
+}
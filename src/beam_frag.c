@@ -0,0 +1,281 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_frag.h"
+#include "beam_frame_builder.h"
+#include "beam_message_common.h"
+#include "beam_pool.h"
+#include "esp_check.h"
+#include <string.h>
+
+#define FRAG_OFFSET_CATEGORY 0u /**< Offset of the message category in the fragment header */
+#define FRAG_OFFSET_MSG_ID 1u   /**< Offset of msg_id */
+#define FRAG_OFFSET_INDEX 2u    /**< Offset of the fragment index */
+#define FRAG_OFFSET_COUNT 3u    /**< Offset of the fragment count */
+
+static const char *TAG = "[BEAM_frag]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define FRAG_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/**
+ * @brief Message bytes carried by a stored fragment frame.
+ */
+static const uint8_t *fragment_data(const beam_frame_buf_t *buf, size_t *out_len)
+{
+    beam_frame_view_t view = {buf->data, buf->len};
+    *out_len = (size_t)beam_frame_view_payload_len(&view) - BEAM_FRAG_HEADER_SIZE;
+
+    return beam_frame_view_payload(&view) + BEAM_FRAG_HEADER_SIZE;
+}
+
+/**
+ * @brief Return a slot's buffers to the pool and mark it free.
+ */
+static void free_slot(beam_frag_slot_t *slot)
+{
+    for (size_t i = 0; i < slot->count; i++) {
+        if (slot->fragments[i] != NULL) {
+            beam_pool_release(slot->fragments[i]);
+            slot->fragments[i] = NULL;
+        }
+    }
+    slot->count = 0;
+    slot->received = 0;
+}
+
+/**
+ * @brief Slot reassembling msg_id, or a free slot to start it in, or NULL if all are busy.
+ */
+static beam_frag_slot_t *find_slot(beam_frag_rx_t *rx, uint8_t msg_id)
+{
+    beam_frag_slot_t *unused = NULL;
+
+    for (size_t i = 0; i < BEAM_FRAG_MAX_REASSEMBLIES; i++) {
+        beam_frag_slot_t *slot = &rx->slots[i];
+        if (slot->count == 0) {
+            if (unused == NULL) {
+                unused = slot;
+            }
+        }
+        else if (slot->msg_id == msg_id) {
+            return slot;
+        }
+    }
+
+    return unused;
+}
+
+/**
+ * @brief Hand a complete message to the delivery callback and free its slot.
+ */
+static void deliver(beam_frag_rx_t *rx, beam_frag_slot_t *slot)
+{
+    beam_frag_message_t message = {
+        .category = slot->category,
+        .msg_id = slot->msg_id,
+        .count = slot->count,
+        .fragments = slot->fragments,
+    };
+    for (size_t i = 0; i < slot->count; i++) {
+        size_t len = 0;
+        fragment_data(slot->fragments[i], &len);
+        message.len += len;
+    }
+
+    rx->stats.completed++;
+    rx->deliver(&message, rx->ctx);
+    free_slot(slot);
+}
+
+esp_err_t beam_frag_tx_init(beam_frag_tx_t *tx)
+{
+    FRAG_RETURN_ON_FALSE(tx != NULL, "tx pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(tx, 0, sizeof(*tx));
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frag_tx_start(beam_frag_tx_t *tx, beam_msg_category_t category, const uint8_t *data, size_t len)
+{
+    FRAG_RETURN_ON_FALSE(tx != NULL, "tx pointer is NULL", ESP_ERR_INVALID_ARG);
+    FRAG_RETURN_ON_FALSE(data != NULL, "data pointer is NULL", ESP_ERR_INVALID_ARG);
+    FRAG_RETURN_ON_FALSE(len > 0 && len <= BEAM_FRAG_MAX_MESSAGE_SIZE,
+                         "len outside [1, BEAM_FRAG_MAX_MESSAGE_SIZE]",
+                         ESP_ERR_INVALID_SIZE);
+    FRAG_RETURN_ON_FALSE(tx->next_index >= tx->count, "previous message still pending", ESP_ERR_INVALID_STATE);
+
+    tx->data = data;
+    tx->len = len;
+    tx->category = category;
+    tx->msg_id++;
+    tx->next_index = 0;
+    tx->count = (uint8_t)((len + BEAM_FRAG_DATA_SIZE - 1) / BEAM_FRAG_DATA_SIZE);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frag_tx_pump(beam_frag_tx_t *tx, beam_arq_tx_t *arq, int64_t now_us)
+{
+    FRAG_RETURN_ON_FALSE(tx != NULL, "tx pointer is NULL", ESP_ERR_INVALID_ARG);
+    FRAG_RETURN_ON_FALSE(arq != NULL, "arq pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t frame[FRAME_MAX_SIZE];
+    while (tx->next_index < tx->count) {
+        size_t offset = (size_t)tx->next_index * BEAM_FRAG_DATA_SIZE;
+        size_t chunk = tx->len - offset < BEAM_FRAG_DATA_SIZE ? tx->len - offset : BEAM_FRAG_DATA_SIZE;
+        uint8_t header[BEAM_FRAG_HEADER_SIZE] = {tx->category, tx->msg_id, tx->next_index, tx->count};
+
+        // seq 0: beam_arq_send() stamps its own
+        beam_frame_builder_t builder;
+        size_t frame_len = 0;
+        beam_frame_begin_len(&builder,
+                             frame,
+                             sizeof(frame),
+                             MSG_CAT_FRAGMENT,
+                             MSG_FLAG_ACK_REQ,
+                             0,
+                             (uint8_t)(BEAM_FRAG_HEADER_SIZE + chunk));
+        beam_frame_put_bytes(&builder, header, sizeof(header));
+        beam_frame_put_bytes(&builder, tx->data + offset, chunk);
+        beam_frame_finish(&builder, &frame_len);
+
+        // NO_MEM: window full or pool empty, nothing sent. Other errors leave the frame retained.
+        if (beam_arq_send(arq, frame, frame_len, now_us) == ESP_ERR_NO_MEM) {
+            return ESP_ERR_NOT_FINISHED;
+        }
+        tx->next_index++;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frag_rx_init(beam_frag_rx_t *rx, beam_frag_deliver_cb_t deliver, void *ctx)
+{
+    FRAG_RETURN_ON_FALSE(rx != NULL, "rx pointer is NULL", ESP_ERR_INVALID_ARG);
+    FRAG_RETURN_ON_FALSE(deliver != NULL, "deliver pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(rx, 0, sizeof(*rx));
+    rx->deliver = deliver;
+    rx->ctx = ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frag_rx_handle(beam_frag_rx_t *rx, const beam_frame_view_t *view, int64_t now_us)
+{
+    FRAG_RETURN_ON_FALSE(rx != NULL, "rx pointer is NULL", ESP_ERR_INVALID_ARG);
+    FRAG_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+    FRAG_RETURN_ON_FALSE(beam_frame_view_category(view) == MSG_CAT_FRAGMENT,
+                         "frame is not MSG_CAT_FRAGMENT",
+                         ESP_ERR_INVALID_ARG);
+
+    if (beam_frame_view_payload_len(view) < BEAM_FRAG_HEADER_SIZE) {
+        rx->stats.malformed++;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const uint8_t *payload = beam_frame_view_payload(view);
+    uint8_t index = payload[FRAG_OFFSET_INDEX];
+    uint8_t count = payload[FRAG_OFFSET_COUNT];
+    if (count == 0 || count > BEAM_FRAG_MAX_FRAGMENTS || index >= count) {
+        rx->stats.malformed++;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    beam_frag_slot_t *slot = find_slot(rx, payload[FRAG_OFFSET_MSG_ID]);
+    if (slot == NULL) {
+        rx->stats.dropped++;
+        return ESP_ERR_NO_MEM;
+    }
+    if (slot->count == 0) {
+        slot->category = payload[FRAG_OFFSET_CATEGORY];
+        slot->msg_id = payload[FRAG_OFFSET_MSG_ID];
+        slot->count = count;
+    }
+    else if (slot->count != count || slot->category != payload[FRAG_OFFSET_CATEGORY]) {
+        rx->stats.malformed++;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (slot->fragments[index] != NULL) {
+        return ESP_OK;
+    }
+    if (beam_pool_acquire(&slot->fragments[index]) != ESP_OK) {
+        // The sender will not resend an acknowledged fragment, so the message is lost
+        slot->fragments[index] = NULL;
+        free_slot(slot);
+        rx->stats.dropped++;
+        return ESP_ERR_NO_MEM;
+    }
+
+    memcpy(slot->fragments[index]->data, view->data, view->size);
+    slot->fragments[index]->len = (uint16_t)view->size;
+    slot->received++;
+    slot->last_us = now_us;
+
+    if (slot->received == slot->count) {
+        deliver(rx, slot);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frag_rx_poll(beam_frag_rx_t *rx, int64_t now_us)
+{
+    FRAG_RETURN_ON_FALSE(rx != NULL, "rx pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    for (size_t i = 0; i < BEAM_FRAG_MAX_REASSEMBLIES; i++) {
+        beam_frag_slot_t *slot = &rx->slots[i];
+        if (slot->count != 0 && now_us - slot->last_us >= BEAM_FRAG_TIMEOUT_US) {
+            free_slot(slot);
+            rx->stats.timeouts++;
+        }
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frag_rx_reset(beam_frag_rx_t *rx)
+{
+    FRAG_RETURN_ON_FALSE(rx != NULL, "rx pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    for (size_t i = 0; i < BEAM_FRAG_MAX_REASSEMBLIES; i++) {
+        free_slot(&rx->slots[i]);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frag_message_copy(const beam_frag_message_t *message, uint8_t *dst, size_t dst_cap)
+{
+    FRAG_RETURN_ON_FALSE(message != NULL, "message pointer is NULL", ESP_ERR_INVALID_ARG);
+    FRAG_RETURN_ON_FALSE(dst != NULL, "dst pointer is NULL", ESP_ERR_INVALID_ARG);
+    FRAG_RETURN_ON_FALSE(dst_cap >= message->len, "dst_cap smaller than message", ESP_ERR_INVALID_SIZE);
+
+    for (size_t i = 0; i < message->count; i++) {
+        size_t len = 0;
+        const uint8_t *data = fragment_data(message->fragments[i], &len);
+        memcpy(dst, data, len);
+        dst += len;
+    }
+
+    return ESP_OK;
+}
@@ -0,0 +1,248 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_frame_builder.h"
+#include "beam_frame_internal.h"
+#include "beam_stats_internal.h"
+#include "esp_check.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define ENCODING_FLAGS (MSG_FLAG_COMPACT | MSG_FLAG_DELTA | MSG_FLAG_COMPRESSED) /**< Not producible by put_bytes() */
+
+static const char *TAG = "[BEAM_builder]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define BUILDER_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/**
+ * @brief Check room for len more payload bytes. Used by typed puts that write in several steps.
+ */
+static bool has_room(const beam_frame_builder_t *builder, size_t len)
+{
+    size_t new_len = (size_t)builder->len + len;
+    size_t limit = builder->streaming ? builder->declared_len : MAX_PAYLOAD_SIZE;
+
+    return new_len <= limit && FRAME_SIZE(new_len) <= builder->cap;
+}
+
+/**
+ * @brief Copy len payload bytes to the write position and advance it.
+ *
+ * Caller must ensure non-NULL arguments.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_SIZE if the payload would exceed MAX_PAYLOAD_SIZE, the buffer capacity
+ *         or the declared length.
+ */
+static esp_err_t put_bytes(beam_frame_builder_t *builder, const void *data, size_t len)
+{
+    size_t new_len = (size_t)builder->len + len;
+    BUILDER_RETURN_ON_FALSE(new_len <= MAX_PAYLOAD_SIZE, "payload exceeds MAX_PAYLOAD_SIZE", ESP_ERR_INVALID_SIZE);
+    BUILDER_RETURN_ON_FALSE(FRAME_SIZE(new_len) <= builder->cap, "buffer too small for payload", ESP_ERR_INVALID_SIZE);
+    BUILDER_RETURN_ON_FALSE(!builder->streaming || new_len <= builder->declared_len,
+                            "payload exceeds declared length",
+                            ESP_ERR_INVALID_SIZE);
+
+    uint8_t *dst = builder->buf + FRAME_HEADER_SIZE + builder->len;
+    memcpy(dst, data, len);
+    builder->len = (uint8_t)new_len;
+
+    if (builder->streaming) {
+        beam_crc_update(&builder->crc, dst, len);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frame_begin(beam_frame_builder_t *builder,
+                           uint8_t *buf,
+                           size_t cap,
+                           beam_msg_category_t category,
+                           beam_flags_t flags,
+                           uint8_t seq)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(buf != NULL, "buf pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE((flags & ENCODING_FLAGS) == 0,
+                            "payload encoding flags need beam_serialize_frame()",
+                            ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(cap >= FRAME_MIN_SIZE, "cap less than FRAME_MIN_SIZE", ESP_ERR_INVALID_SIZE);
+
+    buf[FRAME_OFFSET_CATEGORY] = category;
+    buf[FRAME_OFFSET_FLAGS] = flags;
+    buf[FRAME_OFFSET_SEQ] = seq;
+    buf[FRAME_OFFSET_LEN] = 0;
+
+    builder->buf = buf;
+    builder->cap = cap;
+    builder->len = 0;
+    builder->declared_len = 0;
+    builder->streaming = false;
+    builder->has_timestamp = false;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frame_begin_len(beam_frame_builder_t *builder,
+                               uint8_t *buf,
+                               size_t cap,
+                               beam_msg_category_t category,
+                               beam_flags_t flags,
+                               uint8_t seq,
+                               uint8_t payload_len)
+{
+    BUILDER_RETURN_ON_FALSE(payload_len <= MAX_PAYLOAD_SIZE,
+                            "payload_len exceeds MAX_PAYLOAD_SIZE",
+                            ESP_ERR_INVALID_SIZE);
+    BUILDER_RETURN_ON_FALSE(cap >= FRAME_SIZE(payload_len), "cap too small for payload_len", ESP_ERR_INVALID_SIZE);
+
+    esp_err_t err = beam_frame_begin(builder, buf, cap, category, flags, seq);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    buf[FRAME_OFFSET_LEN] = payload_len;
+    builder->declared_len = payload_len;
+    builder->streaming = true;
+    beam_crc_init(&builder->crc);
+    beam_crc_update(&builder->crc, buf, FRAME_HEADER_SIZE);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frame_put_bytes(beam_frame_builder_t *builder, const void *data, size_t len)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(data != NULL || len == 0, "data pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    return put_bytes(builder, data, len);
+}
+
+esp_err_t beam_frame_put_u8(beam_frame_builder_t *builder, uint8_t value)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    return put_bytes(builder, &value, sizeof(value));
+}
+
+esp_err_t beam_frame_put_u16(beam_frame_builder_t *builder, uint16_t value)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t le[2] = {(uint8_t)(value & 0xFF), (uint8_t)(value >> 8)};
+    return put_bytes(builder, le, sizeof(le));
+}
+
+esp_err_t beam_frame_put_u32(beam_frame_builder_t *builder, uint32_t value)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t le[4] = {
+        (uint8_t)(value & 0xFF),
+        (uint8_t)((value >> 8) & 0xFF),
+        (uint8_t)((value >> 16) & 0xFF),
+        (uint8_t)(value >> 24),
+    };
+    return put_bytes(builder, le, sizeof(le));
+}
+
+esp_err_t beam_frame_put_timestamp(beam_frame_builder_t *builder, uint32_t timestamp_us)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(builder->buf[FRAME_OFFSET_FLAGS] & MSG_FLAG_EXT_TS,
+                            "frame started without MSG_FLAG_EXT_TS",
+                            ESP_ERR_INVALID_STATE);
+    BUILDER_RETURN_ON_FALSE(builder->len == 0, "timestamp must precede the payload", ESP_ERR_INVALID_STATE);
+
+    uint8_t le[FRAME_EXT_TS_SIZE];
+    frame_write_timestamp(le, timestamp_us);
+    esp_err_t err = put_bytes(builder, le, sizeof(le));
+    if (err == ESP_OK) {
+        builder->has_timestamp = true;
+    }
+
+    return err;
+}
+
+esp_err_t beam_frame_put_float(beam_frame_builder_t *builder, float value)
+{
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return beam_frame_put_u32(builder, bits);
+}
+
+esp_err_t beam_frame_put_telemetry(beam_frame_builder_t *builder, const beam_payload_telemetry_t *telemetry)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(telemetry != NULL, "telemetry pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(has_room(builder, sizeof(*telemetry)),
+                            "no room for telemetry payload",
+                            ESP_ERR_INVALID_SIZE);
+
+    beam_frame_put_float(builder, telemetry->roll);
+    beam_frame_put_float(builder, telemetry->pitch);
+    beam_frame_put_float(builder, telemetry->yaw);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frame_put_battery(beam_frame_builder_t *builder, const beam_payload_battery_t *battery)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(battery != NULL, "battery pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(has_room(builder, sizeof(*battery)),
+                            "no room for battery payload",
+                            ESP_ERR_INVALID_SIZE);
+
+    beam_frame_put_u16(builder, battery->voltage);
+    beam_frame_put_u16(builder, battery->current);
+    beam_frame_put_u8(builder, battery->percent);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_frame_finish(beam_frame_builder_t *builder, size_t *out_size)
+{
+    BUILDER_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+    BUILDER_RETURN_ON_FALSE(!builder->streaming || builder->len == builder->declared_len,
+                            "payload shorter than declared length",
+                            ESP_ERR_INVALID_STATE);
+    BUILDER_RETURN_ON_FALSE(!(builder->buf[FRAME_OFFSET_FLAGS] & MSG_FLAG_EXT_TS) || builder->has_timestamp,
+                            "MSG_FLAG_EXT_TS frame without timestamp",
+                            ESP_ERR_INVALID_STATE);
+
+    uint16_t crc = 0;
+    if (builder->streaming) {
+        crc = beam_crc_final(&builder->crc);
+    }
+    else {
+        builder->buf[FRAME_OFFSET_LEN] = builder->len;
+        crc = frame_crc(builder->buf, FRAME_HEADER_SIZE + builder->len);
+    }
+    frame_write_crc(builder->buf + FRAME_HEADER_SIZE + builder->len, crc);
+
+    if (out_size != NULL) {
+        *out_size = FRAME_SIZE(builder->len);
+    }
+    stats_record_serialize(FRAME_SIZE(builder->len));
+
+    return ESP_OK;
+}
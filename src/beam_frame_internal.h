@@ -0,0 +1,77 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_FRAME_INTERNAL_H
+#define BEAM_FRAME_INTERNAL_H
+
+#include "beam_crc.h"
+#include "beam_frame.h"
+#include "esp_attr.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRC_INIT BEAM_CRC_INIT /**< Initial CRC-16-CCITT value (0xFFFF) */
+
+/**
+ * @brief CRC-16-CCITT over header + payload bytes, as carried on the wire.
+ *
+ * Uses the Kconfig-selected backend (see beam_crc.h). Forced inline, like frame_read_crc(),
+ * because the IRAM validation path calls it: an out-of-line copy would land in flash.
+ */
+FORCE_INLINE_ATTR uint16_t frame_crc(const uint8_t *data, size_t len)
+{
+    return beam_crc16(CRC_INIT, data, len);
+}
+
+/**
+ * @brief True if len is a valid wire header.len for a frame with flags: at most
+ *        MAX_PAYLOAD_SIZE and, with MSG_FLAG_EXT_TS, room for the timestamp.
+ */
+static inline bool frame_len_valid(beam_flags_t flags, uint8_t len)
+{
+    return len <= MAX_PAYLOAD_SIZE && len >= FRAME_EXT_SIZE(flags);
+}
+
+/**
+ * @brief Write a MSG_FLAG_EXT_TS timestamp little-endian at dst (FRAME_EXT_TS_SIZE bytes).
+ */
+static inline void frame_write_timestamp(uint8_t *dst, uint32_t timestamp_us)
+{
+    dst[0] = (uint8_t)timestamp_us;
+    dst[1] = (uint8_t)(timestamp_us >> 8);
+    dst[2] = (uint8_t)(timestamp_us >> 16);
+    dst[3] = (uint8_t)(timestamp_us >> 24);
+}
+
+/**
+ * @brief Read the CRC stored LSB first (little-endian) at src.
+ */
+FORCE_INLINE_ATTR uint16_t frame_read_crc(const uint8_t *src)
+{
+    return (uint16_t)src[0] | ((uint16_t)src[1] << 8);
+}
+
+/**
+ * @brief Write crc LSB first (little-endian) at dst.
+ */
+static inline void frame_write_crc(uint8_t *dst, uint16_t crc)
+{
+    dst[0] = (uint8_t)(crc & 0xFF);        // LSB
+    dst[1] = (uint8_t)((crc >> 8) & 0xFF); // MSB
+}
+
+#endif /* BEAM_FRAME_INTERNAL_H */
@@ -0,0 +1,275 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_copy_internal.h"
+#include "beam_gateway.h"
+#include "beam_message_common.h"
+#include "beam_parser.h"
+#include "esp_check.h"
+#include <assert.h>
+#include <string.h>
+
+#define SLOT_EMPTY 0u /**< Free; ends a probe sequence */
+#define SLOT_USED 1u  /**< Maps a MAC to a peer */
+
+#define TABLE_MASK (BEAM_GATEWAY_TABLE_SIZE - 1u) /**< Probe index wrap-around */
+
+static_assert(BEAM_GATEWAY_QUEUE_DEPTH >= 2 && (BEAM_GATEWAY_QUEUE_DEPTH & (BEAM_GATEWAY_QUEUE_DEPTH - 1)) == 0,
+              "CONFIG_BEAM_GATEWAY_QUEUE_DEPTH must be a power of two >= 2");
+static_assert(BEAM_GATEWAY_MAX_PEERS <= UINT8_MAX, "peer index must fit beam_gateway_slot_t.peer");
+static_assert(sizeof(beam_gateway_slot_t) == 8, "hash table entries should stay 8 bytes");
+
+static const char *TAG = "[BEAM_gateway]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define GATEWAY_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/**
+ * @brief Home slot of a MAC (FNV-1a over the six bytes).
+ */
+static uint32_t hash_mac(const uint8_t *mac)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < BEAM_MAC_LEN; i++) {
+        h = (h ^ mac[i]) * 16777619u;
+    }
+
+    return h & TABLE_MASK;
+}
+
+/**
+ * @brief Table slot holding mac, or NULL if the peer is unknown.
+ *
+ * The state is loaded with acquire semantics, pairing with the release store in add_peer(),
+ * so a reader on another task never sees a half-written entry.
+ */
+static const beam_gateway_slot_t *find_slot(const beam_gateway_t *gw, const uint8_t *mac)
+{
+    uint32_t index = hash_mac(mac);
+
+    for (size_t probe = 0; probe < BEAM_GATEWAY_TABLE_SIZE; probe++) {
+        const beam_gateway_slot_t *slot = &gw->table[index];
+        uint8_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+        if (state == SLOT_EMPTY) {
+            return NULL;
+        }
+        if (state == SLOT_USED && memcmp(slot->mac, mac, BEAM_MAC_LEN) == 0) {
+            return slot;
+        }
+        index = (index + 1) & TABLE_MASK;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a peer for mac and publish it to the consumer. Caller has checked that mac is unknown.
+ *
+ * @return The new peer, or NULL if all BEAM_GATEWAY_MAX_PEERS entries are in use.
+ */
+static beam_gateway_peer_t *add_peer(beam_gateway_t *gw, const uint8_t *mac)
+{
+    size_t peer_index = 0;
+    while (peer_index < BEAM_GATEWAY_MAX_PEERS && gw->peers[peer_index].active) {
+        peer_index++;
+    }
+    if (peer_index == BEAM_GATEWAY_MAX_PEERS) {
+        return NULL;
+    }
+
+    // The table has at least twice as many slots as peers, so a free one exists
+    uint32_t index = hash_mac(mac);
+    while (gw->table[index].state == SLOT_USED) {
+        index = (index + 1) & TABLE_MASK;
+    }
+
+    beam_gateway_peer_t *peer = &gw->peers[peer_index];
+    beam_ring_init(&peer->queue, gw->queue_slots[peer_index], BEAM_GATEWAY_QUEUE_DEPTH);
+    beam_seq_init(&peer->seq);
+    peer->queued = 0;
+    peer->queue_full = 0;
+    peer->last_seen_us = 0;
+    memcpy(peer->mac, mac, BEAM_MAC_LEN);
+    __atomic_store_n(&peer->active, true, __ATOMIC_RELEASE);
+
+    beam_gateway_slot_t *slot = &gw->table[index];
+    memcpy(slot->mac, mac, BEAM_MAC_LEN);
+    slot->peer = (uint8_t)peer_index;
+    __atomic_store_n(&slot->state, SLOT_USED, __ATOMIC_RELEASE);
+
+    return peer;
+}
+
+/**
+ * @brief Free table slot index without tombstones (backward-shift deletion).
+ *
+ * Entries after the hole whose probe sequence passes through it move back into it, so
+ * every entry stays reachable from its home slot and churn never fills the table with
+ * dead slots. Only safe while no other task probes the table.
+ */
+static void delete_slot(beam_gateway_t *gw, uint32_t index)
+{
+    uint32_t hole = index;
+
+    for (uint32_t next = (hole + 1) & TABLE_MASK; gw->table[next].state == SLOT_USED;
+         next = (next + 1) & TABLE_MASK) {
+        // The entry at next may fill the hole if the hole lies between its home slot and next
+        uint32_t home = hash_mac(gw->table[next].mac);
+        if (((next - home) & TABLE_MASK) >= ((next - hole) & TABLE_MASK)) {
+            gw->table[hole] = gw->table[next];
+            hole = next;
+        }
+    }
+    gw->table[hole].state = SLOT_EMPTY;
+}
+
+esp_err_t beam_gateway_init(beam_gateway_t *gw)
+{
+    GATEWAY_RETURN_ON_FALSE(gw != NULL, "gw pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(gw->table, 0, sizeof(gw->table));
+    memset(gw->peers, 0, sizeof(gw->peers));
+    gw->next_peer = 0;
+    gw->table_full = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_gateway_receive(beam_gateway_t *gw,
+                               const uint8_t *mac,
+                               const uint8_t *data,
+                               size_t data_len,
+                               int64_t now_us)
+{
+    GATEWAY_RETURN_ON_FALSE(gw != NULL, "gw pointer is NULL", ESP_ERR_INVALID_ARG);
+    GATEWAY_RETURN_ON_FALSE(mac != NULL, "mac pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    beam_frame_view_t view;
+    esp_err_t err = beam_parse_view(data, data_len, &view);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    const beam_gateway_slot_t *slot = find_slot(gw, mac);
+    beam_gateway_peer_t *peer = slot != NULL ? &gw->peers[slot->peer] : add_peer(gw, mac);
+    if (peer == NULL) {
+        gw->table_full++;
+        return ESP_ERR_NO_MEM;
+    }
+    peer->last_seen_us = now_us;
+
+    beam_frame_buf_t *queue_slot = NULL;
+    if (beam_ring_reserve(&peer->queue, &queue_slot) != ESP_OK) {
+        // Not passed to the sequence tracker: the frame is lost, and counted so once later ones arrive
+        peer->queue_full++;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Reliable frames and ACKs are numbered apart from best-effort ones; beam_arq_receive() tracks them
+    bool tracked = !(beam_frame_view_flags(&view) & MSG_FLAG_ACK_REQ) && beam_frame_view_category(&view) != MSG_CAT_ACK;
+    if (tracked) {
+        beam_seq_result_t result;
+        beam_seq_update(&peer->seq, beam_frame_view_seq(&view), &result, NULL);
+        if (result == BEAM_SEQ_DUPLICATE) {
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+
+    beam_copy(queue_slot->data, view.data, view.size);
+    queue_slot->len = (uint16_t)view.size;
+    beam_ring_commit(&peer->queue);
+    peer->queued++;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_gateway_process(beam_gateway_t *gw,
+                               beam_gateway_handler_t handler,
+                               void *ctx,
+                               size_t max_frames,
+                               size_t *out_handled)
+{
+    GATEWAY_RETURN_ON_FALSE(gw != NULL, "gw pointer is NULL", ESP_ERR_INVALID_ARG);
+    GATEWAY_RETURN_ON_FALSE(handler != NULL, "handler pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    size_t handled = 0;
+    size_t idle = 0; // Consecutive peers with nothing queued; a full idle lap ends the call
+    size_t index = gw->next_peer;
+
+    while (handled < max_frames && idle < BEAM_GATEWAY_MAX_PEERS) {
+        beam_gateway_peer_t *peer = &gw->peers[index];
+        index = (index + 1) % BEAM_GATEWAY_MAX_PEERS;
+
+        beam_frame_view_t view;
+        if (!__atomic_load_n(&peer->active, __ATOMIC_ACQUIRE) || beam_ring_peek(&peer->queue, &view) != ESP_OK) {
+            idle++;
+            continue;
+        }
+
+        handler(peer->mac, &view, ctx);
+        beam_ring_release(&peer->queue);
+        handled++;
+        idle = 0;
+    }
+    gw->next_peer = (uint8_t)index;
+
+    if (out_handled != NULL) {
+        *out_handled = handled;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_gateway_get_peer_stats(const beam_gateway_t *gw,
+                                      const uint8_t *mac,
+                                      beam_gateway_peer_stats_t *out_stats)
+{
+    GATEWAY_RETURN_ON_FALSE(gw != NULL, "gw pointer is NULL", ESP_ERR_INVALID_ARG);
+    GATEWAY_RETURN_ON_FALSE(mac != NULL, "mac pointer is NULL", ESP_ERR_INVALID_ARG);
+    GATEWAY_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    const beam_gateway_slot_t *slot = find_slot(gw, mac);
+    if (slot == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const beam_gateway_peer_t *peer = &gw->peers[slot->peer];
+    out_stats->seq = peer->seq.stats;
+    out_stats->queued = peer->queued;
+    out_stats->queue_full = peer->queue_full;
+    out_stats->last_seen_us = peer->last_seen_us;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_gateway_remove_peer(beam_gateway_t *gw, const uint8_t *mac)
+{
+    GATEWAY_RETURN_ON_FALSE(gw != NULL, "gw pointer is NULL", ESP_ERR_INVALID_ARG);
+    GATEWAY_RETURN_ON_FALSE(mac != NULL, "mac pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    beam_gateway_slot_t *slot = (beam_gateway_slot_t *)find_slot(gw, mac);
+    if (slot == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    gw->peers[slot->peer].active = false;
+    delete_slot(gw, (uint32_t)(slot - gw->table));
+
+    return ESP_OK;
+}
@@ -0,0 +1,254 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_latency.h"
+#include "esp_check.h"
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "[BEAM_latency]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define LATENCY_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+#if CONFIG_BEAM_LATENCY_TRACE
+
+#define EXACT_BUCKETS 8u                                                   /**< One bucket per value below 8 us */
+#define SUB_BUCKETS 4u                                                     /**< Buckets per power of two above */
+#define MAX_OCTAVE 19u                                                     /**< Last octave: 2^19 to 2^20 - 1 us */
+#define OVERFLOW_BUCKET (EXACT_BUCKETS + (MAX_OCTAVE - 2u) * SUB_BUCKETS) /**< 2^20 us and more */
+#define BUCKET_COUNT (OVERFLOW_BUCKET + 1u)                               /**< Buckets per histogram */
+
+/**
+ * @brief Samples of one category at one stage.
+ */
+typedef struct latency_hist {
+    uint32_t max_us;
+    uint32_t buckets[BUCKET_COUNT];
+} latency_hist_t;
+
+/**
+ * @brief Histogram slots. category holds msg_category + 1 once claimed, 0 while free.
+ */
+static struct {
+    uint16_t category[BEAM_LATENCY_MAX_CATEGORIES];
+    latency_hist_t hist[BEAM_LATENCY_MAX_CATEGORIES][BEAM_LATENCY_STAGE_COUNT];
+} s_latency;
+
+/**
+ * @brief Bucket of a sample: the value below 8 us, otherwise octave and top two bits after the leading one.
+ */
+static uint32_t bucket_of(uint32_t us)
+{
+    if (us < EXACT_BUCKETS) {
+        return us;
+    }
+
+    uint32_t octave = 31u - (uint32_t)__builtin_clz(us);
+    if (octave > MAX_OCTAVE) {
+        return OVERFLOW_BUCKET;
+    }
+    uint32_t sub = (us >> (octave - 2u)) & (SUB_BUCKETS - 1u);
+
+    return EXACT_BUCKETS + (octave - 3u) * SUB_BUCKETS + sub;
+}
+
+/**
+ * @brief Largest sample a bucket holds; UINT32_MAX for the overflow bucket.
+ */
+static uint32_t bucket_upper(uint32_t bucket)
+{
+    if (bucket < EXACT_BUCKETS) {
+        return bucket;
+    }
+    if (bucket == OVERFLOW_BUCKET) {
+        return UINT32_MAX;
+    }
+
+    uint32_t octave = 3u + (bucket - EXACT_BUCKETS) / SUB_BUCKETS;
+    uint32_t sub = (bucket - EXACT_BUCKETS) % SUB_BUCKETS;
+    uint32_t width = 1u << (octave - 2u);
+
+    return (SUB_BUCKETS + sub + 1u) * width - 1u;
+}
+
+/**
+ * @brief Slot of category, claiming a free one if claim is set.
+ *
+ * @return Slot index, or -1 if category has none (and none could be claimed).
+ */
+static int find_slot(beam_msg_category_t category, bool claim)
+{
+    uint16_t tag = (uint16_t)(category + 1u);
+
+    for (int i = 0; i < (int)BEAM_LATENCY_MAX_CATEGORIES; i++) {
+        uint16_t seen = __atomic_load_n(&s_latency.category[i], __ATOMIC_ACQUIRE);
+        if (seen == 0 && claim) {
+            // Another recorder may claim the slot first, possibly for the same category
+            __atomic_compare_exchange_n(&s_latency.category[i], &seen, tag, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+            seen = __atomic_load_n(&s_latency.category[i], __ATOMIC_ACQUIRE);
+        }
+        if (seen == tag) {
+            return i;
+        }
+        if (seen == 0) {
+            return -1;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Sample at the given percentile: upper edge of the bucket holding it, clamped to max_us.
+ */
+static uint32_t percentile(const uint32_t *buckets, uint32_t count, uint32_t max_us, uint32_t percent)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)count * percent + 99u) / 100u);
+    uint32_t seen = 0;
+
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            uint32_t upper = bucket_upper(i);
+            return upper < max_us ? upper : max_us;
+        }
+    }
+
+    return max_us;
+}
+
+esp_err_t beam_latency_record(beam_msg_category_t category, beam_latency_stage_t stage, uint32_t latency_us)
+{
+    LATENCY_RETURN_ON_FALSE(stage < BEAM_LATENCY_STAGE_COUNT, "stage out of range", ESP_ERR_INVALID_ARG);
+
+    int slot = find_slot(category, true);
+    if (slot < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    latency_hist_t *hist = &s_latency.hist[slot][stage];
+    __atomic_fetch_add(&hist->buckets[bucket_of(latency_us)], 1, __ATOMIC_RELAXED);
+
+    uint32_t seen = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED);
+    while (latency_us > seen &&
+           !__atomic_compare_exchange_n(&hist->max_us, &seen, latency_us, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_latency_mark(const beam_frame_view_t *view, beam_latency_stage_t stage, int64_t now_us)
+{
+    LATENCY_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    if (!beam_frame_view_has_timestamp(view)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Modular difference, so the 32-bit clocks may wrap; negative means the receiver clock is behind
+    int32_t elapsed = (int32_t)((uint32_t)now_us - beam_frame_view_timestamp(view));
+
+    return beam_latency_record(beam_frame_view_category(view), stage, elapsed > 0 ? (uint32_t)elapsed : 0u);
+}
+
+esp_err_t beam_latency_get(beam_msg_category_t category,
+                           beam_latency_stage_t stage,
+                           beam_latency_summary_t *out_summary)
+{
+    LATENCY_RETURN_ON_FALSE(out_summary != NULL, "out_summary pointer is NULL", ESP_ERR_INVALID_ARG);
+    LATENCY_RETURN_ON_FALSE(stage < BEAM_LATENCY_STAGE_COUNT, "stage out of range", ESP_ERR_INVALID_ARG);
+
+    memset(out_summary, 0, sizeof(*out_summary));
+
+    int slot = find_slot(category, false);
+    if (slot < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const latency_hist_t *hist = &s_latency.hist[slot][stage];
+    uint32_t buckets[BUCKET_COUNT];
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] = __atomic_load_n(&hist->buckets[i], __ATOMIC_RELAXED);
+        count += buckets[i];
+    }
+
+    out_summary->count = count;
+    out_summary->max_us = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED);
+    if (count != 0) {
+        out_summary->p50_us = percentile(buckets, count, out_summary->max_us, 50);
+        out_summary->p99_us = percentile(buckets, count, out_summary->max_us, 99);
+    }
+
+    return ESP_OK;
+}
+
+void beam_latency_reset(void)
+{
+    for (size_t i = 0; i < BEAM_LATENCY_MAX_CATEGORIES; i++) {
+        for (size_t stage = 0; stage < BEAM_LATENCY_STAGE_COUNT; stage++) {
+            latency_hist_t *hist = &s_latency.hist[i][stage];
+            __atomic_store_n(&hist->max_us, 0, __ATOMIC_RELAXED);
+            for (size_t b = 0; b < BUCKET_COUNT; b++) {
+                __atomic_store_n(&hist->buckets[b], 0, __ATOMIC_RELAXED);
+            }
+        }
+        __atomic_store_n(&s_latency.category[i], 0, __ATOMIC_RELEASE);
+    }
+}
+
+#else
+
+esp_err_t beam_latency_record(beam_msg_category_t category, beam_latency_stage_t stage, uint32_t latency_us)
+{
+    (void)category;
+    (void)stage;
+    (void)latency_us;
+
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t beam_latency_mark(const beam_frame_view_t *view, beam_latency_stage_t stage, int64_t now_us)
+{
+    (void)stage;
+    (void)now_us;
+    LATENCY_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t beam_latency_get(beam_msg_category_t category,
+                           beam_latency_stage_t stage,
+                           beam_latency_summary_t *out_summary)
+{
+    (void)category;
+    (void)stage;
+    LATENCY_RETURN_ON_FALSE(out_summary != NULL, "out_summary pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(out_summary, 0, sizeof(*out_summary));
+
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void beam_latency_reset(void)
+{
+}
+
+#endif /* CONFIG_BEAM_LATENCY_TRACE */
@@ -0,0 +1,66 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_LATENCY_INTERNAL_H
+#define BEAM_LATENCY_INTERNAL_H
+
+#include "beam_latency.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#if CONFIG_BEAM_LATENCY_TRACE
+#include "esp_timer.h"
+#endif
+
+/*
+ * Tracing hooks for the receive path. They compile to nothing without
+ * CONFIG_BEAM_LATENCY_TRACE, so call sites need no #if.
+ */
+
+#if CONFIG_BEAM_LATENCY_TRACE
+
+/**
+ * @brief Receiver clock for latency_mark(), low 32 bits of esp_timer_get_time().
+ */
+static inline uint32_t latency_now(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+/**
+ * @brief Record stage for a validated frame at now_us. Frames without MSG_FLAG_EXT_TS are skipped.
+ */
+static inline void latency_mark(const beam_frame_view_t *view, beam_latency_stage_t stage, uint32_t now_us)
+{
+    beam_latency_mark(view, stage, now_us);
+}
+
+#else
+
+static inline uint32_t latency_now(void)
+{
+    return 0;
+}
+
+static inline void latency_mark(const beam_frame_view_t *view, beam_latency_stage_t stage, uint32_t now_us)
+{
+    (void)view;
+    (void)stage;
+    (void)now_us;
+}
+
+#endif /* CONFIG_BEAM_LATENCY_TRACE */
+
+#endif /* BEAM_LATENCY_INTERNAL_H */
@@ -14,14 +14,24 @@
  limitations under the License.
  */
 
+#include "beam_compress.h"
+#include "beam_copy_internal.h"
+#include "beam_frame_internal.h"
 #include "beam_message_common.h"
 #include "beam_parser.h"
 #include "beam_payload_type.h"
+#include "beam_stats_internal.h"
+#include "beam_telemetry.h"
+#include "esp_attr.h"
 #include "esp_check.h"
-#include "esp_crc.h"
 #include <limits.h>
+#include <string.h>
 
-#define CRC_INIT UINT16_MAX /**< Initial CRC-16-CCITT value (0xFFFF) */
+#if CONFIG_BEAM_PARSER_IN_IRAM
+#define PARSER_IRAM_ATTR IRAM_ATTR /**< Validation path safe while the flash cache is disabled */
+#else
+#define PARSER_IRAM_ATTR
+#endif
 
 static const char *TAG = "[BEAM_parser]";
 
@@ -31,12 +41,82 @@ static const char *TAG = "[BEAM_parser]";
  */
 #define PARSER_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
 
+#if CONFIG_BEAM_PARSER_SILENT
+/**
+ * Checks on received bytes: return ret_val without logging. Rejections are still counted
+ * in beam_stats and summarized by report_errors().
+ */
+#define VALIDATE_RETURN_ON_FALSE(condition, msg, ret_val)                                                              \
+    do {                                                                                                               \
+        if (!(condition)) {                                                                                            \
+            return ret_val;                                                                                            \
+        }                                                                                                              \
+    } while (0)
+#else
+/**
+ * Checks on received bytes: log msg and return ret_val.
+ */
+#define VALIDATE_RETURN_ON_FALSE(condition, msg, ret_val) PARSER_RETURN_ON_FALSE(condition, msg, ret_val)
+#endif
+
+#if CONFIG_BEAM_STATS && CONFIG_BEAM_PARSER_ERROR_LOG_INTERVAL_MS > 0
+static uint32_t s_report_ms;     ///< esp_log_timestamp() of the last summary line
+static uint32_t s_reported_size; ///< invalid_size total at the last summary line
+static uint32_t s_reported_crc;  ///< invalid_crc total at the last summary line
+
+/**
+ * @brief Log how many frames were rejected since the last summary, at most once per
+ *        CONFIG_BEAM_PARSER_ERROR_LOG_INTERVAL_MS.
+ *
+ * Called after a rejection, so a quiet channel logs nothing. When several tasks race,
+ * the one that advances s_report_ms logs.
+ */
+static void report_errors(void)
+{
+    uint32_t now = esp_log_timestamp();
+    uint32_t last = __atomic_load_n(&s_report_ms, __ATOMIC_RELAXED);
+    if (now - last < CONFIG_BEAM_PARSER_ERROR_LOG_INTERVAL_MS ||
+        !__atomic_compare_exchange_n(&s_report_ms, &last, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    uint32_t size_total = __atomic_load_n(&beam_stats_counters.invalid_size, __ATOMIC_RELAXED);
+    uint32_t crc_total = __atomic_load_n(&beam_stats_counters.invalid_crc, __ATOMIC_RELAXED);
+    uint32_t size_errors = __atomic_exchange_n(&s_reported_size, size_total, __ATOMIC_RELAXED);
+    uint32_t crc_errors = __atomic_exchange_n(&s_reported_crc, crc_total, __ATOMIC_RELAXED);
+
+    // A total below the reported one means beam_stats_reset() ran in between
+    size_errors = size_total >= size_errors ? size_total - size_errors : size_total;
+    crc_errors = crc_total >= crc_errors ? crc_total - crc_errors : crc_total;
+
+    ESP_LOGW(TAG,
+             "%lu CRC errors, %lu size errors in last %lu ms",
+             (unsigned long)crc_errors,
+             (unsigned long)size_errors,
+             (unsigned long)(now - last));
+}
+#else
+static void report_errors(void)
+{
+}
+#endif
+
+/**
+ * @brief Count a rejected frame and, in silent mode, report the error rate.
+ */
+static void reject(esp_err_t err)
+{
+    stats_record_error(err);
+    report_errors();
+}
+
 /**
  * @brief Fill payload union from raw bytes according to msg_category.
  *
- * For known message types (MSG_CAT_TELEMETRY, MSG_CAT_BATTERY), copies data into
- * the typed union member if payload length is sufficient. Otherwise, or for unknown
- * types, copies into .raw array.
+ * For categories with a registered payload type (see BEAM_PAYLOAD_REGISTRY), copies
+ * exactly the typed size if payload length is sufficient. Otherwise, or for unknown
+ * types, copies len bytes into .raw array. All members start at the union's first byte,
+ * so a size table lookup replaces a per-category switch.
  *
  * @param msg_category Message type identifier.
  * @param payload_src Source buffer with payload bytes.
@@ -45,68 +125,214 @@ static const char *TAG = "[BEAM_parser]";
  */
 static void fill_payload(uint8_t msg_category, const uint8_t *payload_src, uint8_t len, beam_payload_t *payload)
 {
-    switch (msg_category) {
-    case MSG_CAT_TELEMETRY:
-        if (len >= sizeof(beam_payload_telemetry_t)) {
-            memcpy(&payload->telemetry, payload_src, sizeof(beam_payload_telemetry_t));
-        }
-        else {
-            memcpy(payload->raw, payload_src, len);
+    uint8_t typed_size = beam_payload_size(msg_category);
+    uint8_t copy_len = (typed_size != 0 && len >= typed_size) ? typed_size : len;
+
+    beam_copy(payload->raw, payload_src, copy_len);
+}
+
+/**
+ * @brief Expand a compact telemetry payload in place so callers see the float payload.
+ *
+ * Rewrites header.len and clears MSG_FLAG_COMPACT and MSG_FLAG_DELTA, so out describes
+ * the decoded payload. Without a decoder only keyframes are expanded: deltas need the
+ * sender's keyframe and are left as received.
+ *
+ * @param out Frame already filled by parse_into_frame().
+ * @param decoder Keyframe state of the sender, or NULL.
+ *
+ * @return ESP_OK on success or if nothing needs expanding, otherwise the error from
+ *         beam_telemetry_decode_payload() (not logged).
+ */
+static esp_err_t expand_compact(beam_frame_t *out, beam_telemetry_decoder_t *decoder)
+{
+    if (out->header.msg_category != MSG_CAT_TELEMETRY || !(out->header.flags & MSG_FLAG_COMPACT)) {
+        return ESP_OK;
+    }
+
+    // The float payload overlays the compact bytes it is decoded from
+    uint8_t compact[BEAM_TELEMETRY_COMPACT_MAX_SIZE];
+    if (decoder == NULL) {
+        if ((out->header.flags & MSG_FLAG_DELTA) || out->header.len != BEAM_TELEMETRY_KEYFRAME_SIZE) {
+            return ESP_OK;
         }
-        break;
-    case MSG_CAT_BATTERY:
-        if (len >= sizeof(beam_payload_battery_t)) {
-            memcpy(&payload->battery, payload_src, sizeof(beam_payload_battery_t));
+        memcpy(compact, out->payload.raw, BEAM_TELEMETRY_KEYFRAME_SIZE);
+        beam_telemetry_from_keyframe(compact, &out->payload.telemetry);
+    }
+    else {
+        if (out->header.len > sizeof(compact)) {
+            return ESP_ERR_INVALID_SIZE;
         }
-        else {
-            memcpy(payload->raw, payload_src, len);
+        memcpy(compact, out->payload.raw, out->header.len);
+        esp_err_t err = beam_telemetry_decode_payload(decoder,
+                                                      out->header.flags,
+                                                      compact,
+                                                      out->header.len,
+                                                      &out->payload.telemetry);
+        if (err != ESP_OK) {
+            return err;
         }
-        break;
-    default:
-        memcpy(payload->raw, payload_src, len);
-        break;
     }
+    out->header.len = sizeof(out->payload.telemetry);
+    out->header.flags &= (beam_flags_t)~(MSG_FLAG_COMPACT | MSG_FLAG_DELTA);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Decompress a MSG_FLAG_COMPRESSED payload into out and clear the flag.
+ *
+ * @param src Compressed payload bytes of the received frame.
+ * @param len Number of compressed bytes.
+ * @param out Frame whose header is already filled.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE for a malformed stream (not logged).
+ */
+static esp_err_t inflate_payload(const uint8_t *src, uint8_t len, beam_frame_t *out)
+{
+    size_t inflated = 0;
+    esp_err_t err = beam_decompress(src, len, out->payload.raw, sizeof(out->payload.raw), &inflated);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    out->header.len = (uint8_t)inflated;
+    out->header.flags &= (beam_flags_t)~MSG_FLAG_COMPRESSED;
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Validate frame length, payload size and CRC of a raw frame buffer.
+ *
+ * Caller must ensure non-NULL data. Touches only data and the CRC backend, so with
+ * CONFIG_BEAM_PARSER_IN_IRAM (which implies silent mode) it runs without flash access.
+ *
+ * @param data Raw frame buffer starting with header.
+ * @param data_len Length of data buffer.
+ * @param[out] out_len Wire length taken from the header (timestamp included), set on success.
+ *
+ * @return ESP_OK on success.
+ *         ESP_ERR_INVALID_SIZE if buffer too short or payload length invalid.
+ *         ESP_ERR_INVALID_CRC if CRC mismatch.
+ */
+static esp_err_t PARSER_IRAM_ATTR validate_frame(const uint8_t *data, size_t data_len, uint8_t *out_len)
+{
+    VALIDATE_RETURN_ON_FALSE(data_len >= FRAME_HEADER_SIZE,
+                             "buffer shorter than frame header (4 bytes)",
+                             ESP_ERR_INVALID_SIZE);
+
+    uint8_t len = data[FRAME_OFFSET_LEN];
+    VALIDATE_RETURN_ON_FALSE(len <= MAX_PAYLOAD_SIZE, "payload length exceeds MAX_PAYLOAD_SIZE", ESP_ERR_INVALID_SIZE);
+    VALIDATE_RETURN_ON_FALSE(data_len >= FRAME_SIZE(len),
+                             "buffer shorter than header + payload + CRC",
+                             ESP_ERR_INVALID_SIZE);
+    VALIDATE_RETURN_ON_FALSE(len >= FRAME_EXT_SIZE(data[FRAME_OFFSET_FLAGS]),
+                             "length shorter than the MSG_FLAG_EXT_TS timestamp",
+                             ESP_ERR_INVALID_SIZE);
+
+    uint16_t expected_crc = frame_crc(data, FRAME_HEADER_SIZE + len);
+    uint16_t received_crc = frame_read_crc(data + FRAME_HEADER_SIZE + len);
+    VALIDATE_RETURN_ON_FALSE(expected_crc == received_crc, "frame CRC mismatch", ESP_ERR_INVALID_CRC);
+
+    *out_len = len;
+
+    return ESP_OK;
 }
 
 /**
  * @brief Parse and validate a raw frame buffer into beam_frame_t structure.
  *
- * Validates frame length, payload size, and CRC. Fills header and payload fields.
- * Caller must ensure data_len >= FRAME_MIN_SIZE and non-NULL arguments.
+ * Validates frame length, payload size, and CRC. Fills header and payload fields,
+ * decompressing MSG_FLAG_COMPRESSED payloads and expanding compact telemetry payloads
+ * (see expand_compact()). A MSG_FLAG_EXT_TS timestamp is not counted in header.len.
+ * Caller must ensure non-NULL data and out. Accepted and rejected frames are counted in
+ * beam_stats (see beam_stats.h).
  *
  * @param data Raw frame buffer starting with header.
  * @param data_len Length of data buffer.
  * @param out Output frame structure to fill.
+ * @param[out] out_timestamp_us Optional sender timestamp, 0 without MSG_FLAG_EXT_TS. Can be NULL.
+ * @param decoder Optional keyframe state of the sender for compact telemetry deltas. Can be NULL.
  *
  * @return ESP_OK on success.
  *         ESP_ERR_INVALID_SIZE if buffer too short or payload length invalid.
  *         ESP_ERR_INVALID_CRC if CRC mismatch.
+ *         ESP_ERR_NOT_FOUND if a delta refers to a keyframe decoder has not seen.
  */
-static esp_err_t parse_into_frame(const uint8_t *data, size_t data_len, beam_frame_t *out)
+static esp_err_t parse_into_frame(const uint8_t *data,
+                                  size_t data_len,
+                                  beam_frame_t *out,
+                                  uint32_t *out_timestamp_us,
+                                  beam_telemetry_decoder_t *decoder)
 {
-    PARSER_RETURN_ON_FALSE(data_len >= FRAME_HEADER_SIZE,
-                           "buffer shorter than frame header (4 bytes)",
-                           ESP_ERR_INVALID_SIZE);
+    uint32_t start = stats_parse_begin();
+    uint8_t len = 0;
+    esp_err_t err = validate_frame(data, data_len, &len);
+    if (err != ESP_OK) {
+        reject(err);
+        return err;
+    }
 
-    uint8_t len = data[3];
-    PARSER_RETURN_ON_FALSE(len <= MAX_PAYLOAD_SIZE, "payload length exceeds MAX_PAYLOAD_SIZE", ESP_ERR_INVALID_SIZE);
-    PARSER_RETURN_ON_FALSE(data_len >= FRAME_SIZE(len),
-                           "buffer shorter than header + payload + CRC",
-                           ESP_ERR_INVALID_SIZE);
+    beam_frame_view_t view = {data, FRAME_SIZE(len)};
+    const uint8_t *payload = beam_frame_view_payload(&view);
+    uint8_t payload_len = beam_frame_view_payload_len(&view);
 
-    uint16_t expected_crc = esp_crc16_be(CRC_INIT, data, FRAME_HEADER_SIZE + len);
-    uint16_t received_crc =
-        (uint16_t)data[FRAME_HEADER_SIZE + len] | ((uint16_t)data[FRAME_HEADER_SIZE + len + 1] << 8);
-    PARSER_RETURN_ON_FALSE(expected_crc == received_crc, "frame CRC mismatch", ESP_ERR_INVALID_CRC);
+    out->header.msg_category = data[FRAME_OFFSET_CATEGORY];
+    out->header.flags = data[FRAME_OFFSET_FLAGS];
+    out->header.seq = data[FRAME_OFFSET_SEQ];
+    out->header.len = payload_len;
+    if (out_timestamp_us != NULL) {
+        *out_timestamp_us = beam_frame_view_timestamp(&view);
+    }
 
-    out->header.msg_category = data[0];
-    out->header.flags = data[1];
-    out->header.seq = data[2];
-    out->header.len = len;
+    if (out->header.flags & MSG_FLAG_COMPRESSED) {
+        err = inflate_payload(payload, payload_len, out);
+        if (err != ESP_OK) {
+            reject(err);
+            return err;
+        }
+    }
+    else {
+        fill_payload(out->header.msg_category, payload, payload_len, &out->payload);
+    }
+    err = expand_compact(out, decoder);
+    if (err != ESP_OK) {
+        reject(err);
+        return err;
+    }
+
+    out->crc = frame_read_crc(data + FRAME_HEADER_SIZE + len);
+    stats_record_parse(data[FRAME_OFFSET_CATEGORY], FRAME_SIZE(len), start);
 
-    fill_payload(out->header.msg_category, data + FRAME_HEADER_SIZE, len, &out->payload);
+    return ESP_OK;
+}
+
+/**
+ * @brief Validate a raw frame buffer and point a view at it.
+ *
+ * Caller must ensure non-NULL arguments. Accepted and rejected frames are counted in
+ * beam_stats (see beam_stats.h).
+ *
+ * @param data Raw frame buffer starting with header.
+ * @param data_len Length of data buffer.
+ * @param out View to fill.
+ *
+ * @return ESP_OK on success, otherwise the error from validate_frame().
+ */
+static esp_err_t parse_view(const uint8_t *data, size_t data_len, beam_frame_view_t *out)
+{
+    uint32_t start = stats_parse_begin();
+    uint8_t len = 0;
+    esp_err_t err = validate_frame(data, data_len, &len);
+    if (err != ESP_OK) {
+        reject(err);
+        return err;
+    }
 
-    out->crc = received_crc;
+    out->data = data;
+    out->size = FRAME_SIZE(len);
+    stats_record_parse(data[FRAME_OFFSET_CATEGORY], out->size, start);
 
     return ESP_OK;
 }
@@ -115,9 +341,13 @@ static esp_err_t parse_into_frame(const uint8_t *data, size_t data_len, beam_fra
  * @brief Serialize beam_frame_t into raw buffer (header + payload + CRC).
  *
  * Writes frame header, payload bytes, computes CRC over header+payload, and writes CRC.
- * CRC is written LSB first (little-endian) to match wire format.
+ * CRC is written LSB first (little-endian) to match wire format. With MSG_FLAG_COMPRESSED
+ * the payload is compressed in place in out_buffer, or sent as is with the flag cleared
+ * when compression would not make it shorter. With MSG_FLAG_EXT_TS, timestamp_us is
+ * written before the payload and counted in the wire len.
  *
- * @param frame Frame structure to serialize. Must have valid header.len <= MAX_PAYLOAD_SIZE.
+ * @param frame Frame structure to serialize. header.len plus the timestamp must fit MAX_PAYLOAD_SIZE.
+ * @param timestamp_us Sender timestamp; written only with MSG_FLAG_EXT_TS.
  * @param out_buffer Buffer to write serialized frame.
  * @param buffer_size Size of out_buffer in bytes.
  * @param[out] out_size Optional pointer to receive number of bytes written. Can be NULL.
@@ -125,26 +355,46 @@ static esp_err_t parse_into_frame(const uint8_t *data, size_t data_len, beam_fra
  * @return ESP_OK on success.
  *         ESP_ERR_INVALID_SIZE if buffer_size too small.
  */
-static esp_err_t serialize_frame(const beam_frame_t *frame, uint8_t *out_buffer, size_t buffer_size, size_t *out_size)
+static esp_err_t serialize_frame(const beam_frame_t *frame,
+                                 uint32_t timestamp_us,
+                                 uint8_t *out_buffer,
+                                 size_t buffer_size,
+                                 size_t *out_size)
 {
-    size_t required_size = FRAME_SIZE(frame->header.len);
+    uint8_t ext = FRAME_EXT_SIZE(frame->header.flags);
+    size_t required_size = FRAME_SIZE(frame->header.len + ext);
     PARSER_RETURN_ON_FALSE(buffer_size >= required_size, "buffer_size too small for frame", ESP_ERR_INVALID_SIZE);
 
-    out_buffer[0] = frame->header.msg_category;
-    out_buffer[1] = frame->header.flags;
-    out_buffer[2] = frame->header.seq;
-    out_buffer[3] = frame->header.len;
+    uint8_t *payload = out_buffer + FRAME_HEADER_SIZE + ext;
+    beam_flags_t flags = frame->header.flags;
+    uint8_t len = frame->header.len;
+    size_t packed = 0;
 
-    memcpy(out_buffer + FRAME_HEADER_SIZE, frame->payload.raw, frame->header.len);
+    // Only keep the compressed form if it is at least one byte shorter
+    if ((flags & MSG_FLAG_COMPRESSED) && len > 0 &&
+        beam_compress(frame->payload.raw, len, payload, len - 1u, &packed) == ESP_OK) {
+        len = (uint8_t)packed;
+    }
+    else {
+        flags &= (beam_flags_t)~MSG_FLAG_COMPRESSED;
+        beam_copy(payload, frame->payload.raw, len);
+    }
 
-    uint16_t crc = esp_crc16_be(CRC_INIT, out_buffer, FRAME_HEADER_SIZE + frame->header.len);
-    size_t crc_offset = FRAME_HEADER_SIZE + frame->header.len;
-    out_buffer[crc_offset] = (uint8_t)(crc & 0xFF);            // LSB
-    out_buffer[crc_offset + 1] = (uint8_t)((crc >> 8) & 0xFF); // MSB
+    out_buffer[FRAME_OFFSET_CATEGORY] = frame->header.msg_category;
+    out_buffer[FRAME_OFFSET_FLAGS] = flags;
+    out_buffer[FRAME_OFFSET_SEQ] = frame->header.seq;
+    out_buffer[FRAME_OFFSET_LEN] = (uint8_t)(len + ext);
+    if (ext != 0) {
+        frame_write_timestamp(out_buffer + FRAME_OFFSET_TS, timestamp_us);
+    }
+
+    uint16_t crc = frame_crc(out_buffer, FRAME_HEADER_SIZE + ext + len);
+    frame_write_crc(payload + len, crc);
 
     if (out_size != NULL) {
-        *out_size = required_size;
+        *out_size = FRAME_SIZE(ext + len);
     }
+    stats_record_serialize(FRAME_SIZE(ext + len));
 
     return ESP_OK;
 }
@@ -153,18 +403,137 @@ esp_err_t beam_parse_into_frame(const uint8_t *data, size_t data_len, beam_frame
 {
     PARSER_RETURN_ON_FALSE(data != NULL, "data pointer is NULL", ESP_ERR_INVALID_ARG);
     PARSER_RETURN_ON_FALSE(out_frame != NULL, "out_frame pointer is NULL", ESP_ERR_INVALID_ARG);
-    PARSER_RETURN_ON_FALSE(data_len >= FRAME_MIN_SIZE, "data_len less than FRAME_MIN_SIZE", ESP_ERR_INVALID_SIZE);
 
-    return parse_into_frame(data, data_len, out_frame);
+    return parse_into_frame(data, data_len, out_frame, NULL, NULL);
+}
+
+esp_err_t beam_parse_into_frame_ts(const uint8_t *data,
+                                   size_t data_len,
+                                   beam_frame_t *out_frame,
+                                   uint32_t *out_timestamp_us)
+{
+    PARSER_RETURN_ON_FALSE(data != NULL, "data pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(out_frame != NULL, "out_frame pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(out_timestamp_us != NULL, "out_timestamp_us pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    return parse_into_frame(data, data_len, out_frame, out_timestamp_us, NULL);
+}
+
+esp_err_t beam_parse_into_frame_telemetry(const uint8_t *data,
+                                          size_t data_len,
+                                          beam_frame_t *out_frame,
+                                          beam_telemetry_decoder_t *decoder)
+{
+    PARSER_RETURN_ON_FALSE(data != NULL, "data pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(out_frame != NULL, "out_frame pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(decoder != NULL, "decoder pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    return parse_into_frame(data, data_len, out_frame, NULL, decoder);
+}
+
+esp_err_t beam_parse_view(const uint8_t *data, size_t data_len, beam_frame_view_t *out_view)
+{
+    PARSER_RETURN_ON_FALSE(data != NULL, "data pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(out_view != NULL, "out_view pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    return parse_view(data, data_len, out_view);
+}
+
+esp_err_t PARSER_IRAM_ATTR beam_validate_frame(const uint8_t *data, size_t data_len, beam_frame_header_t *out_header)
+{
+    // Not PARSER_RETURN_ON_FALSE: the log format strings live in flash
+    if (data == NULL || out_header == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t len = 0;
+    esp_err_t err = validate_frame(data, data_len, &len);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    out_header->msg_category = data[FRAME_OFFSET_CATEGORY];
+    out_header->flags = data[FRAME_OFFSET_FLAGS];
+    out_header->seq = data[FRAME_OFFSET_SEQ];
+    out_header->len = (uint8_t)(len - FRAME_EXT_SIZE(out_header->flags));
+
+    return ESP_OK;
+}
+
+esp_err_t beam_parse_batch(const beam_rx_slice_t *in, size_t n, beam_frame_view_t *out, esp_err_t *status)
+{
+    PARSER_RETURN_ON_FALSE(n == 0 || in != NULL, "in pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(n == 0 || out != NULL, "out pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(n == 0 || status != NULL, "status pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint32_t start = stats_parse_begin();
+
+    // Stage 1: bounds and CRC of every packet back to back; out[i].size holds the frame size
+    for (size_t i = 0; i < n; i++) {
+        uint8_t len = 0;
+        status[i] = in[i].data == NULL ? ESP_ERR_INVALID_ARG : validate_frame(in[i].data, in[i].len, &len);
+        out[i].size = FRAME_SIZE(len);
+    }
+
+    // Stage 2: views of the valid packets, then the counters of the whole batch at once
+    esp_err_t result = ESP_OK;
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    uint32_t invalid_size = 0;
+    uint32_t invalid_crc = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (status[i] == ESP_OK) {
+            out[i].data = in[i].data;
+            stats_record_category(in[i].data[FRAME_OFFSET_CATEGORY]);
+            frames++;
+            bytes += (uint32_t)out[i].size;
+            continue;
+        }
+
+        result = ESP_FAIL;
+        invalid_size += status[i] == ESP_ERR_INVALID_SIZE;
+        invalid_crc += status[i] == ESP_ERR_INVALID_CRC;
+    }
+
+    if (frames != 0) {
+        stats_record_parsed(frames, bytes, start);
+    }
+    if (invalid_size != 0 || invalid_crc != 0) {
+        stats_record_errors(invalid_size, invalid_crc);
+        report_errors();
+    }
+
+    return result;
 }
 
 esp_err_t beam_serialize_frame(const beam_frame_t *frame, uint8_t *out_buffer, size_t buffer_size, size_t *out_size)
 {
     PARSER_RETURN_ON_FALSE(frame != NULL, "frame pointer is NULL", ESP_ERR_INVALID_ARG);
     PARSER_RETURN_ON_FALSE(out_buffer != NULL, "out_buffer pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(!(frame->header.flags & MSG_FLAG_EXT_TS),
+                           "MSG_FLAG_EXT_TS needs beam_serialize_frame_ts()",
+                           ESP_ERR_INVALID_ARG);
     PARSER_RETURN_ON_FALSE(frame->header.len <= MAX_PAYLOAD_SIZE,
                            "frame.header.len exceeds MAX_PAYLOAD_SIZE",
                            ESP_ERR_INVALID_STATE);
 
-    return serialize_frame(frame, out_buffer, buffer_size, out_size);
+    return serialize_frame(frame, 0, out_buffer, buffer_size, out_size);
+}
+
+esp_err_t beam_serialize_frame_ts(const beam_frame_t *frame,
+                                  uint32_t timestamp_us,
+                                  uint8_t *out_buffer,
+                                  size_t buffer_size,
+                                  size_t *out_size)
+{
+    PARSER_RETURN_ON_FALSE(frame != NULL, "frame pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(out_buffer != NULL, "out_buffer pointer is NULL", ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(frame->header.flags & MSG_FLAG_EXT_TS,
+                           "frame without MSG_FLAG_EXT_TS has no timestamp",
+                           ESP_ERR_INVALID_ARG);
+    PARSER_RETURN_ON_FALSE(frame->header.len + FRAME_EXT_TS_SIZE <= MAX_PAYLOAD_SIZE,
+                           "frame.header.len plus timestamp exceeds MAX_PAYLOAD_SIZE",
+                           ESP_ERR_INVALID_STATE);
+
+    return serialize_frame(frame, timestamp_us, out_buffer, buffer_size, out_size);
 }
@@ -0,0 +1,40 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_payload_access.h"
+#include "beam_payload_type.h"
+#include <assert.h>
+
+#define PAYLOAD_SIZE_ENTRY(category, member, type) [category] = sizeof(type),
+#define PAYLOAD_SIZE_CHECK(category, member, type)                                                                     \
+    static_assert(sizeof(type) <= MAX_PAYLOAD_SIZE, #type " exceeds MAX_PAYLOAD_SIZE");                                \
+    static_assert((category) >= 0 && (category) <= UINT8_MAX, #category " does not fit msg_category");
+
+BEAM_PAYLOADS(PAYLOAD_SIZE_CHECK)
+
+/* Accessor field lists must agree with the packed structs, field by field and in total */
+#define ACCESS_FIELD_CHECK(payload, packed, field, type, reader)                                                       \
+    static_assert(sizeof(((packed *)0)->field) == sizeof(type), #packed "." #field " does not match its accessor");
+#define ACCESS_FIELD_SIZE(payload, packed, field, type, reader) +sizeof(type)
+#define ACCESS_PAYLOAD_CHECK(category, member, type)                                                                   \
+    BEAM_PAYLOAD_FIELDS_##member(ACCESS_FIELD_CHECK)                                                                   \
+    static_assert(sizeof(type) == 0 BEAM_PAYLOAD_FIELDS_##member(ACCESS_FIELD_SIZE),                                   \
+                  "BEAM_PAYLOAD_FIELDS_" #member " misses fields of " #type);
+
+BEAM_PAYLOAD_REGISTRY(ACCESS_PAYLOAD_CHECK)
+
+/* A category registered twice is reported by -Woverride-init */
+const uint8_t beam_payload_size_table[256] = {BEAM_PAYLOADS(PAYLOAD_SIZE_ENTRY)};
@@ -0,0 +1,262 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_copy_internal.h"
+#include "beam_latency_internal.h"
+#include "beam_parser.h"
+#include "beam_pipeline.h"
+#include "esp_check.h"
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#if CONFIG_FREERTOS_UNICORE
+#define RX_CORE 0       /**< Only core */
+#define DISPATCH_CORE 0 /**< Only core */
+#else
+#define RX_CORE CONFIG_BEAM_PIPELINE_RX_CORE             /**< Core of the validation stage */
+#define DISPATCH_CORE CONFIG_BEAM_PIPELINE_DISPATCH_CORE /**< Core of the dispatch stage */
+#endif
+
+#define TASK_COUNT 2u /**< RX and dispatch */
+
+static_assert(BEAM_PIPELINE_QUEUE_DEPTH >= 2 && (BEAM_PIPELINE_QUEUE_DEPTH & (BEAM_PIPELINE_QUEUE_DEPTH - 1)) == 0,
+              "CONFIG_BEAM_PIPELINE_QUEUE_DEPTH must be a power of two >= 2");
+
+static const char *TAG = "[BEAM_pipeline]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define PIPELINE_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/*
+ * All three stages share one ring of slots. head, validated and tail are free-running
+ * frame counts, each written by one stage and published with a release store: the
+ * submitter fills slot head and bumps head, the RX task validates slots up to head in
+ * place and bumps validated, and the dispatch task runs the subscribers on slots up to
+ * validated and bumps tail. A slot is free again only once tail has passed it, so a
+ * frame is never copied after beam_pipeline_submit().
+ *
+ * Wake-ups are direct-to-task notifications. The submitter notifies the RX task and the
+ * RX task the dispatch task after every publish; each task drains its stage before taking
+ * the next notification, so frames published between the check and the wait are never
+ * missed. Nobody waits for room: a full ring is ESP_ERR_NO_MEM in beam_pipeline_submit().
+ *
+ * On stop each task parks in ulTaskNotifyTake() and beam_pipeline_stop() deletes both
+ * once they have parked; a parked task notifies nobody, so neither is notified after
+ * deletion.
+ */
+
+#define SLOT_MASK (BEAM_PIPELINE_QUEUE_DEPTH - 1u) /**< Frame count -> slot index */
+
+/**
+ * @brief Count the calling task as parked and block until it is deleted.
+ */
+static void park(beam_pipeline_t *pipeline)
+{
+    __atomic_add_fetch(&pipeline->parked, 1, __ATOMIC_RELEASE);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Increment a counter only the calling stage writes, atomically for beam_pipeline_get_stats().
+ */
+static void count(uint32_t *counter)
+{
+    __atomic_store_n(counter, *counter + 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Publish an index only the calling stage writes to the next stage.
+ */
+static void publish(uint32_t *index, uint32_t value)
+{
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+static bool running(const beam_pipeline_t *pipeline)
+{
+    return __atomic_load_n(&pipeline->running, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Validation stage: validates submitted slots in place.
+ */
+static void rx_task(void *arg)
+{
+    beam_pipeline_t *pipeline = arg;
+
+    while (running(pipeline)) {
+        uint32_t index = pipeline->validated;
+        if (index == __atomic_load_n(&pipeline->head, __ATOMIC_ACQUIRE)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        beam_frame_buf_t *slot = &pipeline->slots[index & SLOT_MASK];
+        beam_frame_view_t view;
+        if (beam_parse_view(slot->data, slot->len, &view) != ESP_OK) {
+            count(&pipeline->stats.invalid);
+            slot->len = 0;
+        } else {
+#if CONFIG_BEAM_LATENCY_TRACE
+            latency_mark(&view, BEAM_LATENCY_STAGE_RX, pipeline->rx_time_us[index & SLOT_MASK]);
+#endif
+            latency_mark(&view, BEAM_LATENCY_STAGE_VALIDATE, latency_now());
+            slot->len = (uint16_t)view.size;
+            // Last look at the slot: once published the dispatch task may free it
+            latency_mark(&view, BEAM_LATENCY_STAGE_ENQUEUE, latency_now());
+        }
+        publish(&pipeline->validated, index + 1);
+        xTaskNotifyGive(pipeline->dispatch_task);
+    }
+
+    park(pipeline);
+}
+
+/**
+ * @brief Dispatch stage: runs the subscribers on validated slots.
+ */
+static void dispatch_task(void *arg)
+{
+    beam_pipeline_t *pipeline = arg;
+
+    while (running(pipeline)) {
+        uint32_t index = pipeline->tail;
+        if (index == __atomic_load_n(&pipeline->validated, __ATOMIC_ACQUIRE)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        const beam_frame_buf_t *slot = &pipeline->slots[index & SLOT_MASK];
+        if (slot->len != 0) {
+            beam_frame_view_t view = {.data = slot->data, .size = slot->len};
+            latency_mark(&view, BEAM_LATENCY_STAGE_DISPATCH, latency_now());
+            beam_dispatch(pipeline->dispatcher, &view);
+            count(&pipeline->stats.dispatched);
+        }
+        publish(&pipeline->tail, index + 1);
+    }
+
+    park(pipeline);
+}
+
+esp_err_t beam_pipeline_start(beam_pipeline_t *pipeline, const beam_dispatcher_t *dispatcher)
+{
+    PIPELINE_RETURN_ON_FALSE(pipeline != NULL, "pipeline pointer is NULL", ESP_ERR_INVALID_ARG);
+    PIPELINE_RETURN_ON_FALSE(dispatcher != NULL, "dispatcher pointer is NULL", ESP_ERR_INVALID_ARG);
+    PIPELINE_RETURN_ON_FALSE(!pipeline->running, "pipeline already running", ESP_ERR_INVALID_STATE);
+
+    pipeline->head = 0;
+    pipeline->validated = 0;
+    pipeline->tail = 0;
+    memset(&pipeline->stats, 0, sizeof(pipeline->stats));
+    pipeline->dispatcher = dispatcher;
+    pipeline->parked = 0;
+    pipeline->running = true;
+
+    // The dispatch task first: the RX task notifies it as soon as a frame passes validation
+    if (xTaskCreatePinnedToCore(dispatch_task,
+                                "beam_dispatch",
+                                CONFIG_BEAM_PIPELINE_DISPATCH_STACK_SIZE,
+                                pipeline,
+                                CONFIG_BEAM_PIPELINE_DISPATCH_PRIORITY,
+                                &pipeline->dispatch_task,
+                                DISPATCH_CORE) != pdPASS) {
+        pipeline->running = false;
+        PIPELINE_RETURN_ON_FALSE(false, "failed to create dispatch task", ESP_ERR_NO_MEM);
+    }
+    if (xTaskCreatePinnedToCore(rx_task,
+                                "beam_rx",
+                                CONFIG_BEAM_PIPELINE_RX_STACK_SIZE,
+                                pipeline,
+                                CONFIG_BEAM_PIPELINE_RX_PRIORITY,
+                                &pipeline->rx_task,
+                                RX_CORE) != pdPASS) {
+        pipeline->running = false;
+        vTaskDelete(pipeline->dispatch_task);
+        PIPELINE_RETURN_ON_FALSE(false, "failed to create RX task", ESP_ERR_NO_MEM);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_pipeline_submit(beam_pipeline_t *pipeline, const uint8_t *data, size_t data_len)
+{
+    PIPELINE_RETURN_ON_FALSE(pipeline != NULL, "pipeline pointer is NULL", ESP_ERR_INVALID_ARG);
+    PIPELINE_RETURN_ON_FALSE(data != NULL, "data pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    if (!running(pipeline)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (data_len > FRAME_MAX_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint32_t index = pipeline->head;
+    if (index - __atomic_load_n(&pipeline->tail, __ATOMIC_ACQUIRE) == BEAM_PIPELINE_QUEUE_DEPTH) {
+        count(&pipeline->stats.dropped);
+        return ESP_ERR_NO_MEM;
+    }
+#if CONFIG_BEAM_LATENCY_TRACE
+    pipeline->rx_time_us[index & SLOT_MASK] = latency_now();
+#endif
+    beam_frame_buf_t *slot = &pipeline->slots[index & SLOT_MASK];
+    beam_copy(slot->data, data, data_len);
+    slot->len = (uint16_t)data_len;
+    publish(&pipeline->head, index + 1);
+    count(&pipeline->stats.submitted);
+    xTaskNotifyGive(pipeline->rx_task);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_pipeline_stop(beam_pipeline_t *pipeline)
+{
+    PIPELINE_RETURN_ON_FALSE(pipeline != NULL, "pipeline pointer is NULL", ESP_ERR_INVALID_ARG);
+    PIPELINE_RETURN_ON_FALSE(pipeline->running, "pipeline not running", ESP_ERR_INVALID_STATE);
+
+    __atomic_store_n(&pipeline->running, false, __ATOMIC_RELEASE);
+    xTaskNotifyGive(pipeline->rx_task);
+    xTaskNotifyGive(pipeline->dispatch_task);
+    while (__atomic_load_n(&pipeline->parked, __ATOMIC_ACQUIRE) < TASK_COUNT) {
+        vTaskDelay(1);
+    }
+
+    vTaskDelete(pipeline->rx_task);
+    vTaskDelete(pipeline->dispatch_task);
+    pipeline->rx_task = NULL;
+    pipeline->dispatch_task = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_pipeline_get_stats(const beam_pipeline_t *pipeline, beam_pipeline_stats_t *out_stats)
+{
+    PIPELINE_RETURN_ON_FALSE(pipeline != NULL, "pipeline pointer is NULL", ESP_ERR_INVALID_ARG);
+    PIPELINE_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    out_stats->submitted = __atomic_load_n(&pipeline->stats.submitted, __ATOMIC_RELAXED);
+    out_stats->dropped = __atomic_load_n(&pipeline->stats.dropped, __ATOMIC_RELAXED);
+    out_stats->invalid = __atomic_load_n(&pipeline->stats.invalid, __ATOMIC_RELAXED);
+    out_stats->dispatched = __atomic_load_n(&pipeline->stats.dispatched, __ATOMIC_RELAXED);
+
+    return ESP_OK;
+}
@@ -0,0 +1,138 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_pool.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define POOL_COUNT CONFIG_BEAM_POOL_BUFFER_COUNT /**< Number of pool buffers */
+#define POOL_NONE UINT8_MAX                      /**< Free-list terminator */
+
+#if CONFIG_BEAM_POOL_IN_PSRAM
+#define POOL_STORAGE_ATTR EXT_RAM_BSS_ATTR /**< Buffer storage in external RAM */
+#else
+#define POOL_STORAGE_ATTR
+#endif
+
+static const char *TAG = "[BEAM_pool]";
+
+/**
+ * If condition is false, return ret_val (logging is ISR-safe).
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define POOL_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE_ISR(condition, ret_val, TAG, "%s", msg)
+
+static POOL_STORAGE_ATTR beam_frame_buf_t s_buffers[POOL_COUNT];
+
+/*
+ * Buffers are handed out in index order until every one has been used once (s_fresh),
+ * after which released buffers are recycled through a singly linked free list. This
+ * keeps both operations O(1) without an initialization pass. s_in_use marks acquired
+ * buffers, so a second release of the same buffer is caught before it corrupts the list.
+ */
+static uint8_t s_next[POOL_COUNT];                ///< Free-list links by buffer index
+static uint32_t s_in_use[(POOL_COUNT + 31) / 32]; ///< One bit per acquired buffer
+static uint8_t s_free_head = POOL_NONE;
+static uint16_t s_fresh;
+static beam_pool_stats_t s_stats = {.capacity = POOL_COUNT};
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t beam_pool_acquire(beam_frame_buf_t **out_buf)
+{
+    POOL_RETURN_ON_FALSE(out_buf != NULL, "out_buf pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    size_t index = POOL_NONE;
+
+    portENTER_CRITICAL_SAFE(&s_lock);
+    if (s_free_head != POOL_NONE) {
+        index = s_free_head;
+        s_free_head = s_next[index];
+    }
+    else if (s_fresh < POOL_COUNT) {
+        index = s_fresh++;
+    }
+
+    if (index != POOL_NONE) {
+        s_in_use[index / 32] |= 1u << (index % 32);
+        s_stats.in_use++;
+        if (s_stats.in_use > s_stats.high_water) {
+            s_stats.high_water = s_stats.in_use;
+        }
+    }
+    else {
+        s_stats.alloc_failures++;
+    }
+    portEXIT_CRITICAL_SAFE(&s_lock);
+
+    if (index == POOL_NONE) {
+        *out_buf = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_buffers[index].len = 0;
+    *out_buf = &s_buffers[index];
+
+    return ESP_OK;
+}
+
+esp_err_t beam_pool_release(beam_frame_buf_t *buf)
+{
+    POOL_RETURN_ON_FALSE(buf >= &s_buffers[0] && buf < &s_buffers[POOL_COUNT] &&
+                             ((uintptr_t)buf - (uintptr_t)s_buffers) % sizeof(s_buffers[0]) == 0,
+                         "buffer does not belong to the pool",
+                         ESP_ERR_INVALID_ARG);
+
+    uint8_t index = (uint8_t)(buf - s_buffers);
+    uint32_t bit = 1u << (index % 32);
+    bool acquired = false;
+
+    portENTER_CRITICAL_SAFE(&s_lock);
+    acquired = (s_in_use[index / 32] & bit) != 0;
+    if (acquired) {
+        s_in_use[index / 32] &= ~bit;
+        s_next[index] = s_free_head;
+        s_free_head = index;
+        s_stats.in_use--;
+    }
+    portEXIT_CRITICAL_SAFE(&s_lock);
+
+    POOL_RETURN_ON_FALSE(acquired, "buffer is not acquired (double release?)", ESP_ERR_INVALID_STATE);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_pool_get_stats(beam_pool_stats_t *out_stats)
+{
+    POOL_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    portENTER_CRITICAL_SAFE(&s_lock);
+    *out_stats = s_stats;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+
+    return ESP_OK;
+}
+
+void beam_pool_reset_stats(void)
+{
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_stats.high_water = s_stats.in_use;
+    s_stats.alloc_failures = 0;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
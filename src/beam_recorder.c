@@ -0,0 +1,528 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_copy_internal.h"
+#include "beam_frame_internal.h"
+#include "beam_parser.h"
+#include "beam_recorder.h"
+#include "esp_check.h"
+#include <assert.h>
+#include <string.h>
+
+#define BATCH_OFFSET_MAGIC 0u /**< Offset of magic in a batch header */
+#define BATCH_OFFSET_SEQ 4u   /**< Offset of seq */
+#define BATCH_OFFSET_USED 8u  /**< Offset of used */
+#define BATCH_OFFSET_CRC 10u  /**< Offset of crc */
+
+#define RECORD_OFFSET_TIME 0u  /**< Offset of time_us in a record header */
+#define RECORD_OFFSET_MAC 4u   /**< Offset of mac */
+#define RECORD_OFFSET_RSSI 10u /**< Offset of rssi */
+#define RECORD_OFFSET_LEN 11u  /**< Offset of len */
+
+static_assert(BEAM_RECORDER_BATCH_SIZE >=
+                  BEAM_RECORDER_BATCH_HEADER_SIZE + BEAM_RECORDER_RECORD_HEADER_SIZE + FRAME_MAX_SIZE,
+              "CONFIG_BEAM_RECORDER_BATCH_SIZE must hold one maximum-size record");
+static_assert(BEAM_RECORDER_BATCH_SIZE - BEAM_RECORDER_BATCH_HEADER_SIZE <= UINT16_MAX,
+              "batch header stores the used size in 16 bits");
+static_assert(RECORD_OFFSET_LEN + 1 == BEAM_RECORDER_RECORD_HEADER_SIZE, "record header layout");
+static_assert(FRAME_MAX_SIZE <= UINT8_MAX, "record header stores the frame length in 8 bits");
+
+static const char *TAG = "[BEAM_recorder]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define RECORDER_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/*
+ * The recording task owns the active buffer; the flushing task owns the other one while
+ * pending is set. The recording task fills a buffer, switches active, then sets pending
+ * with release semantics; the flushing task loads it with acquire, writes the buffer and
+ * clears it with release. Neither buffer is touched by both tasks at once.
+ */
+
+static void put_u16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *dst, uint32_t value)
+{
+    put_u16(dst, (uint16_t)value);
+    put_u16(dst + 2, (uint16_t)(value >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *src)
+{
+    return (uint16_t)(src[0] | (src[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *src)
+{
+    return (uint32_t)get_u16(src) | ((uint32_t)get_u16(src + 2) << 16);
+}
+
+/**
+ * @brief Increment a counter only the calling task writes, atomically for beam_recorder_get_stats().
+ */
+static void count(uint32_t *counter)
+{
+    __atomic_store_n(counter, *counter + 1, __ATOMIC_RELAXED);
+}
+
+static size_t slot_count(const beam_recorder_storage_t *storage)
+{
+    return storage->size / BEAM_RECORDER_BATCH_SIZE;
+}
+
+/**
+ * @brief Read the header of a slot.
+ *
+ * @return ESP_OK with *out_valid set if the slot starts with BEAM_RECORDER_MAGIC, or the read error.
+ */
+static esp_err_t read_header(const beam_recorder_storage_t *storage, size_t slot, uint8_t *header, bool *out_valid)
+{
+    esp_err_t err =
+        storage->read(storage->ctx, slot * BEAM_RECORDER_BATCH_SIZE, header, BEAM_RECORDER_BATCH_HEADER_SIZE);
+    *out_valid = err == ESP_OK && get_u32(header + BATCH_OFFSET_MAGIC) == BEAM_RECORDER_MAGIC;
+
+    return err;
+}
+
+/**
+ * @brief Finish buffer index and write it to the next slot. Caller owns the buffer.
+ */
+static esp_err_t write_batch(beam_recorder_t *recorder, uint8_t index)
+{
+    const beam_recorder_storage_t *storage = recorder->storage;
+    uint8_t *batch = recorder->buffers[index];
+    size_t fill = recorder->fill[index];
+    size_t used = fill - BEAM_RECORDER_BATCH_HEADER_SIZE;
+
+    put_u32(batch + BATCH_OFFSET_MAGIC, BEAM_RECORDER_MAGIC);
+    put_u32(batch + BATCH_OFFSET_SEQ, recorder->seq);
+    put_u16(batch + BATCH_OFFSET_USED, (uint16_t)used);
+    put_u16(batch + BATCH_OFFSET_CRC, beam_crc16(BEAM_CRC_INIT, batch + BEAM_RECORDER_BATCH_HEADER_SIZE, used));
+
+    size_t offset = recorder->write_offset;
+    esp_err_t err = ESP_OK;
+    if (storage->erase != NULL) {
+        err = storage->erase(storage->ctx, offset, BEAM_RECORDER_BATCH_SIZE);
+    }
+    if (err == ESP_OK) {
+        err = storage->write(storage->ctx, offset, batch, fill);
+    }
+    if (err != ESP_OK) {
+        // Keep slot and seq: the next batch goes there, so the replayer sees no gap in the sequence
+        count(&recorder->stats.write_errors);
+        return err;
+    }
+
+    recorder->write_offset = (offset + BEAM_RECORDER_BATCH_SIZE) % (slot_count(storage) * BEAM_RECORDER_BATCH_SIZE);
+    recorder->seq++;
+    count(&recorder->stats.batches);
+
+    return ESP_OK;
+}
+
+static esp_err_t memory_write(void *ctx, size_t offset, const void *data, size_t len)
+{
+    memcpy((uint8_t *)ctx + offset, data, len);
+
+    return ESP_OK;
+}
+
+static esp_err_t memory_read(void *ctx, size_t offset, void *data, size_t len)
+{
+    memcpy(data, (const uint8_t *)ctx + offset, len);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_recorder_storage_init_memory(beam_recorder_storage_t *storage, uint8_t *buffer, size_t size)
+{
+    RECORDER_RETURN_ON_FALSE(storage != NULL, "storage pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(buffer != NULL, "buffer pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(size >= 2 * BEAM_RECORDER_BATCH_SIZE,
+                             "buffer holds fewer than two batches",
+                             ESP_ERR_INVALID_SIZE);
+
+    storage->erase = NULL;
+    storage->write = memory_write;
+    storage->read = memory_read;
+    storage->ctx = buffer;
+    storage->size = size - size % BEAM_RECORDER_BATCH_SIZE;
+
+    return ESP_OK;
+}
+
+#if CONFIG_BEAM_RECORDER_PARTITION
+static esp_err_t partition_erase(void *ctx, size_t offset, size_t len)
+{
+    return esp_partition_erase_range(ctx, offset, len);
+}
+
+static esp_err_t partition_write(void *ctx, size_t offset, const void *data, size_t len)
+{
+    return esp_partition_write(ctx, offset, data, len);
+}
+
+static esp_err_t partition_read(void *ctx, size_t offset, void *data, size_t len)
+{
+    return esp_partition_read(ctx, offset, data, len);
+}
+
+esp_err_t beam_recorder_storage_init_partition(beam_recorder_storage_t *storage, const esp_partition_t *partition)
+{
+    RECORDER_RETURN_ON_FALSE(storage != NULL, "storage pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(partition != NULL, "partition pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(BEAM_RECORDER_BATCH_SIZE % partition->erase_size == 0,
+                             "batch size is not a multiple of the partition erase size",
+                             ESP_ERR_INVALID_SIZE);
+    RECORDER_RETURN_ON_FALSE(partition->size >= 2 * BEAM_RECORDER_BATCH_SIZE,
+                             "partition holds fewer than two batches",
+                             ESP_ERR_INVALID_SIZE);
+
+    storage->erase = partition_erase;
+    storage->write = partition_write;
+    storage->read = partition_read;
+    storage->ctx = (void *)partition;
+    storage->size = partition->size - partition->size % BEAM_RECORDER_BATCH_SIZE;
+
+    return ESP_OK;
+}
+#endif
+
+esp_err_t beam_recorder_init(beam_recorder_t *recorder, const beam_recorder_storage_t *storage)
+{
+    RECORDER_RETURN_ON_FALSE(recorder != NULL, "recorder pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(storage != NULL, "storage pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(slot_count(storage) >= 2, "storage holds fewer than two batches", ESP_ERR_INVALID_SIZE);
+
+    // Continue after the newest batch, so earlier sessions stay in the log until overwritten
+    size_t next_slot = 0;
+    uint32_t next_seq = 0;
+    bool found = false;
+    for (size_t slot = 0; slot < slot_count(storage); slot++) {
+        uint8_t header[BEAM_RECORDER_BATCH_HEADER_SIZE];
+        bool valid = false;
+        ESP_RETURN_ON_ERROR(read_header(storage, slot, header, &valid), TAG, "failed to read batch header");
+
+        uint32_t seq = get_u32(header + BATCH_OFFSET_SEQ);
+        if (valid && (!found || seq >= next_seq)) {
+            found = true;
+            next_seq = seq + 1;
+            next_slot = (slot + 1) % slot_count(storage);
+        }
+    }
+
+    recorder->storage = storage;
+    recorder->fill[0] = BEAM_RECORDER_BATCH_HEADER_SIZE;
+    recorder->fill[1] = BEAM_RECORDER_BATCH_HEADER_SIZE;
+    recorder->active = 0;
+    recorder->pending = false;
+    recorder->write_offset = next_slot * BEAM_RECORDER_BATCH_SIZE;
+    recorder->seq = next_seq;
+    memset(&recorder->stats, 0, sizeof(recorder->stats));
+
+    return ESP_OK;
+}
+
+esp_err_t beam_recorder_record(beam_recorder_t *recorder,
+                               const uint8_t *mac,
+                               int8_t rssi,
+                               const uint8_t *data,
+                               size_t data_len,
+                               int64_t now_us)
+{
+    RECORDER_RETURN_ON_FALSE(recorder != NULL, "recorder pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(mac != NULL, "mac pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(data != NULL, "data pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    if (data_len > FRAME_MAX_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t record_size = BEAM_RECORDER_RECORD_HEADER_SIZE + data_len;
+    uint8_t active = recorder->active;
+    if (recorder->fill[active] + record_size > BEAM_RECORDER_BATCH_SIZE) {
+        if (__atomic_load_n(&recorder->pending, __ATOMIC_ACQUIRE)) {
+            count(&recorder->stats.dropped);
+            return ESP_ERR_NO_MEM;
+        }
+        active ^= 1u;
+        recorder->fill[active] = BEAM_RECORDER_BATCH_HEADER_SIZE;
+        recorder->active = active;
+        __atomic_store_n(&recorder->pending, true, __ATOMIC_RELEASE);
+    }
+
+    uint8_t *record = recorder->buffers[active] + recorder->fill[active];
+    put_u32(record + RECORD_OFFSET_TIME, (uint32_t)now_us);
+    memcpy(record + RECORD_OFFSET_MAC, mac, BEAM_MAC_LEN);
+    record[RECORD_OFFSET_RSSI] = (uint8_t)rssi;
+    record[RECORD_OFFSET_LEN] = (uint8_t)data_len;
+    beam_copy(record + BEAM_RECORDER_RECORD_HEADER_SIZE, data, data_len);
+    recorder->fill[active] += record_size;
+    count(&recorder->stats.recorded);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_recorder_flush(beam_recorder_t *recorder)
+{
+    RECORDER_RETURN_ON_FALSE(recorder != NULL, "recorder pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    if (!__atomic_load_n(&recorder->pending, __ATOMIC_ACQUIRE)) {
+        return ESP_OK;
+    }
+
+    esp_err_t err = write_batch(recorder, recorder->active ^ 1u);
+    __atomic_store_n(&recorder->pending, false, __ATOMIC_RELEASE);
+
+    return err;
+}
+
+esp_err_t beam_recorder_finish(beam_recorder_t *recorder)
+{
+    esp_err_t err = beam_recorder_flush(recorder);
+    if (err != ESP_OK || recorder->fill[recorder->active] == BEAM_RECORDER_BATCH_HEADER_SIZE) {
+        return err;
+    }
+
+    err = write_batch(recorder, recorder->active);
+    recorder->fill[recorder->active] = BEAM_RECORDER_BATCH_HEADER_SIZE;
+
+    return err;
+}
+
+esp_err_t beam_recorder_get_stats(const beam_recorder_t *recorder, beam_recorder_stats_t *out_stats)
+{
+    RECORDER_RETURN_ON_FALSE(recorder != NULL, "recorder pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    out_stats->recorded = __atomic_load_n(&recorder->stats.recorded, __ATOMIC_RELAXED);
+    out_stats->dropped = __atomic_load_n(&recorder->stats.dropped, __ATOMIC_RELAXED);
+    out_stats->batches = __atomic_load_n(&recorder->stats.batches, __ATOMIC_RELAXED);
+    out_stats->write_errors = __atomic_load_n(&recorder->stats.write_errors, __ATOMIC_RELAXED);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Load the next batch of the log into replay->batch, skipping corrupt ones.
+ *
+ * @return ESP_OK with a non-empty batch loaded, ESP_ERR_NOT_FOUND at the end of the log,
+ *         or the read error.
+ */
+static esp_err_t load_next_batch(beam_replay_t *replay)
+{
+    const beam_recorder_storage_t *storage = replay->storage;
+
+    while (replay->slots_left > 0) {
+        size_t slot = replay->slot;
+        replay->slot = (slot + 1) % slot_count(storage);
+        replay->slots_left--;
+
+        uint8_t *batch = replay->batch;
+        bool valid = false;
+        esp_err_t err = read_header(storage, slot, batch, &valid);
+        if (err != ESP_OK) {
+            replay->slots_left = 0;
+            return err;
+        }
+        // A gap in the sequence is where the newest batch ends and an older session begins
+        if (!valid || get_u32(batch + BATCH_OFFSET_SEQ) != replay->seq) {
+            break;
+        }
+        replay->seq++;
+
+        size_t used = get_u16(batch + BATCH_OFFSET_USED);
+        if (used > BEAM_RECORDER_BATCH_SIZE - BEAM_RECORDER_BATCH_HEADER_SIZE) {
+            replay->stats.corrupt_batches++;
+            continue;
+        }
+        err = storage->read(storage->ctx,
+                            slot * BEAM_RECORDER_BATCH_SIZE + BEAM_RECORDER_BATCH_HEADER_SIZE,
+                            batch + BEAM_RECORDER_BATCH_HEADER_SIZE,
+                            used);
+        if (err != ESP_OK) {
+            replay->slots_left = 0;
+            return err;
+        }
+        if (beam_crc16(BEAM_CRC_INIT, batch + BEAM_RECORDER_BATCH_HEADER_SIZE, used) !=
+            get_u16(batch + BATCH_OFFSET_CRC)) {
+            replay->stats.corrupt_batches++;
+            continue;
+        }
+        if (used == 0) {
+            continue;
+        }
+
+        replay->batch_pos = BEAM_RECORDER_BATCH_HEADER_SIZE;
+        replay->batch_end = BEAM_RECORDER_BATCH_HEADER_SIZE + used;
+
+        return ESP_OK;
+    }
+    replay->slots_left = 0;
+
+    return ESP_ERR_NOT_FOUND;
+}
+
+/**
+ * @brief Decode the record at batch_pos.
+ *
+ * @return false if the batch ends in a truncated record (then the rest of it is skipped).
+ */
+static bool peek_record(beam_replay_t *replay, beam_replay_record_t *out)
+{
+    const uint8_t *record = replay->batch + replay->batch_pos;
+    if (replay->batch_end - replay->batch_pos < BEAM_RECORDER_RECORD_HEADER_SIZE ||
+        replay->batch_end - replay->batch_pos - BEAM_RECORDER_RECORD_HEADER_SIZE < record[RECORD_OFFSET_LEN]) {
+        return false;
+    }
+
+    out->time_us = get_u32(record + RECORD_OFFSET_TIME);
+    memcpy(out->mac, record + RECORD_OFFSET_MAC, BEAM_MAC_LEN);
+    out->rssi = (int8_t)record[RECORD_OFFSET_RSSI];
+    out->len = record[RECORD_OFFSET_LEN];
+    out->data = record + BEAM_RECORDER_RECORD_HEADER_SIZE;
+
+    return true;
+}
+
+static void deliver(beam_replay_t *replay, const beam_replay_record_t *record)
+{
+    if (replay->on_record != NULL) {
+        replay->on_record(record, replay->ctx);
+    }
+    if (replay->dispatcher != NULL) {
+        beam_frame_view_t view;
+        if (beam_parse_view(record->data, record->len, &view) == ESP_OK) {
+            beam_dispatch(replay->dispatcher, &view);
+            replay->stats.dispatched++;
+        }
+        else {
+            replay->stats.invalid++;
+        }
+    }
+    replay->stats.records++;
+}
+
+esp_err_t beam_replay_init(beam_replay_t *replay,
+                           const beam_recorder_storage_t *storage,
+                           beam_replay_speed_t speed,
+                           const beam_dispatcher_t *dispatcher,
+                           beam_replay_cb_t on_record,
+                           void *ctx)
+{
+    RECORDER_RETURN_ON_FALSE(replay != NULL, "replay pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(storage != NULL, "storage pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(speed == BEAM_REPLAY_ORIGINAL || speed == BEAM_REPLAY_MAX,
+                             "unknown replay speed",
+                             ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(slot_count(storage) >= 2, "storage holds fewer than two batches", ESP_ERR_INVALID_SIZE);
+
+    // The oldest batch has the lowest sequence number; the log runs forward from it
+    size_t first_slot = 0;
+    uint32_t first_seq = 0;
+    bool found = false;
+    for (size_t slot = 0; slot < slot_count(storage); slot++) {
+        uint8_t header[BEAM_RECORDER_BATCH_HEADER_SIZE];
+        bool valid = false;
+        ESP_RETURN_ON_ERROR(read_header(storage, slot, header, &valid), TAG, "failed to read batch header");
+
+        uint32_t seq = get_u32(header + BATCH_OFFSET_SEQ);
+        if (valid && (!found || seq < first_seq)) {
+            found = true;
+            first_seq = seq;
+            first_slot = slot;
+        }
+    }
+
+    replay->storage = storage;
+    replay->dispatcher = dispatcher;
+    replay->on_record = on_record;
+    replay->ctx = ctx;
+    replay->speed = speed;
+    replay->batch_pos = 0;
+    replay->batch_end = 0;
+    replay->slot = first_slot;
+    replay->slots_left = found ? slot_count(storage) : 0;
+    replay->seq = first_seq;
+    replay->started = false;
+    replay->start_us = 0;
+    replay->elapsed_us = 0;
+    replay->last_time_us = 0;
+    memset(&replay->stats, 0, sizeof(replay->stats));
+
+    return ESP_OK;
+}
+
+esp_err_t beam_replay_poll(beam_replay_t *replay, int64_t now_us, size_t max_records, size_t *out_delivered)
+{
+    RECORDER_RETURN_ON_FALSE(replay != NULL, "replay pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    esp_err_t err = ESP_OK;
+    size_t delivered = 0;
+
+    while (delivered < max_records) {
+        beam_replay_record_t record;
+        if (replay->batch_pos >= replay->batch_end || !peek_record(replay, &record)) {
+            err = load_next_batch(replay);
+            if (err != ESP_OK) {
+                break;
+            }
+            continue;
+        }
+
+        if (replay->speed == BEAM_REPLAY_ORIGINAL) {
+            if (!replay->started) {
+                replay->started = true;
+                replay->start_us = now_us;
+                replay->last_time_us = record.time_us;
+            }
+            int32_t gap = (int32_t)(record.time_us - replay->last_time_us);
+            int64_t due_us = replay->elapsed_us + (gap > 0 ? gap : 0);
+            if (now_us - replay->start_us < due_us) {
+                break;
+            }
+            replay->elapsed_us = due_us;
+            replay->last_time_us = record.time_us;
+        }
+
+        deliver(replay, &record);
+        replay->batch_pos += BEAM_RECORDER_RECORD_HEADER_SIZE + record.len;
+        delivered++;
+    }
+
+    if (out_delivered != NULL) {
+        *out_delivered = delivered;
+    }
+
+    return err;
+}
+
+esp_err_t beam_replay_get_stats(const beam_replay_t *replay, beam_replay_stats_t *out_stats)
+{
+    RECORDER_RETURN_ON_FALSE(replay != NULL, "replay pointer is NULL", ESP_ERR_INVALID_ARG);
+    RECORDER_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    *out_stats = replay->stats;
+
+    return ESP_OK;
+}
@@ -0,0 +1,163 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_copy_internal.h"
+#include "beam_parser.h"
+#include "beam_ring.h"
+#include "esp_check.h"
+#include <string.h>
+
+static const char *TAG = "[BEAM_ring]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define RING_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/*
+ * Indices run freely and wrap at 2^32; head - tail is the fill level. Each side stores
+ * its own index with release semantics after touching the slot and loads the other
+ * side's index with acquire semantics before touching it.
+ */
+
+/**
+ * @brief Producer-side view of the next free slot, or NULL if the ring is full.
+ */
+static beam_frame_buf_t *free_slot(beam_ring_t *ring)
+{
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail > ring->mask) {
+        return NULL;
+    }
+
+    return &ring->slots[head & ring->mask];
+}
+
+/**
+ * @brief Consumer-side view of the oldest committed slot, or NULL if the ring is empty.
+ */
+static beam_frame_buf_t *used_slot(beam_ring_t *ring)
+{
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+        return NULL;
+    }
+
+    return &ring->slots[tail & ring->mask];
+}
+
+esp_err_t beam_ring_init(beam_ring_t *ring, beam_frame_buf_t *slots, size_t count)
+{
+    RING_RETURN_ON_FALSE(ring != NULL, "ring pointer is NULL", ESP_ERR_INVALID_ARG);
+    RING_RETURN_ON_FALSE(slots != NULL, "slots pointer is NULL", ESP_ERR_INVALID_ARG);
+    RING_RETURN_ON_FALSE(count >= 2 && count <= UINT32_MAX / 2 && (count & (count - 1)) == 0,
+                         "count must be a power of two >= 2",
+                         ESP_ERR_INVALID_ARG);
+
+    ring->slots = slots;
+    ring->mask = (uint32_t)count - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_ring_reserve(beam_ring_t *ring, beam_frame_buf_t **out_slot)
+{
+    RING_RETURN_ON_FALSE(ring != NULL, "ring pointer is NULL", ESP_ERR_INVALID_ARG);
+    RING_RETURN_ON_FALSE(out_slot != NULL, "out_slot pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    *out_slot = free_slot(ring);
+
+    return *out_slot != NULL ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t beam_ring_commit(beam_ring_t *ring)
+{
+    RING_RETURN_ON_FALSE(ring != NULL, "ring pointer is NULL", ESP_ERR_INVALID_ARG);
+    RING_RETURN_ON_FALSE(free_slot(ring) != NULL, "commit on a full ring", ESP_ERR_INVALID_STATE);
+
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_ring_push_frame(beam_ring_t *ring, const uint8_t *data, size_t data_len)
+{
+    RING_RETURN_ON_FALSE(ring != NULL, "ring pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    beam_frame_view_t view;
+    esp_err_t err = beam_parse_view(data, data_len, &view);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    beam_frame_buf_t *slot = free_slot(ring);
+    if (slot == NULL) {
+        ring->dropped++;
+        return ESP_ERR_NO_MEM;
+    }
+
+    beam_copy(slot->data, view.data, view.size);
+    slot->len = (uint16_t)view.size;
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+
+    return ESP_OK;
+}
+
+esp_err_t beam_ring_peek(beam_ring_t *ring, beam_frame_view_t *out_view)
+{
+    RING_RETURN_ON_FALSE(ring != NULL, "ring pointer is NULL", ESP_ERR_INVALID_ARG);
+    RING_RETURN_ON_FALSE(out_view != NULL, "out_view pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    const beam_frame_buf_t *slot = used_slot(ring);
+    if (slot == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    out_view->data = slot->data;
+    out_view->size = slot->len;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_ring_release(beam_ring_t *ring)
+{
+    RING_RETURN_ON_FALSE(ring != NULL, "ring pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    if (used_slot(ring) == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+
+    return ESP_OK;
+}
+
+size_t beam_ring_count(const beam_ring_t *ring)
+{
+    // Tail first: it can only be overtaken by a head read afterwards, never the other way round
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    return head - tail;
+}
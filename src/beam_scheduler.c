@@ -0,0 +1,232 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_scheduler.h"
+#include "esp_check.h"
+#include <string.h>
+
+#define FRAME_COST 1000000u /**< Credit one frame costs: one second of one frame per second */
+
+static const char *TAG = "[BEAM_scheduler]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define SCHED_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/**
+ * @brief Rate limit entry for category, or NULL if the category is not limited.
+ */
+static beam_rate_limit_t *find_limit(beam_scheduler_t *sched, beam_msg_category_t category)
+{
+    for (size_t i = 0; i < BEAM_SCHED_MAX_RATE_LIMITS; i++) {
+        if (sched->limits[i].frames_per_sec != 0 && sched->limits[i].category == category) {
+            return &sched->limits[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add the credit earned since the last refill, capped at the bucket depth.
+ */
+static void refill(beam_rate_limit_t *limit, int64_t now_us)
+{
+    uint64_t cap = (uint64_t)limit->burst * FRAME_COST;
+    uint64_t elapsed_us = now_us > limit->last_us ? (uint64_t)(now_us - limit->last_us) : 0;
+
+    limit->last_us = now_us;
+    if (elapsed_us >= cap) {
+        limit->credit = cap; // Avoids overflow after long idle periods; any rate >= 1 refills fully
+        return;
+    }
+
+    limit->credit += elapsed_us * limit->frames_per_sec;
+    if (limit->credit > cap) {
+        limit->credit = cap;
+    }
+}
+
+/**
+ * @brief Check whether the head of ring may be sent now.
+ *
+ * @param sched Scheduler.
+ * @param ring Queue to look at.
+ * @param now_us Current time.
+ * @param[out] out_view Receives the head frame.
+ * @param[out] out_limit Receives the head's rate limit, or NULL.
+ *
+ * @return true if the queue has a frame and its category has credit.
+ */
+static bool head_eligible(beam_scheduler_t *sched,
+                          beam_ring_t *ring,
+                          int64_t now_us,
+                          beam_frame_view_t *out_view,
+                          beam_rate_limit_t **out_limit)
+{
+    if (beam_ring_peek(ring, out_view) != ESP_OK) {
+        return false;
+    }
+
+    *out_limit = find_limit(sched, beam_frame_view_category(out_view));
+    if (*out_limit == NULL) {
+        return true;
+    }
+
+    refill(*out_limit, now_us);
+    if ((*out_limit)->credit < FRAME_COST) {
+        sched->stats.throttled++;
+        return false;
+    }
+
+    return true;
+}
+
+esp_err_t beam_scheduler_init(beam_scheduler_t *sched,
+                              beam_frame_buf_t *priority_slots,
+                              size_t priority_count,
+                              beam_frame_buf_t *bulk_slots,
+                              size_t bulk_count,
+                              beam_sched_send_cb_t send,
+                              void *ctx)
+{
+    SCHED_RETURN_ON_FALSE(sched != NULL, "sched pointer is NULL", ESP_ERR_INVALID_ARG);
+    SCHED_RETURN_ON_FALSE(send != NULL, "send pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(sched, 0, sizeof(*sched));
+
+    esp_err_t err = beam_ring_init(&sched->priority, priority_slots, priority_count);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = beam_ring_init(&sched->bulk, bulk_slots, bulk_count);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    sched->send = send;
+    sched->ctx = ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_scheduler_enqueue(beam_scheduler_t *sched, const uint8_t *frame, size_t frame_len)
+{
+    SCHED_RETURN_ON_FALSE(sched != NULL, "sched pointer is NULL", ESP_ERR_INVALID_ARG);
+    SCHED_RETURN_ON_FALSE(frame != NULL, "frame pointer is NULL", ESP_ERR_INVALID_ARG);
+    SCHED_RETURN_ON_FALSE(frame_len >= FRAME_MIN_SIZE && frame_len <= FRAME_MAX_SIZE,
+                          "frame_len outside [FRAME_MIN_SIZE, FRAME_MAX_SIZE]",
+                          ESP_ERR_INVALID_SIZE);
+
+    bool priority = (frame[FRAME_OFFSET_FLAGS] & MSG_FLAG_PRIORITY) != 0;
+    beam_ring_t *ring = priority ? &sched->priority : &sched->bulk;
+
+    beam_frame_buf_t *slot = NULL;
+    if (beam_ring_reserve(ring, &slot) != ESP_OK) {
+        if (priority) {
+            sched->stats.dropped_priority++;
+        }
+        else {
+            sched->stats.dropped_bulk++;
+        }
+        return ESP_ERR_NO_MEM;
+    }
+
+    memcpy(slot->data, frame, frame_len);
+    slot->len = (uint16_t)frame_len;
+
+    return beam_ring_commit(ring);
+}
+
+esp_err_t beam_scheduler_set_rate(beam_scheduler_t *sched,
+                                  beam_msg_category_t category,
+                                  uint16_t frames_per_sec,
+                                  uint8_t burst,
+                                  int64_t now_us)
+{
+    SCHED_RETURN_ON_FALSE(sched != NULL, "sched pointer is NULL", ESP_ERR_INVALID_ARG);
+    SCHED_RETURN_ON_FALSE(frames_per_sec == 0 || burst > 0, "burst must be at least 1", ESP_ERR_INVALID_ARG);
+
+    beam_rate_limit_t *limit = find_limit(sched, category);
+    if (frames_per_sec == 0) {
+        if (limit != NULL) {
+            limit->frames_per_sec = 0;
+        }
+        return ESP_OK;
+    }
+
+    for (size_t i = 0; i < BEAM_SCHED_MAX_RATE_LIMITS && limit == NULL; i++) {
+        if (sched->limits[i].frames_per_sec == 0) {
+            limit = &sched->limits[i];
+        }
+    }
+    SCHED_RETURN_ON_FALSE(limit != NULL, "no free rate limit entry", ESP_ERR_NO_MEM);
+
+    limit->category = category;
+    limit->frames_per_sec = frames_per_sec;
+    limit->burst = burst;
+    limit->credit = (uint64_t)burst * FRAME_COST;
+    limit->last_us = now_us;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_scheduler_run(beam_scheduler_t *sched, int64_t now_us)
+{
+    SCHED_RETURN_ON_FALSE(sched != NULL, "sched pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    if (__atomic_load_n(&sched->in_flight, __ATOMIC_ACQUIRE)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    beam_frame_view_t view;
+    beam_rate_limit_t *limit = NULL;
+    beam_ring_t *ring = &sched->priority;
+    if (!head_eligible(sched, ring, now_us, &view, &limit)) {
+        ring = &sched->bulk;
+        if (!head_eligible(sched, ring, now_us, &view, &limit)) {
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+
+    // Set before sending: the completion callback may run before send() returns
+    __atomic_store_n(&sched->in_flight, 1, __ATOMIC_RELEASE);
+    esp_err_t err = sched->send(view.data, view.size, sched->ctx);
+    if (err != ESP_OK) {
+        __atomic_store_n(&sched->in_flight, 0, __ATOMIC_RELEASE);
+        sched->stats.send_errors++;
+        return err;
+    }
+
+    beam_ring_release(ring);
+    if (limit != NULL) {
+        limit->credit -= FRAME_COST;
+    }
+    sched->stats.sent++;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_scheduler_on_send_done(beam_scheduler_t *sched)
+{
+    SCHED_RETURN_ON_FALSE(sched != NULL, "sched pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    __atomic_store_n(&sched->in_flight, 0, __ATOMIC_RELEASE);
+
+    return ESP_OK;
+}
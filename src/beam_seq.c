@@ -0,0 +1,196 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_seq.h"
+#include "esp_check.h"
+#include <string.h>
+
+static const char *TAG = "[BEAM_seq]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define SEQ_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/**
+ * @brief Classify seq against the window and update state. Caller must ensure non-NULL state.
+ *
+ * @param state Peer sequence state.
+ * @param seq Received sequence number.
+ * @param[out] out_gap Receives the number of skipped sequence numbers.
+ *
+ * @return Classification of seq.
+ */
+static beam_seq_result_t seq_update(beam_seq_state_t *state, uint8_t seq, uint8_t *out_gap)
+{
+    *out_gap = 0;
+    state->stats.received++;
+
+    if (!state->started) {
+        state->started = true;
+        state->newest = seq;
+        state->window = 1;
+        return BEAM_SEQ_NEW;
+    }
+
+    // Signed distance modulo 256: 1..127 ahead, 0 same, -128..-1 behind
+    int distance = (int8_t)(uint8_t)(seq - state->newest);
+
+    if (distance > 0) {
+        uint8_t gap = (uint8_t)(distance - 1);
+        state->window = (uint32_t)distance < BEAM_SEQ_WINDOW_SIZE ? (state->window << distance) | 1u : 1u;
+        state->newest = seq;
+        state->stats.lost += gap;
+        *out_gap = gap;
+        return gap == 0 ? BEAM_SEQ_NEW : BEAM_SEQ_GAP;
+    }
+
+    uint32_t age = (uint32_t)-distance;
+    if (age >= BEAM_SEQ_WINDOW_SIZE || (state->window & (1u << age))) {
+        state->stats.duplicates++;
+        return BEAM_SEQ_DUPLICATE;
+    }
+
+    state->window |= 1u << age;
+    state->stats.reordered++;
+    if (state->stats.lost > 0) {
+        state->stats.lost--;
+    }
+
+    return BEAM_SEQ_OUT_OF_ORDER;
+}
+
+/**
+ * @brief Find the tracker entry for mac. Caller must ensure non-NULL arguments.
+ *
+ * @return Index of the entry, or tracker->count if the peer is not tracked.
+ */
+static uint8_t find_peer(const beam_seq_tracker_t *tracker, const uint8_t *mac)
+{
+    uint8_t i = 0;
+    while (i < tracker->count && memcmp(tracker->peers[i].mac, mac, BEAM_MAC_LEN) != 0) {
+        i++;
+    }
+
+    return i;
+}
+
+esp_err_t beam_seq_init(beam_seq_state_t *state)
+{
+    SEQ_RETURN_ON_FALSE(state != NULL, "state pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(state, 0, sizeof(*state));
+
+    return ESP_OK;
+}
+
+esp_err_t beam_seq_update(beam_seq_state_t *state, uint8_t seq, beam_seq_result_t *out_result, uint8_t *out_gap)
+{
+    SEQ_RETURN_ON_FALSE(state != NULL, "state pointer is NULL", ESP_ERR_INVALID_ARG);
+    SEQ_RETURN_ON_FALSE(out_result != NULL, "out_result pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t gap = 0;
+    *out_result = seq_update(state, seq, &gap);
+    if (out_gap != NULL) {
+        *out_gap = gap;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_seq_tracker_init(beam_seq_tracker_t *tracker)
+{
+    SEQ_RETURN_ON_FALSE(tracker != NULL, "tracker pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    tracker->count = 0;
+    tracker->rejected = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_seq_tracker_update(beam_seq_tracker_t *tracker,
+                                  const uint8_t *mac,
+                                  uint8_t seq,
+                                  beam_seq_result_t *out_result,
+                                  uint8_t *out_gap)
+{
+    SEQ_RETURN_ON_FALSE(tracker != NULL, "tracker pointer is NULL", ESP_ERR_INVALID_ARG);
+    SEQ_RETURN_ON_FALSE(mac != NULL, "mac pointer is NULL", ESP_ERR_INVALID_ARG);
+    SEQ_RETURN_ON_FALSE(out_result != NULL, "out_result pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t index = find_peer(tracker, mac);
+    if (index == tracker->count) {
+        // Not logged: runs per frame in the receive callback
+        if (tracker->count == BEAM_SEQ_MAX_PEERS) {
+            tracker->rejected++;
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(tracker->peers[index].mac, mac, BEAM_MAC_LEN);
+        memset(&tracker->peers[index].state, 0, sizeof(tracker->peers[index].state));
+        tracker->count++;
+    }
+
+    uint8_t gap = 0;
+    *out_result = seq_update(&tracker->peers[index].state, seq, &gap);
+    if (out_gap != NULL) {
+        *out_gap = gap;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_seq_tracker_get_stats(const beam_seq_tracker_t *tracker, const uint8_t *mac, beam_seq_stats_t *out_stats)
+{
+    SEQ_RETURN_ON_FALSE(tracker != NULL, "tracker pointer is NULL", ESP_ERR_INVALID_ARG);
+    SEQ_RETURN_ON_FALSE(mac != NULL, "mac pointer is NULL", ESP_ERR_INVALID_ARG);
+    SEQ_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t index = find_peer(tracker, mac);
+    if (index == tracker->count) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *out_stats = tracker->peers[index].state.stats;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_seq_tracker_get_rejected(const beam_seq_tracker_t *tracker, uint32_t *out_rejected)
+{
+    SEQ_RETURN_ON_FALSE(tracker != NULL, "tracker pointer is NULL", ESP_ERR_INVALID_ARG);
+    SEQ_RETURN_ON_FALSE(out_rejected != NULL, "out_rejected pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    *out_rejected = tracker->rejected;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_seq_tracker_remove(beam_seq_tracker_t *tracker, const uint8_t *mac)
+{
+    SEQ_RETURN_ON_FALSE(tracker != NULL, "tracker pointer is NULL", ESP_ERR_INVALID_ARG);
+    SEQ_RETURN_ON_FALSE(mac != NULL, "mac pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    uint8_t index = find_peer(tracker, mac);
+    if (index == tracker->count) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Keep [0, count) dense by moving the last entry into the hole
+    tracker->count--;
+    tracker->peers[index] = tracker->peers[tracker->count];
+
+    return ESP_OK;
+}
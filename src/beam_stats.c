@@ -0,0 +1,140 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_stats.h"
+#include "beam_stats_internal.h"
+#include "esp_check.h"
+#include <assert.h>
+#include <string.h>
+
+static const char *TAG = "[BEAM_stats]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define STATS_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+#if CONFIG_BEAM_STATS
+
+beam_stats_counters_t beam_stats_counters = {.parse_cycles_min = UINT32_MAX,
+                                              .total_lock = portMUX_INITIALIZER_UNLOCKED};
+
+static uint32_t load(const uint32_t *counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+static void clear(uint32_t *counter, uint32_t value)
+{
+    __atomic_store_n(counter, value, __ATOMIC_RELAXED);
+}
+
+esp_err_t beam_stats_get(beam_stats_t *out_stats)
+{
+    STATS_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    beam_stats_counters_t *c = &beam_stats_counters;
+
+    out_stats->frames_parsed = load(&c->frames_parsed);
+    out_stats->bytes_parsed = load(&c->bytes_parsed);
+    out_stats->frames_serialized = load(&c->frames_serialized);
+    out_stats->bytes_serialized = load(&c->bytes_serialized);
+    out_stats->invalid_size = load(&c->invalid_size);
+    out_stats->invalid_crc = load(&c->invalid_crc);
+    out_stats->parse_cycles_max = load(&c->parse_cycles_max);
+
+    uint32_t min = load(&c->parse_cycles_min);
+    portENTER_CRITICAL_SAFE(&c->total_lock);
+    uint64_t total = c->parse_cycles_total;
+    portEXIT_CRITICAL_SAFE(&c->total_lock);
+    out_stats->parse_cycles_min = min == UINT32_MAX ? 0 : min;
+    out_stats->parse_cycles_avg = out_stats->frames_parsed == 0 ? 0 : (uint32_t)(total / out_stats->frames_parsed);
+
+    for (size_t i = 0; i < BEAM_STATS_CATEGORY_COUNT; i++) {
+        out_stats->per_category[i] = load(&c->per_category[i]);
+    }
+
+    return ESP_OK;
+}
+
+void beam_stats_reset(void)
+{
+    beam_stats_counters_t *c = &beam_stats_counters;
+
+    clear(&c->frames_parsed, 0);
+    clear(&c->bytes_parsed, 0);
+    clear(&c->frames_serialized, 0);
+    clear(&c->bytes_serialized, 0);
+    clear(&c->invalid_size, 0);
+    clear(&c->invalid_crc, 0);
+    clear(&c->parse_cycles_min, UINT32_MAX);
+    clear(&c->parse_cycles_max, 0);
+    portENTER_CRITICAL_SAFE(&c->total_lock);
+    c->parse_cycles_total = 0;
+    portEXIT_CRITICAL_SAFE(&c->total_lock);
+
+    for (size_t i = 0; i < BEAM_STATS_CATEGORY_COUNT; i++) {
+        clear(&c->per_category[i], 0);
+    }
+}
+
+#else
+
+esp_err_t beam_stats_get(beam_stats_t *out_stats)
+{
+    STATS_RETURN_ON_FALSE(out_stats != NULL, "out_stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(out_stats, 0, sizeof(*out_stats));
+
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void beam_stats_reset(void)
+{
+}
+
+#endif /* CONFIG_BEAM_STATS */
+
+esp_err_t beam_stats_put_summary(beam_frame_builder_t *builder, const beam_stats_t *stats)
+{
+    STATS_RETURN_ON_FALSE(builder != NULL, "builder pointer is NULL", ESP_ERR_INVALID_ARG);
+    STATS_RETURN_ON_FALSE(stats != NULL, "stats pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    const uint32_t fields[] = {
+        stats->frames_parsed,
+        stats->bytes_parsed,
+        stats->frames_serialized,
+        stats->bytes_serialized,
+        stats->invalid_size,
+        stats->invalid_crc,
+        stats->parse_cycles_min,
+        stats->parse_cycles_avg,
+        stats->parse_cycles_max,
+    };
+    static_assert(sizeof(fields) == BEAM_STATS_SUMMARY_SIZE, "summary layout out of sync with beam_stats_t");
+
+    // Staged so a frame without room for the whole summary is left untouched
+    uint8_t summary[BEAM_STATS_SUMMARY_SIZE];
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        summary[i * 4 + 0] = (uint8_t)(fields[i] & 0xFF);
+        summary[i * 4 + 1] = (uint8_t)((fields[i] >> 8) & 0xFF);
+        summary[i * 4 + 2] = (uint8_t)((fields[i] >> 16) & 0xFF);
+        summary[i * 4 + 3] = (uint8_t)((fields[i] >> 24) & 0xFF);
+    }
+
+    return beam_frame_put_bytes(builder, summary, sizeof(summary));
+}
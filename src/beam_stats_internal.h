@@ -0,0 +1,190 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#ifndef BEAM_STATS_INTERNAL_H
+#define BEAM_STATS_INTERNAL_H
+
+#include "beam_stats.h"
+#include "esp_cpu.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Recording hooks for the parser and serializer. They compile to nothing without
+ * CONFIG_BEAM_STATS, so call sites need no #if.
+ */
+
+#if CONFIG_BEAM_STATS
+
+/**
+ * @brief Live counters behind beam_stats_get(), defined in beam_stats.c.
+ */
+typedef struct beam_stats_counters {
+    uint32_t frames_parsed;
+    uint32_t bytes_parsed;
+    uint32_t frames_serialized;
+    uint32_t bytes_serialized;
+    uint32_t invalid_size;
+    uint32_t invalid_crc;
+    uint32_t parse_cycles_min; ///< UINT32_MAX until the first frame
+    uint32_t parse_cycles_max;
+    uint64_t parse_cycles_total; ///< Guarded by total_lock: 32-bit targets cannot read it in one load
+    uint32_t per_category[BEAM_STATS_CATEGORY_COUNT];
+    portMUX_TYPE total_lock; ///< Serializes writers and readers of parse_cycles_total
+} beam_stats_counters_t;
+
+extern beam_stats_counters_t beam_stats_counters;
+
+static inline void stats_add(uint32_t *counter, uint32_t value)
+{
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Cycle counter at the start of a parse, for stats_record_parse().
+ */
+static inline uint32_t stats_parse_begin(void)
+{
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+/**
+ * @brief Count a frame of msg_category category in per_category.
+ */
+static inline void stats_record_category(uint8_t category)
+{
+    stats_add(&beam_stats_counters.per_category[category], 1);
+}
+
+/**
+ * @brief Count frames accepted frames of bytes wire bytes in total whose parse began at start.
+ *
+ * The min and max see the mean per frame. Per-category counts are left to the caller.
+ */
+static inline void stats_record_parsed(uint32_t frames, uint32_t bytes, uint32_t start)
+{
+    uint32_t cycles = (uint32_t)esp_cpu_get_cycle_count() - start;
+    beam_stats_counters_t *c = &beam_stats_counters;
+
+    stats_add(&c->frames_parsed, frames);
+    stats_add(&c->bytes_parsed, bytes);
+    portENTER_CRITICAL_SAFE(&c->total_lock);
+    c->parse_cycles_total += cycles;
+    portEXIT_CRITICAL_SAFE(&c->total_lock);
+
+    uint32_t mean = cycles / frames;
+    uint32_t seen = __atomic_load_n(&c->parse_cycles_min, __ATOMIC_RELAXED);
+    while (mean < seen &&
+           !__atomic_compare_exchange_n(&c->parse_cycles_min, &seen, mean, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    seen = __atomic_load_n(&c->parse_cycles_max, __ATOMIC_RELAXED);
+    while (mean > seen &&
+           !__atomic_compare_exchange_n(&c->parse_cycles_max, &seen, mean, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief Count an accepted frame of frame_size wire bytes whose parse began at start.
+ */
+static inline void stats_record_parse(uint8_t category, size_t frame_size, uint32_t start)
+{
+    stats_record_category(category);
+    stats_record_parsed(1, (uint32_t)frame_size, start);
+}
+
+/**
+ * @brief Count invalid_size and invalid_crc rejected frames at once.
+ */
+static inline void stats_record_errors(uint32_t invalid_size, uint32_t invalid_crc)
+{
+    if (invalid_size != 0) {
+        stats_add(&beam_stats_counters.invalid_size, invalid_size);
+    }
+    if (invalid_crc != 0) {
+        stats_add(&beam_stats_counters.invalid_crc, invalid_crc);
+    }
+}
+
+/**
+ * @brief Count a frame rejected with err. Codes other than size and CRC are ignored.
+ */
+static inline void stats_record_error(esp_err_t err)
+{
+    if (err == ESP_ERR_INVALID_SIZE) {
+        stats_add(&beam_stats_counters.invalid_size, 1);
+    }
+    else if (err == ESP_ERR_INVALID_CRC) {
+        stats_add(&beam_stats_counters.invalid_crc, 1);
+    }
+}
+
+/**
+ * @brief Count a written frame of frame_size wire bytes.
+ */
+static inline void stats_record_serialize(size_t frame_size)
+{
+    stats_add(&beam_stats_counters.frames_serialized, 1);
+    stats_add(&beam_stats_counters.bytes_serialized, (uint32_t)frame_size);
+}
+
+#else
+
+static inline uint32_t stats_parse_begin(void)
+{
+    return 0;
+}
+
+static inline void stats_record_category(uint8_t category)
+{
+    (void)category;
+}
+
+static inline void stats_record_parsed(uint32_t frames, uint32_t bytes, uint32_t start)
+{
+    (void)frames;
+    (void)bytes;
+    (void)start;
+}
+
+static inline void stats_record_parse(uint8_t category, size_t frame_size, uint32_t start)
+{
+    (void)category;
+    (void)frame_size;
+    (void)start;
+}
+
+static inline void stats_record_errors(uint32_t invalid_size, uint32_t invalid_crc)
+{
+    (void)invalid_size;
+    (void)invalid_crc;
+}
+
+static inline void stats_record_error(esp_err_t err)
+{
+    (void)err;
+}
+
+static inline void stats_record_serialize(size_t frame_size)
+{
+    (void)frame_size;
+}
+
+#endif /* CONFIG_BEAM_STATS */
+
+#endif /* BEAM_STATS_INTERNAL_H */
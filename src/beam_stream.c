@@ -0,0 +1,340 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_frame_internal.h"
+#include "beam_stream.h"
+#include "esp_check.h"
+#include <string.h>
+
+static const char *TAG = "[BEAM_stream]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define STREAM_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+#define COBS_MAX_CODE 0xFFu /**< COBS code for a 254-byte run without a zero */
+
+/**
+ * @brief Hand a complete, validated frame at the start of buf to the callback.
+ */
+static void emit_frame(beam_stream_decoder_t *decoder, size_t frame_size)
+{
+    beam_frame_view_t view = {
+        .data = decoder->buf,
+        .size = frame_size,
+    };
+
+    decoder->stats.frames++;
+    decoder->on_frame(&view, decoder->ctx);
+}
+
+/**
+ * @brief Sync mode: restart the candidate at the first sync byte in buf[from..fill).
+ *
+ * Bytes after that sync byte become the new candidate frame; bytes before it are
+ * discarded. If there is none, the decoder goes back to hunting in the input.
+ */
+static void sync_rehunt(beam_stream_decoder_t *decoder, size_t from)
+{
+    size_t k = from;
+    while (k < decoder->fill && decoder->buf[k] != BEAM_STREAM_SYNC_BYTE) {
+        k++;
+    }
+    decoder->stats.discarded_bytes += (uint32_t)(k - from);
+
+    if (k == decoder->fill) {
+        decoder->fill = 0;
+        decoder->synced = false;
+        return;
+    }
+
+    decoder->fill -= k + 1;
+    memmove(decoder->buf, decoder->buf + k + 1, decoder->fill);
+    decoder->crc_pos = 0;
+    beam_crc_init(&decoder->crc);
+}
+
+/**
+ * @brief Sync mode: check the buffered candidate and emit or reject it once complete.
+ *
+ * Loops because rejecting a candidate may expose another, already buffered one.
+ */
+static void sync_process(beam_stream_decoder_t *decoder)
+{
+    while (decoder->synced && decoder->fill >= FRAME_HEADER_SIZE) {
+        uint8_t len = decoder->buf[FRAME_OFFSET_LEN];
+        if (!frame_len_valid(decoder->buf[FRAME_OFFSET_FLAGS], len)) {
+            decoder->stats.size_errors++;
+            sync_rehunt(decoder, 0);
+            continue;
+        }
+
+        // Checksum bytes as they arrive, so completing a frame only costs the compare
+        size_t crc_end = FRAME_HEADER_SIZE + len;
+        if (crc_end > decoder->fill) {
+            crc_end = decoder->fill;
+        }
+        if (decoder->crc_pos < crc_end) {
+            beam_crc_update(&decoder->crc, decoder->buf + decoder->crc_pos, crc_end - decoder->crc_pos);
+            decoder->crc_pos = crc_end;
+        }
+
+        size_t frame_size = FRAME_SIZE(len);
+        if (decoder->fill < frame_size) {
+            return;
+        }
+
+        if (beam_crc_final(&decoder->crc) == frame_read_crc(decoder->buf + FRAME_HEADER_SIZE + len)) {
+            emit_frame(decoder, frame_size);
+            sync_rehunt(decoder, frame_size);
+        }
+        else {
+            decoder->stats.crc_errors++;
+            sync_rehunt(decoder, 0);
+        }
+    }
+}
+
+/**
+ * @brief Sync mode: consume input, copying at most the bytes the current candidate still needs.
+ */
+static void sync_feed(beam_stream_decoder_t *decoder, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        if (!decoder->synced) {
+            const uint8_t *sync = memchr(data, BEAM_STREAM_SYNC_BYTE, len);
+            if (sync == NULL) {
+                decoder->stats.discarded_bytes += (uint32_t)len;
+                return;
+            }
+
+            size_t skipped = (size_t)(sync - data);
+            decoder->stats.discarded_bytes += (uint32_t)skipped;
+            data += skipped + 1;
+            len -= skipped + 1;
+
+            decoder->synced = true;
+            decoder->fill = 0;
+            decoder->crc_pos = 0;
+            beam_crc_init(&decoder->crc);
+            continue;
+        }
+
+        size_t need = decoder->fill < FRAME_HEADER_SIZE ? FRAME_HEADER_SIZE - decoder->fill
+                                                        : FRAME_SIZE(decoder->buf[FRAME_OFFSET_LEN]) - decoder->fill;
+        size_t n = len < need ? len : need;
+        memcpy(decoder->buf + decoder->fill, data, n);
+        decoder->fill += n;
+        data += n;
+        len -= n;
+
+        sync_process(decoder);
+    }
+}
+
+/**
+ * @brief COBS mode: decode the buffered frame in place and emit it if valid.
+ */
+static void cobs_process(beam_stream_decoder_t *decoder)
+{
+    uint8_t *buf = decoder->buf;
+    size_t read = 0;
+    size_t written = 0;
+
+    while (read < decoder->fill) {
+        uint8_t code = buf[read++];
+        size_t run = (size_t)code - 1u;
+        if (code == 0 || read + run > decoder->fill) {
+            decoder->stats.size_errors++;
+            return;
+        }
+
+        memmove(buf + written, buf + read, run);
+        written += run;
+        read += run;
+        if (code != COBS_MAX_CODE && read < decoder->fill) {
+            buf[written++] = 0;
+        }
+    }
+
+    if (written < FRAME_MIN_SIZE || !frame_len_valid(buf[FRAME_OFFSET_FLAGS], buf[FRAME_OFFSET_LEN]) ||
+        written != FRAME_SIZE(buf[FRAME_OFFSET_LEN])) {
+        decoder->stats.size_errors++;
+        return;
+    }
+
+    uint8_t len = buf[FRAME_OFFSET_LEN];
+    if (frame_crc(buf, FRAME_HEADER_SIZE + len) != frame_read_crc(buf + FRAME_HEADER_SIZE + len)) {
+        decoder->stats.crc_errors++;
+        return;
+    }
+
+    emit_frame(decoder, written);
+}
+
+/**
+ * @brief COBS mode: collect bytes up to each delimiter; oversized frames are skipped whole.
+ */
+static void cobs_feed(beam_stream_decoder_t *decoder, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        const uint8_t *delimiter = memchr(data, BEAM_STREAM_COBS_DELIMITER, len);
+        size_t segment = delimiter != NULL ? (size_t)(delimiter - data) : len;
+
+        if (decoder->overflow) {
+            decoder->stats.discarded_bytes += (uint32_t)segment;
+        }
+        else if (decoder->fill + segment > sizeof(decoder->buf)) {
+            decoder->stats.size_errors++;
+            decoder->stats.discarded_bytes += (uint32_t)(decoder->fill + segment);
+            decoder->overflow = true;
+            decoder->fill = 0;
+        }
+        else {
+            memcpy(decoder->buf + decoder->fill, data, segment);
+            decoder->fill += segment;
+        }
+        data += segment;
+        len -= segment;
+
+        if (delimiter != NULL) {
+            data++;
+            len--;
+            if (!decoder->overflow && decoder->fill > 0) {
+                cobs_process(decoder);
+            }
+            decoder->overflow = false;
+            decoder->fill = 0;
+        }
+    }
+}
+
+/**
+ * @brief COBS-encode frame into out_buffer and append the delimiter. Caller ensures capacity.
+ *
+ * @return Number of bytes written.
+ */
+static size_t cobs_encode(const uint8_t *frame, size_t frame_len, uint8_t *out_buffer)
+{
+    size_t code_pos = 0;
+    size_t written = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < frame_len; i++) {
+        if (frame[i] == 0) {
+            out_buffer[code_pos] = code;
+            code_pos = written++;
+            code = 1;
+            continue;
+        }
+
+        out_buffer[written++] = frame[i];
+        if (++code == COBS_MAX_CODE) {
+            out_buffer[code_pos] = code;
+            code_pos = written++;
+            code = 1;
+        }
+    }
+    out_buffer[code_pos] = code;
+    out_buffer[written++] = BEAM_STREAM_COBS_DELIMITER;
+
+    return written;
+}
+
+esp_err_t beam_stream_decoder_init(beam_stream_decoder_t *decoder,
+                                   beam_stream_mode_t mode,
+                                   beam_stream_frame_cb_t on_frame,
+                                   void *ctx)
+{
+    STREAM_RETURN_ON_FALSE(decoder != NULL, "decoder pointer is NULL", ESP_ERR_INVALID_ARG);
+    STREAM_RETURN_ON_FALSE(on_frame != NULL, "on_frame pointer is NULL", ESP_ERR_INVALID_ARG);
+    STREAM_RETURN_ON_FALSE(mode == BEAM_STREAM_MODE_SYNC || mode == BEAM_STREAM_MODE_COBS,
+                           "unknown stream mode",
+                           ESP_ERR_INVALID_ARG);
+
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->mode = mode;
+    decoder->on_frame = on_frame;
+    decoder->ctx = ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_stream_decoder_feed(beam_stream_decoder_t *decoder, const uint8_t *data, size_t len)
+{
+    STREAM_RETURN_ON_FALSE(decoder != NULL, "decoder pointer is NULL", ESP_ERR_INVALID_ARG);
+    STREAM_RETURN_ON_FALSE(data != NULL || len == 0, "data pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    if (decoder->mode == BEAM_STREAM_MODE_COBS) {
+        cobs_feed(decoder, data, len);
+    }
+    else {
+        sync_feed(decoder, data, len);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t beam_stream_decoder_reset(beam_stream_decoder_t *decoder)
+{
+    STREAM_RETURN_ON_FALSE(decoder != NULL, "decoder pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    decoder->fill = 0;
+    decoder->synced = false;
+    decoder->overflow = false;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_stream_encode(beam_stream_mode_t mode,
+                             const uint8_t *frame,
+                             size_t frame_len,
+                             uint8_t *out_buffer,
+                             size_t buffer_size,
+                             size_t *out_size)
+{
+    STREAM_RETURN_ON_FALSE(frame != NULL, "frame pointer is NULL", ESP_ERR_INVALID_ARG);
+    STREAM_RETURN_ON_FALSE(out_buffer != NULL, "out_buffer pointer is NULL", ESP_ERR_INVALID_ARG);
+    STREAM_RETURN_ON_FALSE(frame_len >= FRAME_MIN_SIZE && frame_len <= FRAME_MAX_SIZE,
+                           "frame_len outside FRAME_MIN_SIZE..FRAME_MAX_SIZE",
+                           ESP_ERR_INVALID_SIZE);
+
+    size_t written = 0;
+    switch (mode) {
+    case BEAM_STREAM_MODE_SYNC:
+        STREAM_RETURN_ON_FALSE(buffer_size >= frame_len + 1, "buffer_size too small for frame", ESP_ERR_INVALID_SIZE);
+        out_buffer[0] = BEAM_STREAM_SYNC_BYTE;
+        memcpy(out_buffer + 1, frame, frame_len);
+        written = frame_len + 1;
+        break;
+    case BEAM_STREAM_MODE_COBS:
+        STREAM_RETURN_ON_FALSE(buffer_size >= BEAM_STREAM_COBS_SIZE(frame_len),
+                               "buffer_size too small for encoded frame",
+                               ESP_ERR_INVALID_SIZE);
+        written = cobs_encode(frame, frame_len, out_buffer);
+        break;
+    default:
+        STREAM_RETURN_ON_FALSE(false, "unknown stream mode", ESP_ERR_INVALID_ARG);
+    }
+
+    if (out_size != NULL) {
+        *out_size = written;
+    }
+
+    return ESP_OK;
+}
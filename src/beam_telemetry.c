@@ -0,0 +1,209 @@
+/*
+ Copyright 2026 Ivan Somov
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+      https://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#include "beam_telemetry.h"
+#include "esp_check.h"
+#include <math.h>
+#include <string.h>
+
+#define AXIS_COUNT 3 /**< roll, pitch, yaw */
+
+static const char *TAG = "[BEAM_telemetry]";
+
+/**
+ * If condition is false, log msg and return ret_val.
+ * Pass the condition that must hold to continue (true = do not return).
+ */
+#define TELEMETRY_RETURN_ON_FALSE(condition, msg, ret_val) ESP_RETURN_ON_FALSE(condition, ret_val, TAG, "%s", msg)
+
+/**
+ * @brief Quantize an angle to fixed point, saturating at the int16 range (NaN maps to 0).
+ */
+static int16_t quantize(float angle)
+{
+    float scaled = roundf(angle * (float)BEAM_TELEMETRY_COMPACT_SCALE);
+
+    if (scaled >= (float)INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (scaled <= (float)INT16_MIN) {
+        return INT16_MIN;
+    }
+    if (scaled != scaled) {
+        return 0;
+    }
+
+    return (int16_t)scaled;
+}
+
+/**
+ * @brief Convert fixed-point angles back to a float sample.
+ */
+static void to_telemetry(const int16_t q[AXIS_COUNT], beam_payload_telemetry_t *out)
+{
+    out->roll = (float)q[0] / (float)BEAM_TELEMETRY_COMPACT_SCALE;
+    out->pitch = (float)q[1] / (float)BEAM_TELEMETRY_COMPACT_SCALE;
+    out->yaw = (float)q[2] / (float)BEAM_TELEMETRY_COMPACT_SCALE;
+}
+
+/**
+ * @brief Read the three little-endian int16 angles that follow the key id of a keyframe payload.
+ */
+static void read_keyframe(const uint8_t *payload, int16_t q[AXIS_COUNT])
+{
+    for (int i = 0; i < AXIS_COUNT; i++) {
+        q[i] = (int16_t)(payload[1 + 2 * i] | (payload[2 + 2 * i] << 8));
+    }
+}
+
+esp_err_t beam_telemetry_encoder_init(beam_telemetry_encoder_t *encoder)
+{
+    TELEMETRY_RETURN_ON_FALSE(encoder != NULL, "encoder pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(encoder, 0, sizeof(*encoder));
+
+    return ESP_OK;
+}
+
+esp_err_t beam_telemetry_encode(beam_telemetry_encoder_t *encoder,
+                                const beam_payload_telemetry_t *telemetry,
+                                uint8_t *out_payload,
+                                uint8_t *out_len,
+                                beam_flags_t *out_flags)
+{
+    TELEMETRY_RETURN_ON_FALSE(encoder != NULL, "encoder pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(telemetry != NULL, "telemetry pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(out_payload != NULL, "out_payload pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(out_len != NULL, "out_len pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(out_flags != NULL, "out_flags pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    int16_t q[AXIS_COUNT] = {quantize(telemetry->roll), quantize(telemetry->pitch), quantize(telemetry->yaw)};
+    int delta[AXIS_COUNT] = {0};
+
+    bool use_delta = encoder->has_key && encoder->since_key < BEAM_TELEMETRY_KEYFRAME_INTERVAL;
+    for (int i = 0; use_delta && i < AXIS_COUNT; i++) {
+        delta[i] = q[i] - encoder->key[i];
+        use_delta = delta[i] >= INT8_MIN && delta[i] <= INT8_MAX;
+    }
+
+    if (use_delta) {
+        out_payload[0] = encoder->key_id;
+        for (int i = 0; i < AXIS_COUNT; i++) {
+            out_payload[1 + i] = (uint8_t)(int8_t)delta[i];
+        }
+        encoder->since_key++;
+        *out_len = BEAM_TELEMETRY_DELTA_SIZE;
+        *out_flags = MSG_FLAG_COMPACT | MSG_FLAG_DELTA;
+        return ESP_OK;
+    }
+
+    if (encoder->has_key) {
+        encoder->key_id++;
+    }
+    out_payload[0] = encoder->key_id;
+    for (int i = 0; i < AXIS_COUNT; i++) {
+        out_payload[1 + 2 * i] = (uint8_t)((uint16_t)q[i] & 0xFF);
+        out_payload[2 + 2 * i] = (uint8_t)((uint16_t)q[i] >> 8);
+        encoder->key[i] = q[i];
+    }
+    encoder->since_key = 1;
+    encoder->has_key = true;
+    *out_len = BEAM_TELEMETRY_KEYFRAME_SIZE;
+    *out_flags = MSG_FLAG_COMPACT;
+
+    return ESP_OK;
+}
+
+esp_err_t beam_telemetry_decoder_init(beam_telemetry_decoder_t *decoder)
+{
+    TELEMETRY_RETURN_ON_FALSE(decoder != NULL, "decoder pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    memset(decoder, 0, sizeof(*decoder));
+
+    return ESP_OK;
+}
+
+esp_err_t beam_telemetry_decode(beam_telemetry_decoder_t *decoder,
+                                const beam_frame_view_t *view,
+                                beam_payload_telemetry_t *out_telemetry)
+{
+    TELEMETRY_RETURN_ON_FALSE(decoder != NULL, "decoder pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(view != NULL, "view pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(out_telemetry != NULL, "out_telemetry pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(beam_frame_view_category(view) == MSG_CAT_TELEMETRY,
+                              "frame is not MSG_CAT_TELEMETRY",
+                              ESP_ERR_INVALID_ARG);
+
+    return beam_telemetry_decode_payload(decoder,
+                                         beam_frame_view_flags(view),
+                                         beam_frame_view_payload(view),
+                                         beam_frame_view_payload_len(view),
+                                         out_telemetry);
+}
+
+esp_err_t beam_telemetry_decode_payload(beam_telemetry_decoder_t *decoder,
+                                        beam_flags_t flags,
+                                        const uint8_t *payload,
+                                        uint8_t len,
+                                        beam_payload_telemetry_t *out_telemetry)
+{
+    TELEMETRY_RETURN_ON_FALSE(decoder != NULL, "decoder pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(payload != NULL, "payload pointer is NULL", ESP_ERR_INVALID_ARG);
+    TELEMETRY_RETURN_ON_FALSE(out_telemetry != NULL, "out_telemetry pointer is NULL", ESP_ERR_INVALID_ARG);
+
+    // Payload errors are not logged: the parse path runs this for every received frame
+    if (!(flags & MSG_FLAG_COMPACT)) {
+        if (len < sizeof(*out_telemetry)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(out_telemetry, payload, sizeof(*out_telemetry));
+        return ESP_OK;
+    }
+
+    if (!(flags & MSG_FLAG_DELTA)) {
+        if (len != BEAM_TELEMETRY_KEYFRAME_SIZE) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        read_keyframe(payload, decoder->key);
+        decoder->key_id = payload[0];
+        decoder->has_key = true;
+        to_telemetry(decoder->key, out_telemetry);
+        return ESP_OK;
+    }
+
+    if (len != BEAM_TELEMETRY_DELTA_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (!decoder->has_key || decoder->key_id != payload[0]) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    int16_t q[AXIS_COUNT];
+    for (int i = 0; i < AXIS_COUNT; i++) {
+        q[i] = (int16_t)(decoder->key[i] + (int8_t)payload[1 + i]);
+    }
+    to_telemetry(q, out_telemetry);
+
+    return ESP_OK;
+}
+
+void beam_telemetry_from_keyframe(const uint8_t *payload, beam_payload_telemetry_t *out_telemetry)
+{
+    int16_t q[AXIS_COUNT];
+
+    read_keyframe(payload, q);
+    to_telemetry(q, out_telemetry);
+}